@@ -0,0 +1,194 @@
+/*****************************************************************************
+ *                                                                           *
+ * \file agg.h                                                               *
+ *                                                                           *
+ * \brief Incremental windowed aggregation of sample channels.               *
+ *                                                                           *
+ * A channel follows one value of one sample source and emits, once per     *
+ * hop, the mean, min, max and standard deviation of the last window. It    *
+ * is a tumbling window when window == hop, a sliding one otherwise.         *
+ *                                                                           *
+ * Each sample costs O(1): it only updates the current pane (one hop's       *
+ * worth) with Welford's mean/variance and a min/max. When the pane closes   *
+ * it is merged into the window statistics and the pane leaving the window   *
+ * is unmerged (Chan's parallel formulas), while min and max come from       *
+ * monotonic deques over the panes' own min and max. No sample is kept, so   *
+ * memory is per pane, not per sample. The float window statistics are       *
+ * rebuilt from the panes once per window length, so rounding errors of the  *
+ * unmerges do not pile up.                                                  *
+ *                                                                           *
+ * Aggregates are emitted as samples of their own source, with values       *
+ * { mean, min, max, stddev } and the window's end as timestamp, so they     *
+ * travel the same way as raw samples. A channel may keep its source's raw  *
+ * samples local, so only the aggregates are uplinked.                       *
+ *                                                                           *
+ * \author blackchacal <ribeiro.tonet@gmail.com>                             *
+ * \date Oct 17, 2026                                                        *
+ *                                                                           *
+ * \version 1.0 | \author blackchacal                                        *
+ * File creation.                                                            *
+ *                                                                           *
+ *****************************************************************************/
+
+#ifndef _AGG_H
+#define _AGG_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*****************************************************************************
+ * Includes                                                                  *
+ *****************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "suricata_config.h"
+#include "sampler.h"
+
+/*****************************************************************************
+ * Configuration Macros                                                      *
+ *****************************************************************************/
+
+/**
+ * @def AGG_MAX_PANES
+ * Hops a window may span.
+ */
+#ifndef AGG_MAX_PANES
+#define AGG_MAX_PANES           6
+#endif
+
+/**
+ * @def AGG_WINDOW_US
+ * Window of the aggregates set up in main.
+ */
+#ifndef AGG_WINDOW_US
+#define AGG_WINDOW_US           60000000UL
+#endif
+
+/**
+ * @def AGG_HOP_US
+ * Hop of the sliding aggregates set up in main.
+ */
+#ifndef AGG_HOP_US
+#define AGG_HOP_US              10000000UL
+#endif
+
+/*****************************************************************************
+ * Macros                                                                    *
+ *****************************************************************************/
+
+/* --- Error codes ----------------------------------------------------------*/
+
+#ifndef ERR_OK
+#define ERR_OK                          (0)
+#endif
+#define ERR_AGG_NULL_POINTER            (-110)
+#define ERR_AGG_INVALID_WINDOW          (-111)
+#define ERR_AGG_INVALID_CHANNEL         (-112)
+
+/* --- Aggregate sample -----------------------------------------------------*/
+
+#define AGG_VALUE_MEAN                  (0)
+#define AGG_VALUE_MIN                   (1)
+#define AGG_VALUE_MAX                   (2)
+#define AGG_VALUE_STDDEV                (3)
+#define AGG_VALUES                      (4)
+
+#if SAMPLER_MAX_VALUES < AGG_VALUES
+#error "aggregate samples carry 4 values, SAMPLER_MAX_VALUES must be >= 4"
+#endif
+
+/*****************************************************************************
+ * Datatypes                                                                 *
+ *****************************************************************************/
+
+/**
+ * \struct agg_stat_t
+ * Welford state of a pane or window, and the pane's min and max.
+ */
+typedef struct
+{
+    uint32_t n;
+    float mean;
+    float m2;                   /* Sum of squared differences from mean. */
+    int32_t min;
+    int32_t max;
+} agg_stat_t;
+
+/**
+ * \struct agg_t
+ * One aggregation channel. Allocated by the caller, set up with agg_add.
+ */
+typedef struct agg_s
+{
+    uint8_t src;
+    uint8_t index;              /* Value of the sample followed. */
+    uint8_t out_src;
+    uint8_t panes;              /* window / hop. */
+    bool keep_raw;
+    bool started;
+    uint32_t hop_us;
+    uint32_t pane_end;          /* Timestamp closing the current pane. */
+    uint32_t closed;            /* Panes closed so far. */
+    agg_stat_t cur;
+    agg_stat_t win;             /* Closed panes in the window. */
+    agg_stat_t pane[AGG_MAX_PANES];
+    uint32_t min_q[AGG_MAX_PANES];
+    uint32_t max_q[AGG_MAX_PANES];
+    uint8_t min_head;
+    uint8_t min_len;
+    uint8_t max_head;
+    uint8_t max_len;
+    struct agg_s * next;
+} agg_t;
+
+/**
+ * @brief Receives each aggregate sample. Its seq is left to the receiver.
+ */
+typedef void (*agg_emit_t) (const sampler_sample_t * sample);
+
+/*****************************************************************************
+ * Public Functions                                                          *
+ *****************************************************************************/
+
+/**
+ * @brief Drops all channels and sets where aggregates go.
+ *
+ * @param emit
+ */
+void agg_init (agg_emit_t emit);
+
+/**
+ * @brief Adds a channel.
+ *
+ * @param agg
+ * @param src Source followed.
+ * @param index Value followed, below SAMPLER_MAX_VALUES.
+ * @param out_src Source of the aggregate samples.
+ * @param window_us A multiple of hop_us, at most AGG_MAX_PANES hops.
+ * @param hop_us Time between aggregates.
+ * @param keep_raw false to keep src's raw samples local (see agg_feed).
+ * @return int
+ */
+int agg_add (agg_t * agg, uint8_t src, uint8_t index, uint8_t out_src,
+             uint32_t window_us, uint32_t hop_us, bool keep_raw);
+
+/**
+ * @brief Feeds one sample to the channels following its source. Windows
+ * that end before the sample are emitted first.
+ *
+ * @param sample
+ * @return true to pass the raw sample on, false if a channel keeps its
+ * source local.
+ */
+bool agg_feed (const sampler_sample_t * sample);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _AGG_H */
+
+/* end of file */
@@ -0,0 +1,70 @@
+/*****************************************************************************
+ *                                                                           *
+ * \file bench.h                                                             *
+ *                                                                           *
+ * \brief Micro-benchmarks of the ring buffer and logger hot paths.          *
+ *                                                                           *
+ * Each case runs BENCH_SAMPLES times and reports min, p50, p90, p99 and     *
+ * max over Serial, one line per case. On the board the unit is CPU cycles,  *
+ * read from SysTick; on the host (env:native_bench) it is nanoseconds from  *
+ * CLOCK_MONOTONIC. The fixed cost of reading the clock is subtracted.       *
+ *                                                                           *
+ * Build with the nano_33_iot_bench or native_bench environments, which set  *
+ * BENCH_EN to 1. Save a run as the baseline before changing these modules.  *
+ *                                                                           *
+ * \author blackchacal <ribeiro.tonet@gmail.com>                             *
+ * \date Oct 17, 2026                                                        *
+ *                                                                           *
+ * \version 1.0 | \author blackchacal                                        *
+ * File creation.                                                            *
+ *                                                                           *
+ *****************************************************************************/
+
+#ifndef _BENCH_H
+#define _BENCH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*****************************************************************************
+ * Includes                                                                  *
+ *****************************************************************************/
+
+#include <stdint.h>
+
+#include "suricata_config.h"
+
+/*****************************************************************************
+ * Configuration Macros                                                      *
+ *****************************************************************************/
+
+#ifndef BENCH_EN
+#define BENCH_EN 0
+#endif
+
+/**
+ * @def BENCH_SAMPLES
+ * Timed runs per case.
+ */
+#ifndef BENCH_SAMPLES
+#define BENCH_SAMPLES 256
+#endif
+
+/*****************************************************************************
+ * Public Functions                                                          *
+ *****************************************************************************/
+
+/**
+ * @brief Runs every benchmark and reports the results over Serial. Pending
+ * log output is flushed first. Does nothing if BENCH_EN is 0.
+ */
+void bench_run (void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _BENCH_H */
+
+/* end of file */
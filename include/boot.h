@@ -0,0 +1,99 @@
+/*****************************************************************************
+ *                                                                           *
+ * \file boot.h                                                              *
+ *                                                                           *
+ * \brief Staged boot sequence with per-stage timing.                        *
+ *                                                                           *
+ * setup() runs its init steps as named stages through boot_stage, which     *
+ * times each with micros() and keeps its result for boot_report. Nothing   *
+ * waits for a serial host: log lines wait in the serial sink's queue until  *
+ * a host opens the port (see log_sink.h), so sampling starts right away     *
+ * and the boot log is still seen by a host that attaches late.              *
+ * LOG_BUFFER_SIZE must hold the whole boot log for that.                    *
+ *                                                                           *
+ * \author blackchacal <ribeiro.tonet@gmail.com>                             *
+ * \date Oct 17, 2026                                                        *
+ *                                                                           *
+ * \version 1.0 | \author blackchacal                                        *
+ * File creation.                                                            *
+ *                                                                           *
+ *****************************************************************************/
+
+#ifndef _BOOT_H
+#define _BOOT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*****************************************************************************
+ * Includes                                                                  *
+ *****************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "suricata_config.h"
+
+/*****************************************************************************
+ * Configuration Macros                                                      *
+ *****************************************************************************/
+
+/**
+ * @def BOOT_SERIAL_WAIT_MS
+ * Only without LOG_DEFERRED_EN, where there is no queue to hold lines:
+ * setup() blocks for up to this long after reset for a serial host. 0 in
+ * headless builds.
+ */
+#ifndef BOOT_SERIAL_WAIT_MS
+#define BOOT_SERIAL_WAIT_MS     3000UL
+#endif
+
+/**
+ * @def BOOT_MAX_STAGES
+ * Stages boot_report keeps. Later ones still run, untimed.
+ */
+#ifndef BOOT_MAX_STAGES
+#define BOOT_MAX_STAGES         10
+#endif
+
+/*****************************************************************************
+ * Datatypes                                                                 *
+ *****************************************************************************/
+
+/**
+ * @brief One init step. Returns ERR_OK or the error of the step.
+ */
+typedef int (*boot_stage_fn_t) (void);
+
+/*****************************************************************************
+ * Public Functions                                                          *
+ *****************************************************************************/
+
+/**
+ * @brief Runs and times one stage.
+ *
+ * @param name Shown in the report, must stay valid (a literal).
+ * @param fn
+ * @return int What fn returned.
+ */
+int boot_stage (const char * name, boot_stage_fn_t fn);
+
+/**
+ * @brief Does not block: true once a serial host is attached or
+ * BOOT_SERIAL_WAIT_MS after reset, and from then on.
+ */
+bool boot_serial_ready (void);
+
+/**
+ * @brief Logs the time each stage took and when setup() was done.
+ */
+void boot_report (void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _BOOT_H */
+
+/* end of file */
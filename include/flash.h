@@ -0,0 +1,146 @@
+/*****************************************************************************
+ *                                                                           *
+ * \file flash.h                                                             *
+ *                                                                           *
+ * \brief Raw access to the flash region reserved for data storage.          *
+ *                                                                           *
+ * The region is the last FLASH_STORE_SIZE bytes of the SAMD21 internal      *
+ * flash, programmed through the NVM controller. Natively it is simulated    *
+ * in a file, with the same rules as the real part:                          *
+ *   - writes are whole FLASH_WRITE_SIZE pages, page aligned, and only into  *
+ *     erased pages (all 0xFF);                                              *
+ *   - erases are whole FLASH_ERASE_SIZE rows, row aligned.                  *
+ * Addresses are offsets into the region. Another part (e.g. a SPI NOR       *
+ * chip) only needs a new implementation of these four functions.            *
+ *                                                                           *
+ * Writing or erasing stalls the CPU, interrupts included, while the flash   *
+ * is busy: a few ms per page or row on the SAMD21.                          *
+ *                                                                           *
+ * \author blackchacal <ribeiro.tonet@gmail.com>                             *
+ * \date Oct 17, 2026                                                        *
+ *                                                                           *
+ * \version 1.0 | \author blackchacal                                        *
+ * File creation.                                                            *
+ *                                                                           *
+ *****************************************************************************/
+
+#ifndef _FLASH_H
+#define _FLASH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*****************************************************************************
+ * Includes                                                                  *
+ *****************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "suricata_config.h"
+
+/*****************************************************************************
+ * Configuration Macros                                                      *
+ *****************************************************************************/
+
+/**
+ * @def FLASH_STORE_SIZE
+ * Size of the region, a multiple of FLASH_ERASE_SIZE. It must not reach
+ * into the firmware image; flash_init checks it on the board.
+ */
+#ifndef FLASH_STORE_SIZE
+#define FLASH_STORE_SIZE        32768UL
+#endif
+
+/**
+ * @def FLASH_SIM_FILE
+ * File holding the simulated flash on native builds.
+ */
+#ifndef FLASH_SIM_FILE
+#define FLASH_SIM_FILE          "suricata_flash.bin"
+#endif
+
+/*****************************************************************************
+ * Macros                                                                    *
+ *****************************************************************************/
+
+/* --- Error codes ----------------------------------------------------------*/
+
+#ifndef ERR_OK
+#define ERR_OK                          (0)
+#endif
+#define ERR_FLASH_NULL_POINTER          (-90)
+#define ERR_FLASH_ALIGN                 (-91)
+#define ERR_FLASH_RANGE                 (-92)
+#define ERR_FLASH_NOT_ERASED            (-93)
+#define ERR_FLASH_IO                    (-94)
+
+/* --- Geometry -------------------------------------------------------------*/
+
+#define FLASH_WRITE_SIZE                (64)
+#define FLASH_ERASE_SIZE                (256)
+
+#if (FLASH_STORE_SIZE % FLASH_ERASE_SIZE) != 0
+#error "FLASH_STORE_SIZE must be a multiple of FLASH_ERASE_SIZE"
+#endif
+
+/*****************************************************************************
+ * Public Functions                                                          *
+ *****************************************************************************/
+
+/**
+ * @brief Prepares the region. Natively opens (or creates, erased) the
+ * simulation file.
+ *
+ * @return int ERR_OK, or ERR_FLASH_RANGE if the region overlaps the
+ * firmware.
+ */
+int flash_init (void);
+
+/**
+ * @brief Reads any span of the region.
+ *
+ * @param addr
+ * @param data
+ * @param len
+ * @return int
+ */
+int flash_read (uint32_t addr, uint8_t * data, uint16_t len);
+
+/**
+ * @brief Programs one erased page.
+ *
+ * @param addr Multiple of FLASH_WRITE_SIZE.
+ * @param data FLASH_WRITE_SIZE bytes.
+ * @return int
+ */
+int flash_write (uint32_t addr, const uint8_t * data);
+
+/**
+ * @brief Erases one row to 0xFF.
+ *
+ * @param addr Multiple of FLASH_ERASE_SIZE.
+ * @return int
+ */
+int flash_erase (uint32_t addr);
+
+#if defined(SURICATA_NATIVE)
+/**
+ * @brief Simulates a power cut: after ops more writes or erases, the next
+ * one is torn (half the page programmed, or half the row erased) and
+ * every later operation fails with ERR_FLASH_IO, until flash_init.
+ * 0 cancels.
+ *
+ * @param ops
+ */
+void flash_sim_cut (uint32_t ops);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _FLASH_H */
+
+/* end of file */
@@ -0,0 +1,165 @@
+/*****************************************************************************
+ *                                                                           *
+ * \file i2c_bus.h                                                           *
+ *                                                                           *
+ * \brief Non-blocking I2C master with a transfer queue.                     *
+ *                                                                           *
+ * Callers submit i2c_xfer_t descriptors and return; the bus runs them one   *
+ * at a time in submission order, so several drivers share it without        *
+ * waiting on each other. Each transfer is an optional write followed by an  *
+ * optional read, with a repeated start in between. Completion is reported   *
+ * in the descriptor's result field, which a driver polls from its state     *
+ * machine.                                                                  *
+ *                                                                           *
+ * On the SAMD21 the transfer is moved byte by byte by the SERCOM interrupt  *
+ * on the board's Wire pins; nothing waits for the bus. Natively a mock bus  *
+ * replays recorded device responses, and i2c_bus_poll completes transfers  *
+ * once their simulated bus time has passed.                                 *
+ *                                                                           *
+ * \author blackchacal <ribeiro.tonet@gmail.com>                             *
+ * \date Oct 17, 2026                                                        *
+ *                                                                           *
+ * \version 1.0 | \author blackchacal                                        *
+ * File creation.                                                            *
+ *                                                                           *
+ *****************************************************************************/
+
+#ifndef _I2C_BUS_H
+#define _I2C_BUS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*****************************************************************************
+ * Includes                                                                  *
+ *****************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "suricata_config.h"
+
+/*****************************************************************************
+ * Configuration Macros                                                      *
+ *****************************************************************************/
+
+/**
+ * @def I2C_BUS_CLOCK_HZ
+ * SCL frequency.
+ */
+#ifndef I2C_BUS_CLOCK_HZ
+#define I2C_BUS_CLOCK_HZ        100000UL
+#endif
+
+/**
+ * @def I2C_MOCK_DEVICES
+ * Devices the native mock bus can hold.
+ */
+#ifndef I2C_MOCK_DEVICES
+#define I2C_MOCK_DEVICES        4
+#endif
+
+/*****************************************************************************
+ * Macros                                                                    *
+ *****************************************************************************/
+
+/* --- Error codes ----------------------------------------------------------*/
+
+#ifndef ERR_OK
+#define ERR_OK                          (0)
+#endif
+#define ERR_I2C_NULL_POINTER            (-50)
+#define ERR_I2C_BUSY                    (-51)
+#define ERR_I2C_NACK                    (-52)
+#define ERR_I2C_BUS                     (-53)
+#define ERR_I2C_NOT_INIT                (-54)
+
+/* --- Transfer result ------------------------------------------------------*/
+
+#define I2C_XFER_PENDING                (1)
+
+/*****************************************************************************
+ * Datatypes                                                                 *
+ *****************************************************************************/
+
+/**
+ * \struct i2c_xfer_t
+ * One transfer. The descriptor and its buffers belong to the bus from
+ * i2c_submit until result leaves I2C_XFER_PENDING.
+ */
+typedef struct i2c_xfer_s
+{
+    uint8_t addr;               /* 7 bit address. */
+    const uint8_t * tx;
+    uint8_t tx_len;
+    uint8_t * rx;
+    uint8_t rx_len;
+    volatile int8_t result;     /* I2C_XFER_PENDING, ERR_OK or ERR_I2C_*. */
+    struct i2c_xfer_s * next;
+} i2c_xfer_t;
+
+#if defined(SURICATA_NATIVE)
+/**
+ * \struct i2c_mock_step_t
+ * One recorded transaction of a mock device: the bytes written and the
+ * bytes it answered with. A transfer that does not match the next step is
+ * NACKed.
+ */
+typedef struct
+{
+    const uint8_t * tx;
+    uint8_t tx_len;
+    const uint8_t * rx;
+    uint8_t rx_len;
+} i2c_mock_step_t;
+#endif
+
+/*****************************************************************************
+ * Public Functions                                                          *
+ *****************************************************************************/
+
+/**
+ * @brief Sets up the bus as master and its interrupt.
+ *
+ * @param clock_hz SCL frequency.
+ * @return int
+ */
+int i2c_bus_init (uint32_t clock_hz);
+
+/**
+ * @brief Queues a transfer and returns at once. Safe against the bus
+ * interrupt.
+ *
+ * @param xfer
+ * @return int ERR_OK, ERR_I2C_NULL_POINTER, ERR_I2C_NOT_INIT or
+ * ERR_I2C_BUSY if xfer is still pending.
+ */
+int i2c_submit (i2c_xfer_t * xfer);
+
+/**
+ * @brief Moves the bus forward where no interrupt does it: completes the
+ * mock transfers whose bus time is over. Does nothing on the board.
+ */
+void i2c_bus_poll (void);
+
+#if defined(SURICATA_NATIVE)
+/**
+ * @brief Attaches a mock device replaying steps in order, from the first
+ * again after the last. Addresses without a device NACK.
+ *
+ * @param addr
+ * @param steps Must stay valid.
+ * @param count
+ * @return int
+ */
+int i2c_mock_device (uint8_t addr, const i2c_mock_step_t * steps, uint8_t count);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _I2C_BUS_H */
+
+/* end of file */
@@ -0,0 +1,218 @@
+/*****************************************************************************
+ *                                                                           *
+ * \file log_bin.h                                                           *
+ *                                                                           *
+ * \brief Tokenized binary log encoder.                                      *
+ *                                                                           *
+ * Each LOG_* call site's tag and format string are hashed at compile time   *
+ * into a 32 bit token, so the strings never reach flash. The device only    *
+ * emits the level, the token, a timestamp and the raw arguments; the host   *
+ * tool tools/log_tokens.py rebuilds the text from a generated string table. *
+ *                                                                           *
+ * Frame layout:                                                             *
+ *   SYNC | LEN | level | token (4, LE) | millis (varint) | args... | SUM     *
+ * LEN counts the bytes between itself and SUM, SUM is their 8 bit sum.      *
+ * Integers are zig-zag varints of their value widened to 64 bit, floating   *
+ * point is a 4 byte float, strings are a length byte plus the characters.   *
+ * Bit 7 of level flags a frame whose arguments were truncated.              *
+ *                                                                           *
+ * \author blackchacal <ribeiro.tonet@gmail.com>                             *
+ * \date Oct 17, 2026                                                        *
+ *                                                                           *
+ * \version 1.0 | \author blackchacal                                        *
+ * File creation.                                                            *
+ *                                                                           *
+ *****************************************************************************/
+
+#ifndef _LOG_BIN_H
+#define _LOG_BIN_H
+
+/*****************************************************************************
+ * Includes                                                                  *
+ *****************************************************************************/
+
+/* --- Standard libraries -------------------- */
+#include <stdint.h>
+#include <string.h>
+#include <type_traits>
+
+/* --- Arduino libraries -------------------- */
+#include <Arduino.h>
+
+/* --- Custom modules -------------------- */
+#include "log_hash.h"
+
+/*****************************************************************************
+ * Configuration Macros                                                      *
+ *****************************************************************************/
+
+#ifndef LOG_BIN_MAX_FRAME
+#define LOG_BIN_MAX_FRAME   64
+#endif
+
+/*****************************************************************************
+ * Macros                                                                    *
+ *****************************************************************************/
+
+#define LOG_BIN_SYNC        (0xA5)
+#define LOG_BIN_TRUNCATED   (0x80)
+
+/**
+ * @def LOG_BIN_WRITE
+ * Emits one binary log frame. tag and fmt must be string literals.
+ */
+#define LOG_BIN_WRITE(type, tag, fmt, ...) \
+    log_bin::write((type), log_hash_const<log_bin::token(tag, fmt)>::value, ##__VA_ARGS__)
+
+/*****************************************************************************
+ * Public Functions                                                          *
+ *****************************************************************************/
+
+/**
+ * @brief Sends one finished frame to the log output. Defined by logger.cpp.
+ */
+extern "C" void log_bin_emit (const uint8_t * frame, uint16_t len);
+
+/*****************************************************************************
+ * Encoder                                                                   *
+ *****************************************************************************/
+
+namespace log_bin
+{
+
+/**
+ * @brief Token of a call site: FNV-1a over tag, a 0x1F separator and fmt.
+ * tools/log_tokens.py computes the same value.
+ */
+constexpr uint32_t token (const char * tag, const char * fmt)
+{
+    return log_hash(fmt, (uint32_t)((log_hash(tag) ^ 0x1FU) * LOG_HASH_PRIME));
+}
+
+class Encoder
+{
+public:
+    Encoder (uint8_t type, uint32_t id, uint32_t ts) : len_(2), type_(type)
+    {
+        byte(type);
+        byte((uint8_t)(id));
+        byte((uint8_t)(id >> 8));
+        byte((uint8_t)(id >> 16));
+        byte((uint8_t)(id >> 24));
+        varint(ts);
+    }
+
+    template <typename T>
+    typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value>::type
+    put (T v)
+    {
+        int64_t s = (int64_t)v;
+        varint(((uint64_t)s << 1) ^ (uint64_t)(s >> 63));
+    }
+
+    template <typename T>
+    typename std::enable_if<std::is_floating_point<T>::value>::type
+    put (T v)
+    {
+        float f = (float)v;
+        uint8_t raw[sizeof(f)];
+        memcpy(raw, &f, sizeof(f));
+        for (uint8_t i = 0; i < sizeof(f); i++)
+        {
+            byte(raw[i]);
+        }
+    }
+
+    void put (const char * s)
+    {
+        size_t n = (s == NULL) ? 0 : strlen(s);
+        uint16_t room = (len_ < LOG_BIN_MAX_FRAME - 2) ? (LOG_BIN_MAX_FRAME - 2 - len_) : 0;
+
+        if (n > 255)
+        {
+            n = 255;
+        }
+        if ((room > 0) && (n > (size_t)(room - 1)))
+        {
+            n = room - 1;
+            type_ |= LOG_BIN_TRUNCATED;
+        }
+        byte((uint8_t)n);
+        for (size_t i = 0; i < n; i++)
+        {
+            byte((uint8_t)s[i]);
+        }
+    }
+
+    void put (char * s)
+    {
+        put((const char *)s);
+    }
+
+    template <typename T>
+    void put (const T * p)
+    {
+        put((uintptr_t)p);
+    }
+
+    /**
+     * @brief Closes the frame and sends it.
+     */
+    void emit (void)
+    {
+        uint8_t sum = 0;
+
+        buf_[0] = LOG_BIN_SYNC;
+        buf_[2] = type_;
+        buf_[1] = (uint8_t)(len_ - 2);
+        for (uint16_t i = 2; i < len_; i++)
+        {
+            sum += buf_[i];
+        }
+        buf_[len_++] = sum;
+        log_bin_emit(buf_, len_);
+    }
+
+private:
+    void byte (uint8_t b)
+    {
+        /* Last byte is kept for the checksum. */
+        if (len_ < (LOG_BIN_MAX_FRAME - 1))
+        {
+            buf_[len_++] = b;
+        }
+        else
+        {
+            type_ |= LOG_BIN_TRUNCATED;
+        }
+    }
+
+    void varint (uint64_t v)
+    {
+        while (v >= 0x80)
+        {
+            byte((uint8_t)(v | 0x80));
+            v >>= 7;
+        }
+        byte((uint8_t)v);
+    }
+
+    uint8_t buf_[LOG_BIN_MAX_FRAME];
+    uint16_t len_;
+    uint8_t type_;
+};
+
+template <typename... Args>
+void write (uint8_t type, uint32_t id, Args... args)
+{
+    Encoder enc(type, id, millis());
+    int unpack[] = { 0, (enc.put(args), 0)... };
+    (void)unpack;
+    enc.emit();
+}
+
+} /* namespace log_bin */
+
+#endif /* _LOG_BIN_H */
+
+/* end of file */
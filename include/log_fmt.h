@@ -0,0 +1,149 @@
+/*****************************************************************************
+ *                                                                           *
+ * \file log_fmt.h                                                           *
+ *                                                                           *
+ * \brief Small printf-style formatter used by the logger.                   *
+ *                                                                           *
+ * Replaces the newlib printf family for log lines: it appends to a bounded  *
+ * buffer in a single pass and never allocates. Supported conversions:       *
+ *   %d %i %u %x %X %c %s %%                                                 *
+ *   %k  fixed-point decimal: a 32 bit integer scaled by 10^precision, so    *
+ *       ("%.2k", 2315) prints 23.15. Meant for sensor values.               *
+ * Flags '-', '0' and '+', a field width, a precision and the length         *
+ * modifiers 'l' and 'll' are accepted, with printf's meaning; on %k the     *
+ * precision places the point. Anything else is copied out as is.            *
+ *                                                                           *
+ * Arguments come through a reader, so the same formatter serves a va_list   *
+ * and arguments captured earlier as raw 32 bit words (see log_isr.h).       *
+ *                                                                           *
+ * \author blackchacal <ribeiro.tonet@gmail.com>                             *
+ * \date Oct 17, 2026                                                        *
+ *                                                                           *
+ * \version 1.0 | \author blackchacal                                        *
+ * File creation.                                                            *
+ *                                                                           *
+ *****************************************************************************/
+
+#ifndef _LOG_FMT_H
+#define _LOG_FMT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*****************************************************************************
+ * Includes                                                                  *
+ *****************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdarg.h>
+
+/*****************************************************************************
+ * Macros                                                                    *
+ *****************************************************************************/
+
+/* --- Argument kinds -------------------------------------------------------*/
+
+#define LOG_FMT_ARG_NONE    (0)
+#define LOG_FMT_ARG_INT     (1)
+#define LOG_FMT_ARG_UINT    (2)
+#define LOG_FMT_ARG_LONG    (3)
+#define LOG_FMT_ARG_ULONG   (4)
+#define LOG_FMT_ARG_LLONG   (5)
+#define LOG_FMT_ARG_ULLONG  (6)
+#define LOG_FMT_ARG_PTR     (7)
+
+/*****************************************************************************
+ * Datatypes                                                                 *
+ *****************************************************************************/
+
+/**
+ * \struct log_fmt_t
+ * Output buffer being filled. Characters past size are dropped and the
+ * output is flagged as truncated.
+ */
+typedef struct
+{
+    char * buf;
+    uint16_t size;
+    uint16_t len;
+    bool truncated;
+} log_fmt_t;
+
+/**
+ * \struct log_fmt_args_t
+ * Argument reader. read returns the next argument of the given kind,
+ * sign extended for the signed kinds.
+ */
+typedef struct log_fmt_args_s log_fmt_args_t;
+struct log_fmt_args_s
+{
+    uint64_t (*read) (log_fmt_args_t * args, uint8_t kind);
+};
+
+/**
+ * \struct log_fmt_raw_args_t
+ * Argument reader over words stored by log_fmt_capture.
+ */
+typedef struct
+{
+    log_fmt_args_t base;
+    const uint32_t * argv;
+    uint8_t argc;
+    uint8_t pos;
+} log_fmt_raw_args_t;
+
+/**
+ * @brief Visitor for log_fmt_walk: one argument and its conversion.
+ */
+typedef void (*log_fmt_visit_t) (void * ctx, char conv, uint64_t value);
+
+/*****************************************************************************
+ * Public Functions                                                          *
+ *****************************************************************************/
+
+/**
+ * @brief Starts an empty output over buf. No NUL terminator is written.
+ */
+void log_fmt_init (log_fmt_t * out, char * buf, uint16_t size);
+
+void log_fmt_putc (log_fmt_t * out, char c);
+
+void log_fmt_puts (log_fmt_t * out, const char * s);
+
+/**
+ * @brief Appends fmt, expanded with arguments from args, to the output.
+ */
+void log_fmt_format (log_fmt_t * out, const char * fmt, log_fmt_args_t * args);
+
+void log_fmt_vprintf (log_fmt_t * out, const char * fmt, va_list vargs);
+
+void log_fmt_printf (log_fmt_t * out, const char * fmt, ...);
+
+/**
+ * @brief Reads the arguments fmt asks for into argv as raw 32 bit words,
+ * without formatting anything. Strings are kept as pointers. Stops at the
+ * first argument that does not fit. Returns the number of words stored.
+ */
+uint8_t log_fmt_capture (const char * fmt, va_list vargs, uint32_t * argv, uint8_t max);
+
+/**
+ * @brief Reads the arguments fmt asks for and hands each to fn, in order,
+ * with its conversion character, without formatting anything. Signed
+ * conversions are sign extended, strings are kept as pointers.
+ */
+void log_fmt_walk (const char * fmt, va_list vargs, log_fmt_visit_t fn, void * ctx);
+
+/**
+ * @brief Prepares a reader over words stored by log_fmt_capture.
+ */
+void log_fmt_raw_init (log_fmt_raw_args_t * args, const uint32_t * argv, uint8_t argc);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _LOG_FMT_H */
+
+/* end of file */
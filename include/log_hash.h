@@ -0,0 +1,82 @@
+/*****************************************************************************
+ *                                                                           *
+ * \file log_hash.h                                                          *
+ *                                                                           *
+ * \brief FNV-1a string hash shared by the logger tag table and the binary   *
+ * log tokens.                                                               *
+ *                                                                           *
+ * In C++ the hash of a string literal is folded at compile time. C callers  *
+ * fall back to hashing at run time.                                         *
+ *                                                                           *
+ * \author blackchacal <ribeiro.tonet@gmail.com>                             *
+ * \date Oct 17, 2026                                                        *
+ *                                                                           *
+ * \version 1.0 | \author blackchacal                                        *
+ * File creation.                                                            *
+ *                                                                           *
+ *****************************************************************************/
+
+#ifndef _LOG_HASH_H
+#define _LOG_HASH_H
+
+/*****************************************************************************
+ * Includes                                                                  *
+ *****************************************************************************/
+
+#include <stdint.h>
+
+/*****************************************************************************
+ * Macros                                                                    *
+ *****************************************************************************/
+
+#define LOG_HASH_SEED       (2166136261UL)
+#define LOG_HASH_PRIME      (16777619UL)
+
+/*****************************************************************************
+ * Public Functions                                                          *
+ *****************************************************************************/
+
+#ifdef __cplusplus
+
+/**
+ * @brief FNV-1a over a NUL terminated string, usable at compile time.
+ */
+constexpr uint32_t log_hash (const char * s, uint32_t h = LOG_HASH_SEED)
+{
+    return (*s == '\0') ? h : log_hash(s + 1, (uint32_t)((h ^ (uint8_t)*s) * LOG_HASH_PRIME));
+}
+
+/**
+ * \struct log_hash_const
+ * Forces a hash to be folded at compile time.
+ */
+template <uint32_t H>
+struct log_hash_const
+{
+    static const uint32_t value = H;
+};
+
+/**
+ * @def LOG_TAG_HASH
+ * Hash of a tag string literal, as a compile-time constant.
+ */
+#define LOG_TAG_HASH(tag)   (log_hash_const<log_hash(tag)>::value)
+
+#else
+
+static inline uint32_t log_hash (const char * s, uint32_t h)
+{
+    while (*s != '\0')
+    {
+        h = (h ^ (uint8_t)*s++) * LOG_HASH_PRIME;
+    }
+    return h;
+}
+
+#define LOG_TAG_HASH(tag)   log_hash((tag), LOG_HASH_SEED)
+
+#endif
+
+#endif /* _LOG_HASH_H */
+
+/* end of file */
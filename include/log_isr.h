@@ -0,0 +1,157 @@
+/*****************************************************************************
+ *                                                                           *
+ * \file log_isr.h                                                           *
+ *                                                                           *
+ * \brief Lock-free capture of log lines written from interrupt handlers.    *
+ *                                                                           *
+ * An interrupt handler never formats and never touches Serial or the        *
+ * shared line buffer. It claims a free slot from a small pool, stores the   *
+ * tag and format pointers plus the raw argument words (or, in binary mode,  *
+ * the finished frame) and marks the slot ready. LOG_PROCESS formats ready   *
+ * slots later from thread context, oldest first.                            *
+ *                                                                           *
+ * Claiming a slot is a compare-and-set. The Cortex-M0+ has no exclusive     *
+ * access instructions, so there it runs with PRIMASK set for a few cycles;  *
+ * other targets use the compiler atomics. A slot is numbered once claimed,  *
+ * so the numbers have no gaps and lines come out strictly in that order.    *
+ * Nothing ever waits: when the pool is full the line is counted as dropped. *
+ *                                                                           *
+ * Format strings, tags and %s arguments must outlive the slot, which in     *
+ * practice means string literals.                                           *
+ *                                                                           *
+ * \author blackchacal <ribeiro.tonet@gmail.com>                             *
+ * \date Oct 17, 2026                                                        *
+ *                                                                           *
+ * \version 1.0 | \author blackchacal                                        *
+ * File creation.                                                            *
+ *                                                                           *
+ *****************************************************************************/
+
+#ifndef _LOG_ISR_H
+#define _LOG_ISR_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*****************************************************************************
+ * Includes                                                                  *
+ *****************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdarg.h>
+
+#include "suricata_config.h"
+
+/*****************************************************************************
+ * Configuration Macros                                                      *
+ *****************************************************************************/
+
+/**
+ * @def LOG_ISR_SLOTS
+ * Lines that can wait for LOG_PROCESS at once.
+ */
+#ifndef LOG_ISR_SLOTS
+#define LOG_ISR_SLOTS       8
+#endif
+
+/**
+ * @def LOG_ISR_MAX_ARGS
+ * 32 bit argument words kept per line. 64 bit values take two.
+ */
+#ifndef LOG_ISR_MAX_ARGS
+#define LOG_ISR_MAX_ARGS    6
+#endif
+
+/**
+ * @def LOG_ISR_FRAME_SIZE
+ * Largest binary frame an interrupt handler can queue.
+ */
+#ifndef LOG_ISR_FRAME_SIZE
+#define LOG_ISR_FRAME_SIZE  32
+#endif
+
+/*****************************************************************************
+ * Macros                                                                    *
+ *****************************************************************************/
+
+/* Slot type of a binary frame, text slots carry their log_type_t. */
+#define LOG_ISR_FRAME       (0xFF)
+
+/*****************************************************************************
+ * Datatypes                                                                 *
+ *****************************************************************************/
+
+/**
+ * \struct log_isr_slot_t
+ * One captured line.
+ */
+typedef struct
+{
+    volatile uint8_t state;
+    uint8_t type;
+    uint8_t len;            /* argument words, or frame bytes */
+    uint32_t seq;
+    union
+    {
+        struct
+        {
+            const char * tag;
+            const char * fmt;
+            uint32_t argv[LOG_ISR_MAX_ARGS];
+        } text;
+        uint8_t frame[LOG_ISR_FRAME_SIZE];
+    } u;
+} log_isr_slot_t;
+
+/*****************************************************************************
+ * Public Functions                                                          *
+ *****************************************************************************/
+
+/**
+ * @brief Returns true when called from an interrupt handler: IPSR on ARM,
+ * log_isr_host_hook elsewhere.
+ */
+bool log_isr_active (void);
+
+/**
+ * @brief Host builds only. Returns true while a simulated interrupt runs.
+ * env:native answers from the ArduinoNative timer; other host builds get a
+ * weak default returning false.
+ */
+bool log_isr_host_hook (void);
+
+/**
+ * @brief Captures a text line. Returns false if it was dropped.
+ */
+bool log_isr_vcapture (uint8_t type, const char * tag, const char * fmt, va_list vargs);
+
+/**
+ * @brief Captures a finished binary frame. Returns false if it was dropped.
+ */
+bool log_isr_frame (const uint8_t * frame, uint16_t len);
+
+/**
+ * @brief Returns the oldest captured line, or NULL if there is none or the
+ * oldest is still being written. Thread context only.
+ */
+log_isr_slot_t * log_isr_next (void);
+
+/**
+ * @brief Gives a slot returned by log_isr_next back to the pool.
+ */
+void log_isr_release (log_isr_slot_t * slot);
+
+/**
+ * @brief Returns the number of lines dropped because the pool was full.
+ */
+uint32_t log_isr_dropped (void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _LOG_ISR_H */
+
+/* end of file */
@@ -0,0 +1,259 @@
+/*****************************************************************************
+ *                                                                           *
+ * \file log_sink.h                                                          *
+ *                                                                           *
+ * \brief Pluggable log outputs.                                             *
+ *                                                                           *
+ * The logger hands every finished line (or binary frame) to each sink whose *
+ * level it reaches. With LOG_DEFERRED_EN each sink has its own queue, which *
+ * LOG_PROCESS drains in batches: a sink is written once it holds its batch *
+ * of bytes or its oldest byte has waited max_delay_us, with all it holds as *
+ * up to RBUFFER_MAX_SPANS spans. A sink that cannot keep up only fills and *
+ * drops from its own queue; it never holds back the others. Its drops are   *
+ * reported into that same queue once it takes data again.                  *
+ *                                                                           *
+ * A sink added without a queue, or every sink without LOG_DEFERRED_EN, is   *
+ * written as each line comes; what it refuses is counted as dropped.        *
+ *                                                                           *
+ * Built-in sinks, added by LOG_INIT:                                        *
+ *   serial  always. Written once a host holds the port open; from its       *
+ *           queue only while Serial.availableForWrite() has room.           *
+ *   ram     LOG_RAM_EN. The newest LOG_RAM_SIZE bytes, read with            *
+ *           log_ram_copy, e.g. after a fault.                               *
+ *   udp     LOG_UDP_EN. One datagram per batch, whole lines, to             *
+ *           LOG_UDP_HOST:LOG_UDP_PORT (nc -ul 47001 shows them). On the     *
+ *           board it waits for the network the uplink joins.                *
+ *   file    LOG_FILE_EN, host only. Appends to LOG_FILE_PATH.               *
+ *                                                                           *
+ * \author blackchacal <ribeiro.tonet@gmail.com>                             *
+ * \date Oct 17, 2026                                                        *
+ *                                                                           *
+ * \version 1.0 | \author blackchacal                                        *
+ * File creation.                                                            *
+ *                                                                           *
+ *****************************************************************************/
+
+#ifndef _LOG_SINK_H
+#define _LOG_SINK_H
+
+/* Declares C++ templates, so it stays out of the extern "C" block. */
+#include "logger.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*****************************************************************************
+ * Includes                                                                  *
+ *****************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "suricata_config.h"
+#include "rbuffer.h"
+
+/*****************************************************************************
+ * Configuration Macros                                                      *
+ *****************************************************************************/
+
+/* --- Serial ---------------------------------------------------------------*/
+
+#ifndef LOG_SERIAL_LEVEL
+#define LOG_SERIAL_LEVEL        LOG_LEVEL_DEBUG
+#endif
+
+#ifndef LOG_SERIAL_BATCH
+#define LOG_SERIAL_BATCH        256
+#endif
+
+#ifndef LOG_SERIAL_DELAY_US
+#define LOG_SERIAL_DELAY_US     20000UL
+#endif
+
+/* --- RAM ------------------------------------------------------------------*/
+
+#ifndef LOG_RAM_EN
+#define LOG_RAM_EN              0
+#endif
+
+/**
+ * @def LOG_RAM_SIZE
+ * Bytes of log the RAM sink keeps. Must be a power of two.
+ */
+#ifndef LOG_RAM_SIZE
+#define LOG_RAM_SIZE            1024
+#endif
+
+#ifndef LOG_RAM_LEVEL
+#define LOG_RAM_LEVEL           LOG_LEVEL_WARN
+#endif
+
+/* --- UDP ------------------------------------------------------------------*/
+
+#ifndef LOG_UDP_EN
+#define LOG_UDP_EN              0
+#endif
+
+#ifndef LOG_UDP_HOST
+#define LOG_UDP_HOST            "127.0.0.1"
+#endif
+
+#ifndef LOG_UDP_PORT
+#define LOG_UDP_PORT            47001
+#endif
+
+#ifndef LOG_UDP_LEVEL
+#define LOG_UDP_LEVEL           LOG_LEVEL_INFO
+#endif
+
+/**
+ * @def LOG_UDP_DATAGRAM
+ * Largest datagram. Its queue, LOG_UDP_BUFFER_SIZE (a power of two),
+ * holds what waits while the network is down.
+ */
+#ifndef LOG_UDP_DATAGRAM
+#define LOG_UDP_DATAGRAM        512
+#endif
+
+#ifndef LOG_UDP_BUFFER_SIZE
+#define LOG_UDP_BUFFER_SIZE     1024
+#endif
+
+#ifndef LOG_UDP_DELAY_US
+#define LOG_UDP_DELAY_US        1000000UL
+#endif
+
+/* --- File -----------------------------------------------------------------*/
+
+#ifndef LOG_FILE_EN
+#define LOG_FILE_EN             0
+#endif
+
+#ifndef LOG_FILE_PATH
+#define LOG_FILE_PATH           "suricata.log"
+#endif
+
+#ifndef LOG_FILE_LEVEL
+#define LOG_FILE_LEVEL          LOG_LEVEL_DEBUG
+#endif
+
+#ifndef LOG_FILE_BUFFER_SIZE
+#define LOG_FILE_BUFFER_SIZE    1024
+#endif
+
+/**
+ * @def LOG_FLUSH_TIMEOUT_US
+ * LOG_FLUSH gives up on a sink that takes nothing for this long.
+ */
+#ifndef LOG_FLUSH_TIMEOUT_US
+#define LOG_FLUSH_TIMEOUT_US    100000UL
+#endif
+
+/*****************************************************************************
+ * Macros                                                                    *
+ *****************************************************************************/
+
+/* --- Error codes ----------------------------------------------------------*/
+
+#ifndef ERR_OK
+#define ERR_OK                          (0)
+#endif
+#define ERR_LOG_SINK_NULL_POINTER       (-140)
+
+/*****************************************************************************
+ * Datatypes                                                                 *
+ *****************************************************************************/
+
+typedef struct log_sink_s log_sink_t;
+
+/**
+ * \struct log_sink_driver_t
+ * A sink type. write takes bytes from the front of count spans, in order,
+ * and returns how many it took; it must not block for long. flush may be
+ * NULL. A write is due at batch bytes or after max_delay_us.
+ */
+typedef struct
+{
+    const char * name;
+    uint16_t (*write) (log_sink_t * sink, const rbuffer_span_t * span, uint8_t count);
+    void (*flush) (log_sink_t * sink);
+    uint16_t batch;
+    uint32_t max_delay_us;
+} log_sink_driver_t;
+
+/**
+ * \struct log_sink_t
+ * One sink instance. The driver owns ctx; the logger owns the rest.
+ */
+struct log_sink_s
+{
+    const log_sink_driver_t * drv;
+    void * ctx;
+    uint8_t level;              /* Lowest level written. */
+    uint16_t batch;
+#if LOG_DEFERRED_EN == 1
+    rbuffer_t queue;            /* No buffer: written as lines come. */
+    uint32_t since;             /* When the oldest queued byte came. */
+#endif
+    uint32_t bytes;             /* Written. */
+    uint32_t dropped;           /* Lines refused. */
+    uint32_t reported;          /* Drops reported so far. */
+
+    log_sink_t * next;
+};
+
+/*****************************************************************************
+ * Public Variables                                                          *
+ *****************************************************************************/
+
+extern const log_sink_driver_t log_sink_serial;
+extern const log_sink_driver_t log_sink_ram;        /* ctx: rbuffer_t, overwrite. */
+extern const log_sink_driver_t log_sink_udp;
+#if defined(SURICATA_NATIVE)
+extern const log_sink_driver_t log_sink_file;
+#endif
+
+/*****************************************************************************
+ * Public Functions                                                          *
+ *****************************************************************************/
+
+/**
+ * @brief Adds a sink, or updates it if already added. Sinks are written in
+ * the order they were added.
+ *
+ * @param sink
+ * @param drv
+ * @param ctx Handed to the driver.
+ * @param level Lowest level written to it.
+ * @param buf Its queue, a power of two in size; NULL for none. Unused
+ * without LOG_DEFERRED_EN.
+ * @param size
+ * @return int
+ */
+int log_sink_add (log_sink_t * sink, const log_sink_driver_t * drv, void * ctx,
+                  log_level_t level, uint8_t * buf, uint16_t size);
+
+/**
+ * @brief Adds the built-in sinks enabled in the configuration. Called by
+ * LOG_INIT.
+ */
+void log_sink_builtin (void);
+
+/**
+ * @brief Copies what the built-in RAM sink holds, oldest first, without
+ * removing it.
+ *
+ * @param out
+ * @param len Room in out; the newest bytes are kept if it is short.
+ * @return uint16_t Bytes copied, 0 without LOG_RAM_EN.
+ */
+uint16_t log_ram_copy (uint8_t * out, uint16_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _LOG_SINK_H */
+
+/* end of file */
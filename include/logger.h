@@ -15,6 +15,9 @@
 #ifndef _LOGGER_H
 #define _LOGGER_H
 
+/* Declares C++ templates, so it stays out of the extern "C" block. */
+#include "log_hash.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -23,6 +26,9 @@ extern "C" {
  * Includes                                                                  *
  *****************************************************************************/
 
+#include <stdint.h>
+#include <stdbool.h>
+
 #include "suricata_config.h"
 
 /*****************************************************************************
@@ -49,34 +55,222 @@ extern "C" {
 #define LOG_ERROR_EN 1
 #endif
 
+/**
+ * @def SERIAL_SPEED
+ * Line rate handed to Serial.begin. The SAMD21 port is USB CDC and runs at
+ * USB speed whatever the rate; it only matters on a UART.
+ */
 #ifndef SERIAL_SPEED
-#define SERIAL_SPEED  9600
+#define SERIAL_SPEED  115200
 #endif
 
 #ifndef MAX_LOG_MSG_SIZE
 #define MAX_LOG_MSG_SIZE  512
 #endif
 
+/**
+ * @def LOG_DEFERRED_EN
+ * When 1, LOG_* calls only format into the queue of each sink (see
+ * log_sink.h) and LOG_PROCESS drains the queues without blocking.
+ */
+#ifndef LOG_DEFERRED_EN
+#define LOG_DEFERRED_EN 0
+#endif
+
+/**
+ * @def LOG_BUFFER_SIZE
+ * Size of the serial sink's queue. Must be a power of two.
+ */
+#ifndef LOG_BUFFER_SIZE
+#define LOG_BUFFER_SIZE 1024
+#endif
+
+/**
+ * @def LOG_BINARY_EN
+ * When 1, LOG_* call sites emit tokenized binary frames (see log_bin.h)
+ * instead of formatted text. Decode them with tools/log_tokens.py. C call
+ * sites hash their token at run time, C++ ones at compile time.
+ */
+#ifndef LOG_BINARY_EN
+#define LOG_BINARY_EN 0
+#endif
+
+/**
+ * @def LOG_TAG_SLOTS
+ * Number of per-tag thresholds LOG_SET_TAG_LEVEL can hold. Power of two.
+ */
+#ifndef LOG_TAG_SLOTS
+#define LOG_TAG_SLOTS 16
+#endif
+
+/*****************************************************************************
+ * Datatypes                                                                 *
+ *****************************************************************************/
+
+/**
+ * \enum log_type_t
+ * Defines the types of logs.
+ */
+typedef enum 
+{
+    LOG_TYPE_INFO,
+    LOG_TYPE_WARNING,
+    LOG_TYPE_DEBUG,
+    LOG_TYPE_ERROR,
+} log_type_t;
+
+/**
+ * \enum log_level_t
+ * Runtime thresholds, in increasing severity. A line is written when its
+ * level is at or above the threshold of its tag.
+ */
+typedef enum
+{
+    LOG_LEVEL_DEBUG,
+    LOG_LEVEL_INFO,
+    LOG_LEVEL_WARN,
+    LOG_LEVEL_ERROR,
+    LOG_LEVEL_NONE,
+} log_level_t;
+
+/*****************************************************************************
+ * Public Variables                                                          *
+ *****************************************************************************/
+
+/* Read by the inline level check, only written through the setters below. */
+extern uint8_t log_default_level;
+extern uint8_t log_tag_count;
+extern uint8_t log_sink_floor;              /* Lowest level of any sink. */
+
 /*****************************************************************************
  * Public Functions                                                          *
  *****************************************************************************/
 
 void LOG_INIT (void);
 
-void LOG_INFO (const char * tag, const char * fmt, ...);
+/**
+ * @brief Formats and outputs one text line, or with LOG_BINARY_EN one
+ * binary frame. Called by the LOG_* macros.
+ */
+void log_write (log_type_t type, const char * tag, const char * fmt, ...);
+
+/**
+ * @brief Sets the threshold of every tag without its own level.
+ */
+void LOG_SET_LEVEL (log_level_t level);
 
-void LOG_WARN (const char * tag, const char * fmt, ...);
+/**
+ * @brief Sets the threshold of one tag. LOG_LEVEL_NONE silences it.
+ * Returns false if the tag table is full.
+ */
+bool LOG_SET_TAG_LEVEL (const char * tag, log_level_t level);
 
-void LOG_DEBUG (const char * tag, const char * fmt, ...);
+/**
+ * @brief Looks the tag up in the tag table. Used by log_enabled.
+ */
+bool log_tag_enabled (uint32_t hash, log_level_t level);
 
-void LOG_ERROR (const char * tag, const char * fmt, ...);
+/**
+ * @brief Runtime level check. Without per-tag levels it is two compares;
+ * a line no sink takes is never formatted.
+ */
+static inline bool log_enabled (uint32_t hash, log_level_t level)
+{
+    return ((uint8_t)level >= log_sink_floor) &&
+           ((log_tag_count == 0) ? ((uint8_t)level >= log_default_level)
+                                 : log_tag_enabled(hash, level));
+}
+
+/**
+ * @brief Formats the lines captured in interrupt handlers (see log_isr.h),
+ * then writes each sink whose batch is due, as much as it takes without
+ * blocking. Call it from loop().
+ */
+void LOG_PROCESS (void);
+
+/**
+ * @brief Blocks until every sink has written what it holds, giving up on
+ * a sink that takes nothing for LOG_FLUSH_TIMEOUT_US.
+ */
+void LOG_FLUSH (void);
+
+/**
+ * @brief Drops the pending deferred output without writing it.
+ */
+void LOG_DISCARD (void);
+
+/**
+ * @brief Returns the number of lines dropped, summed over the sinks, plus
+ * those interrupt handlers could not capture.
+ */
+uint32_t LOG_DROPPED (void);
 
-void LOG_ERROR_LOCK (const char * tag, const char * fmt, ...);
+/**
+ * @brief Flushes pending log output and halts. Used by LOG_ERROR_LOCK.
+ */
+void log_halt (void);
 
 #ifdef __cplusplus
 }
 #endif
 
+/*****************************************************************************
+ * Log Macros                                                                *
+ *****************************************************************************/
+
+/*
+ * Levels disabled at build time expand to nothing, so their arguments are
+ * never evaluated. Enabled levels check the runtime threshold of the tag
+ * first; the tag hash is a compile-time constant in C++.
+ *
+ * They may be used from interrupt handlers: the line is captured and only
+ * formatted by LOG_PROCESS. Tags, formats and %s arguments must then be
+ * string literals.
+ */
+
+#if (LOG_BINARY_EN == 1) && defined(__cplusplus)
+#include "log_bin.h"
+#define LOG_OUT(type, tag, fmt, ...)    LOG_BIN_WRITE(type, tag, fmt, ##__VA_ARGS__)
+#else
+#define LOG_OUT(type, tag, fmt, ...)    log_write(type, tag, fmt, ##__VA_ARGS__)
+#endif
+
+#define LOG_EMIT(type, level, tag, fmt, ...)                    \
+    do                                                          \
+    {                                                           \
+        if (log_enabled(LOG_TAG_HASH(tag), level))              \
+        {                                                       \
+            LOG_OUT(type, tag, fmt, ##__VA_ARGS__);             \
+        }                                                       \
+    } while (0)
+
+#if (LOGGER_EN == 1) && (LOG_INFO_EN == 1)
+#define LOG_INFO(tag, fmt, ...)     LOG_EMIT(LOG_TYPE_INFO, LOG_LEVEL_INFO, tag, fmt, ##__VA_ARGS__)
+#else
+#define LOG_INFO(tag, fmt, ...)     do {} while (0)
+#endif
+
+#if (LOGGER_EN == 1) && (LOG_WARN_EN == 1)
+#define LOG_WARN(tag, fmt, ...)     LOG_EMIT(LOG_TYPE_WARNING, LOG_LEVEL_WARN, tag, fmt, ##__VA_ARGS__)
+#else
+#define LOG_WARN(tag, fmt, ...)     do {} while (0)
+#endif
+
+#if (LOGGER_EN == 1) && (LOG_DEBUG_EN == 1)
+#define LOG_DEBUG(tag, fmt, ...)    LOG_EMIT(LOG_TYPE_DEBUG, LOG_LEVEL_DEBUG, tag, fmt, ##__VA_ARGS__)
+#else
+#define LOG_DEBUG(tag, fmt, ...)    do {} while (0)
+#endif
+
+#if (LOGGER_EN == 1) && (LOG_ERROR_EN == 1)
+#define LOG_ERROR(tag, fmt, ...)    LOG_EMIT(LOG_TYPE_ERROR, LOG_LEVEL_ERROR, tag, fmt, ##__VA_ARGS__)
+#define LOG_ERROR_LOCK(tag, fmt, ...) \
+    do { LOG_EMIT(LOG_TYPE_ERROR, LOG_LEVEL_ERROR, tag, fmt, ##__VA_ARGS__); log_halt(); } while (0)
+#else
+#define LOG_ERROR(tag, fmt, ...)    do {} while (0)
+#define LOG_ERROR_LOCK(tag, fmt, ...) do {} while (0)
+#endif
+
 #endif /* _LOGGER_H */
 
 /* end of file */
\ No newline at end of file
@@ -0,0 +1,141 @@
+/*****************************************************************************
+ *                                                                           *
+ * \file meminfo.h                                                           *
+ *                                                                           *
+ * \brief RAM budget: stack high-water mark, heap and static buffers.        *
+ *                                                                           *
+ * The SAMD21 has 32 KB of RAM: .data and .bss from the bottom, the heap     *
+ * growing up from their end and the stack growing down from the top. The   *
+ * ISRs run on the same stack. meminfo_paint fills the free room between the *
+ * heap and the stack with a pattern at boot; the first word found changed, *
+ * scanning up, marks the deepest the stack has been since.                  *
+ *                                                                           *
+ * Modules register their large static buffers with meminfo_register (or    *
+ * MEMINFO_REGISTER), so the report shows where the RAM goes at run time.    *
+ * tools/ram_map.py gives the full per-module map at build time.             *
+ *                                                                           *
+ * On the host only the buffer registry is kept; stack and heap read 0.      *
+ *                                                                           *
+ * \author blackchacal <ribeiro.tonet@gmail.com>                             *
+ * \date Oct 17, 2026                                                        *
+ *                                                                           *
+ * \version 1.0 | \author blackchacal                                        *
+ * File creation.                                                            *
+ *                                                                           *
+ *****************************************************************************/
+
+#ifndef _MEMINFO_H
+#define _MEMINFO_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*****************************************************************************
+ * Includes                                                                  *
+ *****************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "suricata_config.h"
+
+/*****************************************************************************
+ * Configuration Macros                                                      *
+ *****************************************************************************/
+
+/**
+ * @def MEMINFO_MAX_BUFFERS
+ * Buffers the registry holds. Later ones are refused.
+ */
+#ifndef MEMINFO_MAX_BUFFERS
+#define MEMINFO_MAX_BUFFERS     16
+#endif
+
+/**
+ * @def MEMINFO_GAP_WARN
+ * The report warns when the room left between the heap and the deepest
+ * stack seen drops below this many bytes.
+ */
+#ifndef MEMINFO_GAP_WARN
+#define MEMINFO_GAP_WARN        1024
+#endif
+
+/*****************************************************************************
+ * Macros                                                                    *
+ *****************************************************************************/
+
+/* --- Error codes ----------------------------------------------------------*/
+
+#ifndef ERR_OK
+#define ERR_OK                          (0)
+#endif
+#define ERR_MEMINFO_NULL_POINTER        (-130)
+#define ERR_MEMINFO_FULL                (-131)
+
+/**
+ * @def MEMINFO_REGISTER
+ * Registers a static array under its own name.
+ */
+#define MEMINFO_REGISTER(buf)           meminfo_register(#buf, (buf), sizeof(buf))
+
+/*****************************************************************************
+ * Datatypes                                                                 *
+ *****************************************************************************/
+
+/**
+ * \struct meminfo_stats_t
+ * RAM use, in bytes.
+ */
+typedef struct
+{
+    uint32_t ram;               /* Total RAM. */
+    uint32_t statics;           /* .data and .bss. */
+    uint32_t heap;              /* Heap taken from the system so far. */
+    uint32_t heap_free;         /* Freed chunks inside it. */
+    uint32_t stack;             /* Stack in use now. */
+    uint32_t stack_high;        /* Deepest stack since meminfo_paint. */
+    uint32_t gap;               /* Untouched room between heap and stack. */
+    uint32_t buffers;           /* Sum of the registered buffers. */
+} meminfo_stats_t;
+
+/*****************************************************************************
+ * Public Functions                                                          *
+ *****************************************************************************/
+
+/**
+ * @brief Paints the free room below the stack. Call it first in setup().
+ */
+void meminfo_paint (void);
+
+/**
+ * @brief Adds a buffer to the registry. Buffers live for the whole run.
+ *
+ * @param name Shown in the report, must stay valid (a literal).
+ * @param buf
+ * @param size Bytes.
+ * @return int
+ */
+int meminfo_register (const char * name, const void * buf, size_t size);
+
+/**
+ * @brief Fills stats. Scans the painted room, so it takes a while when
+ * little of it was used.
+ */
+void meminfo_stats (meminfo_stats_t * stats);
+
+/**
+ * @brief Logs one line with the RAM use and warns if the gap is low.
+ *
+ * @param buffers Also logs one line per registered buffer.
+ */
+void meminfo_report (bool buffers);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _MEMINFO_H */
+
+/* end of file */
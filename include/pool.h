@@ -0,0 +1,148 @@
+/*****************************************************************************
+ *                                                                           *
+ * \file pool.h                                                              *
+ *                                                                           *
+ * \brief Static fixed-block pool allocator.                                 *
+ *                                                                           *
+ * A pool hands out blocks of one size from storage sized at compile time    *
+ * with POOL_DEFINE, like data_buf, so the RAM budget is known at link time  *
+ * and the heap stays unused. Free blocks are chained through their first    *
+ * word; blocks never handed out yet are carved off the storage in order,    *
+ * so a pool needs no init. pool_alloc and pool_free are O(1) and run in a   *
+ * short critical section, so the main context and ISRs may share a pool.    *
+ *                                                                           *
+ * Each pool keeps its high-water mark and the number of failed allocations, *
+ * to size it from a real run.                                               *
+ *                                                                           *
+ * \author blackchacal <ribeiro.tonet@gmail.com>                             *
+ * \date Oct 17, 2026                                                        *
+ *                                                                           *
+ * \version 1.0 | \author blackchacal                                        *
+ * File creation.                                                            *
+ *                                                                           *
+ *****************************************************************************/
+
+#ifndef _POOL_H
+#define _POOL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*****************************************************************************
+ * Includes                                                                  *
+ *****************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "suricata_config.h"
+
+/*****************************************************************************
+ * Macros                                                                    *
+ *****************************************************************************/
+
+/* --- Error codes ----------------------------------------------------------*/
+
+#ifndef ERR_OK
+#define ERR_OK                          (0)
+#endif
+#define ERR_POOL_NULL_POINTER           (-120)
+#define ERR_POOL_INVALID_BLOCK          (-121)
+
+/* --- Definition -----------------------------------------------------------*/
+
+/**
+ * @def POOL_STRIDE
+ * Bytes taken by one block of size bytes: room for the free list link,
+ * rounded up to keep every block pointer aligned.
+ */
+#define POOL_STRIDE(size)                                                    \
+    ((uint16_t)((((size) < sizeof(void *) ? sizeof(void *) : (size)) +       \
+                 sizeof(void *) - 1) / sizeof(void *) * sizeof(void *)))
+
+/**
+ * @def POOL_DEFINE
+ * Defines the pool_t name with storage for count blocks of size bytes.
+ * Use POOL_DECLARE(name) to reach it from other modules.
+ */
+#define POOL_DEFINE(name, size, count)                                       \
+    static void * name##_storage[(count) * POOL_STRIDE(size) / sizeof(void *)]; \
+    pool_t name = {#name, (uint8_t *)name##_storage, (uint16_t)(size),       \
+                   POOL_STRIDE(size), (uint16_t)(count), NULL, 0, 0, 0, 0}
+
+#define POOL_DECLARE(name)              extern pool_t name
+
+/*****************************************************************************
+ * Datatypes                                                                 *
+ *****************************************************************************/
+
+/**
+ * \struct pool_t
+ * One pool. Define it with POOL_DEFINE, its fields are private.
+ */
+typedef struct
+{
+    const char * name;
+    uint8_t * storage;
+    uint16_t size;
+    uint16_t stride;
+    uint16_t count;
+    void * free_list;
+    uint16_t carved;            /* Blocks taken off the storage so far. */
+    uint16_t used;
+    uint16_t high_water;
+    uint32_t failed;
+} pool_t;
+
+/**
+ * \struct pool_stats_t
+ * Pool counters.
+ */
+typedef struct
+{
+    uint16_t size;              /* Block size. */
+    uint16_t count;
+    uint16_t used;
+    uint16_t high_water;        /* Most blocks in use at once. */
+    uint32_t failed;            /* Allocations refused, pool empty. */
+} pool_stats_t;
+
+/*****************************************************************************
+ * Public Functions                                                          *
+ *****************************************************************************/
+
+/**
+ * @brief Takes one block.
+ *
+ * @param pool
+ * @return void* The block, or NULL if the pool is empty.
+ */
+void * pool_alloc (pool_t * pool);
+
+/**
+ * @brief Gives a block back.
+ *
+ * @param pool
+ * @param block A block of this pool, in use.
+ * @return int
+ */
+int pool_free (pool_t * pool, void * block);
+
+/**
+ * @brief Copies the pool counters.
+ */
+void pool_stats (const pool_t * pool, pool_stats_t * stats);
+
+/**
+ * @brief Logs one line with the pool counters.
+ */
+void pool_report (const pool_t * pool);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _POOL_H */
+
+/* end of file */
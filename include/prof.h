@@ -0,0 +1,144 @@
+/*****************************************************************************
+ *                                                                           *
+ * \file prof.h                                                              *
+ *                                                                           *
+ * \brief Profiling zones for the hot paths, reported through the logger.    *
+ *                                                                           *
+ * A zone times the code between its begin and end and accumulates count,   *
+ * min, max and total in a static table; prof_report logs one line per zone *
+ * and starts the counts over. C code brackets a zone with PROF_BEGIN and    *
+ * PROF_END, C++ code uses PROF_SCOPE, which ends the zone with the scope.   *
+ * A zone is named by an identifier and registers itself the first time it  *
+ * runs; call sites with the same name share a zone.                        *
+ *                                                                           *
+ * The unit is the same as bench.h: CPU cycles on the board, from SysTick    *
+ * and the millisecond count, and nanoseconds on the host. The fixed cost of *
+ * a zone is measured by prof_init and subtracted.                           *
+ *                                                                           *
+ * Build with the nano_33_iot_prof or native_prof environments, which set    *
+ * PROF_EN to 1. Otherwise the macros compile to nothing.                    *
+ *                                                                           *
+ * \author blackchacal <ribeiro.tonet@gmail.com>                             *
+ * \date Oct 17, 2026                                                        *
+ *                                                                           *
+ * \version 1.0 | \author blackchacal                                        *
+ * File creation.                                                            *
+ *                                                                           *
+ *****************************************************************************/
+
+#ifndef _PROF_H
+#define _PROF_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*****************************************************************************
+ * Includes                                                                  *
+ *****************************************************************************/
+
+#include <stdint.h>
+
+#include "suricata_config.h"
+
+/*****************************************************************************
+ * Configuration Macros                                                      *
+ *****************************************************************************/
+
+#ifndef PROF_EN
+#define PROF_EN 0
+#endif
+
+/**
+ * @def PROF_MAX_ZONES
+ * Zones the table holds. Zones past it are not timed.
+ */
+#ifndef PROF_MAX_ZONES
+#define PROF_MAX_ZONES 16
+#endif
+
+/*****************************************************************************
+ * Macros                                                                    *
+ *****************************************************************************/
+
+/* Zone id of a call site not registered yet. */
+#define PROF_NO_ZONE                    (0xFF)
+
+#if PROF_EN == 1
+#define PROF_BEGIN(zone)                                                     \
+    static uint8_t prof_id_##zone = PROF_NO_ZONE;                            \
+    uint32_t prof_t0_##zone = prof_begin(&prof_id_##zone, #zone)
+
+#define PROF_END(zone)                  prof_end(prof_id_##zone, prof_t0_##zone)
+#else
+#define PROF_BEGIN(zone)                do {} while (0)
+#define PROF_END(zone)                  do {} while (0)
+#endif
+
+/*****************************************************************************
+ * Public Functions                                                          *
+ *****************************************************************************/
+
+/**
+ * @brief Measures the fixed cost of a zone. Call it once from setup().
+ * Does nothing if PROF_EN is 0.
+ */
+void prof_init (void);
+
+/**
+ * @brief Starts a zone, registering it on its first run. Use PROF_BEGIN.
+ *
+ * @param id Zone id cached by the call site.
+ * @param name Zone name, must stay valid (a literal).
+ * @return uint32_t Time stamp to hand to prof_end.
+ */
+uint32_t prof_begin (uint8_t * id, const char * name);
+
+/**
+ * @brief Ends a zone. Use PROF_END.
+ */
+void prof_end (uint8_t id, uint32_t start);
+
+/**
+ * @brief Logs count, min, average, max and total of every zone run since
+ * the last report, then starts them over. Does nothing if PROF_EN is 0.
+ */
+void prof_report (void);
+
+#ifdef __cplusplus
+}
+
+/**
+ * \class ProfScope
+ * Zone ending with the enclosing scope. Use PROF_SCOPE.
+ */
+class ProfScope
+{
+public:
+    ProfScope (uint8_t * id, const char * name) : id_(id), start_(prof_begin(id, name))
+    {
+    }
+
+    ~ProfScope ()
+    {
+        prof_end(*id_, start_);
+    }
+
+private:
+    uint8_t * id_;
+    uint32_t start_;
+};
+
+#if PROF_EN == 1
+#define PROF_SCOPE(zone)                                                     \
+    static uint8_t prof_id_##zone = PROF_NO_ZONE;                            \
+    ProfScope prof_scope_##zone(&prof_id_##zone, #zone)
+#else
+#define PROF_SCOPE(zone)                do {} while (0)
+#endif
+
+#endif /* __cplusplus */
+
+#endif /* _PROF_H */
+
+/* end of file */
@@ -25,6 +25,31 @@ extern "C" {
 
 #include "suricata_config.h"
 
+/*****************************************************************************
+ * Configuration Macros                                                      *
+ *****************************************************************************/
+
+/**
+ * @def RBUFFER_STATS_EN
+ * When 1, each rbuffer_t keeps occupancy and latency statistics, read with
+ * rbuffer_stats: high-water mark, rejected adds, bytes in and out, and a
+ * histogram of the residence time of the data. One byte at a time is
+ * followed from add to removal, so residence is sampled, not measured for
+ * every byte. Only the C API keeps them, not RingBuffer<T, N>.
+ */
+#ifndef RBUFFER_STATS_EN
+#define RBUFFER_STATS_EN 0
+#endif
+
+/**
+ * @def RBUFFER_STATS_BUCKETS
+ * Residence histogram buckets. Bucket i counts residences under
+ * 2^(i + 7) us, and at least half that; the last one also takes longer.
+ */
+#ifndef RBUFFER_STATS_BUCKETS
+#define RBUFFER_STATS_BUCKETS 20
+#endif
+
 /*****************************************************************************
  * Macros                                                                    *    
  *****************************************************************************/
@@ -38,11 +63,44 @@ extern "C" {
 #define ERR_RBUFFER_EMPTY               (-4)
 #define ERR_RBUFFER_NOT_ENOUGH_SPACE    (-5)
 #define ERR_RBUFFER_NOT_ENOUGH_DATA     (-6)
+#define ERR_RBUFFER_OVERRUN             (-7)
+
+/* --- Zero-copy access -----------------------------------------------------*/
+
+/**
+ * @def RBUFFER_MAX_SPANS
+ * A region of the ring can wrap around the end of the buffer at most once,
+ * so it is always described by up to two contiguous spans.
+ */
+#define RBUFFER_MAX_SPANS               (2)
 
 /*****************************************************************************
  * Datatypes                                                                 *
  *****************************************************************************/
 
+/**
+ * \enum rbuffer_policy_t
+ * Defines what an add does when there is not enough free space.
+ */
+typedef enum
+{
+    RBUFFER_POLICY_REJECT,      /* Fail with ERR_RBUFFER_FULL/NOT_ENOUGH_SPACE. */
+    RBUFFER_POLICY_OVERWRITE,   /* Drop the oldest data to make room. */
+} rbuffer_policy_t;
+
+/**
+ * \struct rbuffer_stats_t
+ * Statistics of one rbuffer since rbuffer_init, see RBUFFER_STATS_EN.
+ */
+typedef struct
+{
+    uint16_t high_water;        /* Most bytes held at once. */
+    uint32_t rejected;          /* Adds failed for lack of space. */
+    uint32_t bytes_in;
+    uint32_t bytes_out;         /* Taken by the consumer, or cleared. */
+    uint32_t residence[RBUFFER_STATS_BUCKETS];
+} rbuffer_stats_t;
+
 typedef struct
 {
     uint8_t * buf;
@@ -50,8 +108,28 @@ typedef struct
     uint16_t tail;
     uint16_t size;
     uint16_t lot;
+    uint8_t policy;
+    uint32_t overruns;          /* Bytes dropped by RBUFFER_POLICY_OVERWRITE. */
+    uint32_t mark;              /* Value of overruns at the last peek. */
+#if RBUFFER_STATS_EN == 1
+    rbuffer_stats_t stats;
+    uint32_t probe_pos;         /* bytes_in once the followed byte was added. */
+    uint32_t probe_us;
+    uint8_t probe_armed;
+#endif
 } rbuffer_t;
 
+/**
+ * \struct rbuffer_span_t
+ * Contiguous region inside a ring buffer storage. An unused span has
+ * len 0.
+ */
+typedef struct
+{
+    uint8_t * ptr;
+    uint16_t len;
+} rbuffer_span_t;
+
 /*****************************************************************************
  * Public Functions                                                          *
  *****************************************************************************/
@@ -62,9 +140,10 @@ typedef struct
  * @param rb 
  * @param buffer 
  * @param buf_size 
+ * @param policy Behaviour of adds when the rbuffer runs out of space.
  * @return int 
  */
-int rbuffer_init (rbuffer_t * rb, uint8_t * buffer, uint16_t buf_size);
+int rbuffer_init (rbuffer_t * rb, uint8_t * buffer, uint16_t buf_size, rbuffer_policy_t policy);
 
 /**
  * @brief Adds one byte to rbuffer.
@@ -83,7 +162,7 @@ int rbuffer_add_byte (rbuffer_t * rb, uint8_t byte);
  * @param nbytes 
  * @return int 
  */
-int rbuffer_add_bytes (rbuffer_t * rb, uint8_t * data, uint16_t nbytes);
+int rbuffer_add_bytes (rbuffer_t * rb, const uint8_t * data, uint16_t nbytes);
 
 /**
  * @brief Gets one byte from rbuffer.
@@ -102,7 +181,60 @@ int rbuffer_get_byte (rbuffer_t * rb, uint8_t * byte);
  * @param nbytes 
  * @return int 
  */
-int rbuffer_get_bytes (rbuffer_t * rb, uint8_t * data, uint8_t nbytes);
+int rbuffer_get_bytes (rbuffer_t * rb, uint8_t * data, uint16_t nbytes);
+
+/**
+ * @brief Reserves nbytes of free space for in-place writing. The data only
+ * becomes visible to the consumer after rbuffer_commit.
+ * 
+ * @param rb 
+ * @param nbytes 
+ * @param span Filled with up to RBUFFER_MAX_SPANS regions of nbytes total.
+ * @return int 
+ */
+int rbuffer_reserve (rbuffer_t * rb, uint16_t nbytes, rbuffer_span_t span[RBUFFER_MAX_SPANS]);
+
+/**
+ * @brief Publishes nbytes previously written through rbuffer_reserve.
+ * 
+ * @param rb 
+ * @param nbytes 
+ * @return int 
+ */
+int rbuffer_commit (rbuffer_t * rb, uint16_t nbytes);
+
+/**
+ * @brief Exposes all readable data in place without removing it.
+ * 
+ * @param rb 
+ * @param span Filled with up to RBUFFER_MAX_SPANS regions, oldest first.
+ * @return int 
+ */
+int rbuffer_peek (rbuffer_t * rb, rbuffer_span_t span[RBUFFER_MAX_SPANS]);
+
+/**
+ * @brief Removes nbytes of data, typically after rbuffer_peek. With
+ * RBUFFER_POLICY_OVERWRITE, returns ERR_RBUFFER_OVERRUN and removes nothing
+ * if the producer dropped data since the peek; the peeked spans are stale
+ * and must be peeked again.
+ * 
+ * @param rb 
+ * @param nbytes 
+ * @return int 
+ */
+int rbuffer_consume (rbuffer_t * rb, uint16_t nbytes);
+
+/**
+ * @brief Producer-side removal of the oldest nbytes, counted as overruns.
+ * Lets framing layers on RBUFFER_POLICY_OVERWRITE buffers drop whole units
+ * instead of partial ones. The caller must not be preempted by the
+ * consumer between sizing the unit and dropping it.
+ * 
+ * @param rb 
+ * @param nbytes 
+ * @return int 
+ */
+int rbuffer_drop (rbuffer_t * rb, uint16_t nbytes);
 
 /**
  * @brief Check if rbuffer is empty.
@@ -138,6 +270,14 @@ uint16_t rbuffer_free (const rbuffer_t * rb);
  */
 uint16_t rbuffer_used (const rbuffer_t * rb);
 
+/**
+ * @brief Returns the number of bytes dropped by RBUFFER_POLICY_OVERWRITE.
+ * 
+ * @param rb 
+ * @return uint32_t 
+ */
+uint32_t rbuffer_overruns (const rbuffer_t * rb);
+
 /**
  * @brief Clears rbuffer by resetting all pointers.
  * 
@@ -146,6 +286,26 @@ uint16_t rbuffer_used (const rbuffer_t * rb);
  */
 int rbuffer_clear (rbuffer_t * rb);
 
+/**
+ * @brief Takes a consistent copy of the statistics. All zero if
+ * RBUFFER_STATS_EN is 0.
+ * 
+ * @param rb 
+ * @param stats 
+ * @return int 
+ */
+int rbuffer_stats (const rbuffer_t * rb, rbuffer_stats_t * stats);
+
+/**
+ * @brief Residence time that pct percent of the sampled data stayed under,
+ * rounded up to a histogram bucket.
+ * 
+ * @param stats 
+ * @param pct 1 to 100.
+ * @return uint32_t Microseconds, 0 if nothing was sampled.
+ */
+uint32_t rbuffer_stats_residence (const rbuffer_stats_t * stats, uint8_t pct);
+
 #ifdef __cplusplus
 }
 #endif
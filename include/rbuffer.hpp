@@ -0,0 +1,515 @@
+/*****************************************************************************
+ *                                                                           *
+ * \file rbuffer.hpp                                                         *
+ *                                                                           *
+ * \brief Compile-time specialized ring buffer template.                     *
+ *                                                                           *
+ * RingBuffer<T, N> stores whole elements of type T (e.g. sample structs)    *
+ * with N checked to be a power of two at compile time, so the index mask    *
+ * is a constant. The algorithms live in rbuffer_core::Ops and are shared    *
+ * with the C rbuffer_t API, which is a thin wrapper over them.              *
+ *                                                                           *
+ * \author blackchacal <ribeiro.tonet@gmail.com>                             *
+ * \date Oct 17, 2026                                                        *
+ *                                                                           *
+ * \version 1.0 | \author blackchacal                                        *
+ * File creation.                                                            *
+ *                                                                           *
+ *****************************************************************************/
+
+#ifndef _RBUFFER_HPP
+#define _RBUFFER_HPP
+
+/*****************************************************************************
+ * Includes                                                                  *
+ *****************************************************************************/
+
+/* --- Standard libraries -------------------- */
+#include <stdint.h>
+#include <string.h>
+#include <type_traits>
+
+/* --- Arduino libraries -------------------- */
+#include <Arduino.h>
+
+/* --- Custom modules -------------------- */
+#include "rbuffer.h"
+
+/*****************************************************************************
+ * Ring buffer core                                                          *
+ *****************************************************************************/
+
+namespace rbuffer_core
+{
+
+/**
+ * \struct Span
+ * Contiguous region of elements inside a ring buffer storage.
+ */
+template <typename T>
+struct Span
+{
+    T * ptr;
+    uint16_t len;
+};
+
+inline void enter_critical (void)
+{
+    noInterrupts();
+}
+
+inline void exit_critical (void)
+{
+    interrupts();
+}
+
+/**
+ * @brief Reads an index that the other context may update. Keeps the
+ * compiler from caching it across calls once everything is inlined.
+ */
+inline uint16_t load (const uint16_t & v)
+{
+    return __atomic_load_n(&v, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Reads the overrun counter. Acquire ordering keeps the reads of
+ * tail and of the stored data after it.
+ */
+inline uint32_t load (const uint32_t & v)
+{
+    return __atomic_load_n(&v, __ATOMIC_ACQUIRE);
+}
+
+/**
+ * \class Ops
+ * Ring buffer algorithms. Ring must provide value_type, data(), size(),
+ * mask(), policy() and head(), tail(), lot(), ovr(), mark() accessors.
+ * When size() and mask() are constexpr the masking folds into immediate
+ * operands.
+ *
+ * With RBUFFER_POLICY_OVERWRITE the producer drops the oldest elements
+ * before writing and bumps ovr(). A reader copies out, then only moves
+ * tail if ovr() did not change meanwhile; otherwise the copy may hold
+ * rewritten slots and is retried (get) or reported (consume).
+ */
+template <typename Ring>
+struct Ops
+{
+    typedef typename Ring::value_type T;
+
+    static uint16_t used (const Ring & r)
+    {
+        return load(r.lot());
+    }
+
+    static uint16_t free (const Ring & r)
+    {
+        return r.size() - used(r);
+    }
+
+    static bool empty (const Ring & r)
+    {
+        return used(r) == 0;
+    }
+
+    static bool full (const Ring & r)
+    {
+        return used(r) == r.size();
+    }
+
+    static bool overwrite (const Ring & r)
+    {
+        return r.policy() == RBUFFER_POLICY_OVERWRITE;
+    }
+
+    /**
+     * @brief Largest add that can succeed right now.
+     */
+    static uint16_t room (const Ring & r)
+    {
+        return overwrite(r) ? r.size() : free(r);
+    }
+
+    template <typename S>
+    static void split (Ring & r, uint16_t idx, uint16_t n, S span[RBUFFER_MAX_SPANS])
+    {
+        uint16_t size_to_end = r.size() - idx;
+
+        span[0].ptr = r.data() + idx;
+        if (size_to_end < n)
+        {
+            span[0].len = size_to_end;
+            span[1].ptr = r.data();
+            span[1].len = n - size_to_end;
+        }
+        else
+        {
+            span[0].len = n;
+            span[1].ptr = r.data();
+            span[1].len = 0;
+        }
+    }
+
+    /**
+     * @brief Drops the oldest elements so that n more fit. Done before the
+     * new data is written so no reader takes a slot being rewritten as
+     * valid data.
+     */
+    static void make_room (Ring & r, uint16_t n)
+    {
+        enter_critical();
+        uint16_t space = r.size() - r.lot();
+        if (n > space)
+        {
+            uint16_t drop = n - space;
+            r.tail() = (r.tail() + drop) & r.mask();
+            r.lot() -= drop;
+            r.ovr() += drop;
+        }
+        exit_critical();
+    }
+
+    static void advance_head (Ring & r, uint16_t n)
+    {
+        enter_critical();
+        r.head() = (r.head() + n) & r.mask();
+        r.lot() += n;
+        exit_critical();
+    }
+
+    /**
+     * @brief Moves tail by n unless the producer dropped data since the
+     * overrun counter read ovr.
+     */
+    static bool advance_tail (Ring & r, uint16_t n, uint32_t ovr)
+    {
+        bool ok;
+
+        enter_critical();
+        ok = (r.ovr() == ovr);
+        if (ok)
+        {
+            r.tail() = (r.tail() + n) & r.mask();
+            r.lot() -= n;
+        }
+        exit_critical();
+
+        return ok;
+    }
+
+    static int add (Ring & r, const T & item)
+    {
+        int err = ERR_OK;
+
+        if (!overwrite(r) && full(r))
+        {
+            err = ERR_RBUFFER_FULL;
+        }
+        else
+        {
+            if (overwrite(r))
+            {
+                make_room(r, 1);
+            }
+            r.data()[r.head()] = item;
+            advance_head(r, 1);
+        }
+
+        return err;
+    }
+
+    static int add (Ring & r, const T * items, uint16_t n)
+    {
+        int err = ERR_OK;
+
+        if (!overwrite(r) && full(r))
+        {
+            err = ERR_RBUFFER_FULL;
+        }
+        else if (n == 0)
+        {
+            err = ERR_RBUFFER_INVALID_SIZE;
+        }
+        else if (n > room(r))
+        {
+            err = ERR_RBUFFER_NOT_ENOUGH_SPACE;
+        }
+        else
+        {
+            Span<T> span[RBUFFER_MAX_SPANS];
+            if (overwrite(r))
+            {
+                make_room(r, n);
+            }
+            split(r, r.head(), n, span);
+            memcpy(span[0].ptr, items, span[0].len * sizeof(T));
+            memcpy(span[1].ptr, items + span[0].len, span[1].len * sizeof(T));
+            advance_head(r, n);
+        }
+
+        return err;
+    }
+
+    static int get (Ring & r, T & item)
+    {
+        int err = ERR_OK;
+        bool done = false;
+
+        while (!done)
+        {
+            uint32_t ovr = load(r.ovr());
+
+            if (empty(r))
+            {
+                err = ERR_RBUFFER_EMPTY;
+                done = true;
+            }
+            else
+            {
+                item = r.data()[load(r.tail())];
+                done = advance_tail(r, 1, ovr);
+            }
+        }
+
+        return err;
+    }
+
+    static int get (Ring & r, T * items, uint16_t n)
+    {
+        int err = ERR_OK;
+        bool done = false;
+
+        while (!done)
+        {
+            uint32_t ovr = load(r.ovr());
+            done = true;
+
+            if (empty(r))
+            {
+                err = ERR_RBUFFER_EMPTY;
+            }
+            else if (n == 0)
+            {
+                err = ERR_RBUFFER_INVALID_SIZE;
+            }
+            else if (n > used(r))
+            {
+                err = ERR_RBUFFER_NOT_ENOUGH_DATA;
+            }
+            else
+            {
+                Span<T> span[RBUFFER_MAX_SPANS];
+                split(r, load(r.tail()), n, span);
+                memcpy(items, span[0].ptr, span[0].len * sizeof(T));
+                memcpy(items + span[0].len, span[1].ptr, span[1].len * sizeof(T));
+                done = advance_tail(r, n, ovr);
+            }
+        }
+
+        return err;
+    }
+
+    template <typename S>
+    static int reserve (Ring & r, uint16_t n, S span[RBUFFER_MAX_SPANS])
+    {
+        int err = ERR_OK;
+
+        if (!overwrite(r) && full(r))
+        {
+            err = ERR_RBUFFER_FULL;
+        }
+        else if (n == 0)
+        {
+            err = ERR_RBUFFER_INVALID_SIZE;
+        }
+        else if (n > room(r))
+        {
+            err = ERR_RBUFFER_NOT_ENOUGH_SPACE;
+        }
+        else
+        {
+            if (overwrite(r))
+            {
+                make_room(r, n);
+            }
+            split(r, r.head(), n, span);
+        }
+
+        return err;
+    }
+
+    static int commit (Ring & r, uint16_t n)
+    {
+        int err = ERR_OK;
+
+        if (n == 0)
+        {
+            err = ERR_RBUFFER_INVALID_SIZE;
+        }
+        else if (n > free(r))
+        {
+            err = ERR_RBUFFER_NOT_ENOUGH_SPACE;
+        }
+        else
+        {
+            advance_head(r, n);
+        }
+
+        return err;
+    }
+
+    template <typename S>
+    static int peek (Ring & r, S span[RBUFFER_MAX_SPANS])
+    {
+        int err = ERR_OK;
+
+        r.mark() = load(r.ovr());
+        if (empty(r))
+        {
+            err = ERR_RBUFFER_EMPTY;
+        }
+        else
+        {
+            enter_critical();
+            split(r, r.tail(), r.lot(), span);
+            exit_critical();
+        }
+
+        return err;
+    }
+
+    static int consume (Ring & r, uint16_t n)
+    {
+        int err = ERR_OK;
+
+        if (empty(r))
+        {
+            err = ERR_RBUFFER_EMPTY;
+        }
+        else if (n == 0)
+        {
+            err = ERR_RBUFFER_INVALID_SIZE;
+        }
+        else if (n > used(r))
+        {
+            err = ERR_RBUFFER_NOT_ENOUGH_DATA;
+        }
+        else if (!advance_tail(r, n, r.mark()))
+        {
+            err = ERR_RBUFFER_OVERRUN;
+        }
+
+        return err;
+    }
+
+    static int drop (Ring & r, uint16_t n)
+    {
+        int err = ERR_OK;
+
+        if (n == 0)
+        {
+            err = ERR_RBUFFER_INVALID_SIZE;
+        }
+        else
+        {
+            enter_critical();
+            if (n > r.lot())
+            {
+                err = ERR_RBUFFER_NOT_ENOUGH_DATA;
+            }
+            else
+            {
+                r.tail() = (r.tail() + n) & r.mask();
+                r.lot() -= n;
+                r.ovr() += n;
+            }
+            exit_critical();
+        }
+
+        return err;
+    }
+
+    static void clear (Ring & r)
+    {
+        enter_critical();
+        r.head() = 0;
+        r.tail() = 0;
+        r.lot() = 0;
+        r.mark() = r.ovr();
+        exit_critical();
+    }
+};
+
+} /* namespace rbuffer_core */
+
+/*****************************************************************************
+ * RingBuffer<T, N>                                                          *
+ *****************************************************************************/
+
+/**
+ * \class RingBuffer
+ * Ring buffer of N elements of type T with internal storage. Bulk
+ * operations accept up to N elements.
+ */
+template <typename T, uint16_t N>
+class RingBuffer
+{
+    static_assert((N != 0) && ((N & (N - 1)) == 0), "RingBuffer size must be a power of two");
+    static_assert(N <= 32768U, "RingBuffer size must fit the 16 bit indexes");
+    static_assert(std::is_trivially_copyable<T>::value, "RingBuffer elements are copied with memcpy");
+
+    typedef rbuffer_core::Ops<RingBuffer> ops;
+    friend struct rbuffer_core::Ops<RingBuffer>;
+
+public:
+    typedef T value_type;
+    typedef rbuffer_core::Span<T> span_type;
+
+    static constexpr uint16_t SIZE = N;
+    static constexpr uint16_t MASK = N - 1;
+
+    explicit RingBuffer (rbuffer_policy_t policy = RBUFFER_POLICY_REJECT)
+        : head_(0), tail_(0), lot_(0), policy_(policy), ovr_(0), mark_(0) {}
+
+    int add (const T & item)                            { return ops::add(*this, item); }
+    int add (const T * items, uint16_t n)               { return ops::add(*this, items, n); }
+    int get (T & item)                                  { return ops::get(*this, item); }
+    int get (T * items, uint16_t n)                     { return ops::get(*this, items, n); }
+    int reserve (uint16_t n, span_type span[RBUFFER_MAX_SPANS]) { return ops::reserve(*this, n, span); }
+    int commit (uint16_t n)                             { return ops::commit(*this, n); }
+    int peek (span_type span[RBUFFER_MAX_SPANS])        { return ops::peek(*this, span); }
+    int consume (uint16_t n)                            { return ops::consume(*this, n); }
+    int drop (uint16_t n)                               { return ops::drop(*this, n); }
+    void clear (void)                                   { ops::clear(*this); }
+
+    bool empty (void) const                             { return ops::empty(*this); }
+    bool full (void) const                              { return ops::full(*this); }
+    uint16_t free (void) const                          { return ops::free(*this); }
+    uint16_t used (void) const                          { return ops::used(*this); }
+    uint32_t overruns (void) const                      { return rbuffer_core::load(ovr_); }
+
+private:
+    T * data (void)                                     { return buf_; }
+    constexpr uint16_t size (void) const                { return N; }
+    constexpr uint16_t mask (void) const                { return MASK; }
+    uint16_t & head (void)                              { return head_; }
+    uint16_t & tail (void)                              { return tail_; }
+    uint16_t & lot (void)                               { return lot_; }
+    const uint16_t & lot (void) const                   { return lot_; }
+    rbuffer_policy_t policy (void) const                { return policy_; }
+    uint32_t & ovr (void)                               { return ovr_; }
+    uint32_t & mark (void)                              { return mark_; }
+
+    T buf_[N];
+    uint16_t head_;
+    uint16_t tail_;
+    uint16_t lot_;
+    rbuffer_policy_t policy_;
+    uint32_t ovr_;
+    uint32_t mark_;
+};
+
+#endif /* _RBUFFER_HPP */
+
+/* end of file */
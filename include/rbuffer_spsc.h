@@ -0,0 +1,208 @@
+/*****************************************************************************
+ *                                                                           *
+ * \file rbuffer_spsc.h                                                      *
+ *                                                                           *
+ * \brief Lock-free single-producer/single-consumer ring buffer module.      *
+ *                                                                           *
+ * The producer only ever writes head and the consumer only ever writes      *
+ * tail. Both indexes are free-running and published with release/acquire    *
+ * semantics, so no critical section is needed on either side. One side may  *
+ * run in an ISR and the other in the main loop.                             *
+ *                                                                           *
+ * A full buffer rejects adds: only the consumer moves tail, so the producer *
+ * can never drop the oldest data. Buffers that must keep the newest data,   *
+ * such as the sampler stage buffer (RBUFFER_POLICY_OVERWRITE under rrecord  *
+ * framing), stay on rbuffer_t.                                              *
+ *                                                                           *
+ * \author blackchacal <ribeiro.tonet@gmail.com>                             *
+ * \date Oct 17, 2026                                                        *
+ *                                                                           *
+ * \version 1.0 | \author blackchacal                                        *
+ * File creation.                                                            *
+ *                                                                           *
+ *****************************************************************************/
+
+#ifndef _RBUFFER_SPSC_H
+#define _RBUFFER_SPSC_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*****************************************************************************
+ * Includes                                                                  *
+ *****************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "suricata_config.h"
+#include "rbuffer.h"
+
+/*****************************************************************************
+ * Macros                                                                    *
+ *****************************************************************************/
+
+/**
+ * @def RBUFFER_SPSC_MAX_SIZE
+ * Largest buffer size for which the free-running 16 bit indexes can still
+ * tell a full buffer from an empty one.
+ */
+#define RBUFFER_SPSC_MAX_SIZE           (32768U)
+
+/*****************************************************************************
+ * Datatypes                                                                 *
+ *****************************************************************************/
+
+typedef struct
+{
+    uint8_t * buf;
+    uint16_t head;      /* Written by the producer only. */
+    uint16_t tail;      /* Written by the consumer only. */
+    uint16_t size;
+    uint16_t mask;
+} rbuffer_spsc_t;
+
+/*****************************************************************************
+ * Public Functions                                                          *
+ *****************************************************************************/
+
+/**
+ * @brief Initializes rbuffer_spsc struct. Must be called before producer
+ * and consumer start.
+ *
+ * @param rb
+ * @param buffer
+ * @param buf_size Power of two, up to RBUFFER_SPSC_MAX_SIZE.
+ * @return int
+ */
+int rbuffer_spsc_init (rbuffer_spsc_t * rb, uint8_t * buffer, uint16_t buf_size);
+
+/**
+ * @brief Adds one byte to rbuffer_spsc. Producer side only.
+ *
+ * @param rb
+ * @param byte
+ * @return int
+ */
+int rbuffer_spsc_add_byte (rbuffer_spsc_t * rb, uint8_t byte);
+
+/**
+ * @brief Adds several bytes to rbuffer_spsc. Producer side only.
+ *
+ * @param rb
+ * @param data
+ * @param nbytes
+ * @return int
+ */
+int rbuffer_spsc_add_bytes (rbuffer_spsc_t * rb, const uint8_t * data, uint16_t nbytes);
+
+/**
+ * @brief Gets one byte from rbuffer_spsc. Consumer side only.
+ *
+ * @param rb
+ * @param byte
+ * @return int
+ */
+int rbuffer_spsc_get_byte (rbuffer_spsc_t * rb, uint8_t * byte);
+
+/**
+ * @brief Gets several bytes from rbuffer_spsc. Consumer side only.
+ *
+ * @param rb
+ * @param data
+ * @param nbytes
+ * @return int
+ */
+int rbuffer_spsc_get_bytes (rbuffer_spsc_t * rb, uint8_t * data, uint16_t nbytes);
+
+/**
+ * @brief Reserves nbytes of free space for in-place writing. Producer side
+ * only. The data becomes visible to the consumer on rbuffer_spsc_commit.
+ *
+ * @param rb
+ * @param nbytes
+ * @param span Filled with up to RBUFFER_MAX_SPANS regions of nbytes total.
+ * @return int
+ */
+int rbuffer_spsc_reserve (rbuffer_spsc_t * rb, uint16_t nbytes, rbuffer_span_t span[RBUFFER_MAX_SPANS]);
+
+/**
+ * @brief Publishes nbytes previously written through rbuffer_spsc_reserve.
+ * Producer side only.
+ *
+ * @param rb
+ * @param nbytes
+ * @return int
+ */
+int rbuffer_spsc_commit (rbuffer_spsc_t * rb, uint16_t nbytes);
+
+/**
+ * @brief Exposes all readable data in place without removing it. Consumer
+ * side only.
+ *
+ * @param rb
+ * @param span Filled with up to RBUFFER_MAX_SPANS regions, oldest first.
+ * @return int
+ */
+int rbuffer_spsc_peek (const rbuffer_spsc_t * rb, rbuffer_span_t span[RBUFFER_MAX_SPANS]);
+
+/**
+ * @brief Removes nbytes of data, typically after rbuffer_spsc_peek.
+ * Consumer side only.
+ *
+ * @param rb
+ * @param nbytes
+ * @return int
+ */
+int rbuffer_spsc_consume (rbuffer_spsc_t * rb, uint16_t nbytes);
+
+/**
+ * @brief Check if rbuffer_spsc is empty.
+ *
+ * @param rb
+ * @return true
+ * @return false
+ */
+bool rbuffer_spsc_empty (const rbuffer_spsc_t * rb);
+
+/**
+ * @brief Checks if rbuffer_spsc is full.
+ *
+ * @param rb
+ * @return true
+ * @return false
+ */
+bool rbuffer_spsc_full (const rbuffer_spsc_t * rb);
+
+/**
+ * @brief Returns rbuffer_spsc free space.
+ *
+ * @param rb
+ * @return uint16_t
+ */
+uint16_t rbuffer_spsc_free (const rbuffer_spsc_t * rb);
+
+/**
+ * @brief Returns rbuffer_spsc used space.
+ *
+ * @param rb
+ * @return uint16_t
+ */
+uint16_t rbuffer_spsc_used (const rbuffer_spsc_t * rb);
+
+/**
+ * @brief Discards all pending data. Consumer side only.
+ *
+ * @param rb
+ * @return int
+ */
+int rbuffer_spsc_clear (rbuffer_spsc_t * rb);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _RBUFFER_SPSC_H */
+
+/* end of file */
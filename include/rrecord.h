@@ -0,0 +1,133 @@
+/*****************************************************************************
+ *                                                                           *
+ * \file rrecord.h                                                           *
+ *                                                                           *
+ * \brief Variable-length record framing on top of rbuffer.                  *
+ *                                                                           *
+ * Each record is stored as a 16 bit little-endian length followed by the    *
+ * payload, always contiguous in the rbuffer storage. When a record does     *
+ * not fit before the end of the storage, the remaining bytes are skipped:   *
+ * a RRECORD_SKIP header marks them, or, if fewer than RRECORD_HDR_SIZE      *
+ * bytes remain, they are implicit padding. Records are pushed and popped    *
+ * whole, so a consumer never sees a partial reading.                        *
+ *                                                                           *
+ * \author blackchacal <ribeiro.tonet@gmail.com>                             *
+ * \date Oct 17, 2026                                                        *
+ *                                                                           *
+ * \version 1.0 | \author blackchacal                                        *
+ * File creation.                                                            *
+ *                                                                           *
+ *****************************************************************************/
+
+#ifndef _RRECORD_H
+#define _RRECORD_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*****************************************************************************
+ * Includes                                                                  *
+ *****************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "suricata_config.h"
+#include "rbuffer.h"
+
+/*****************************************************************************
+ * Macros                                                                    *
+ *****************************************************************************/
+
+/* --- Error codes ----------------------------------------------------------*/
+
+#define ERR_RRECORD_TOO_LARGE           (-20)
+#define ERR_RRECORD_BUFFER_TOO_SMALL    (-21)
+#define ERR_RRECORD_CORRUPT             (-22)
+
+/* --- Framing --------------------------------------------------------------*/
+
+#define RRECORD_HDR_SIZE                (2)
+#define RRECORD_SKIP                    (0xFFFF)
+
+/**
+ * @def RRECORD_MAX_LEN
+ * Largest payload a rbuffer of size bytes accepts. Keeping records to half
+ * the storage guarantees an empty rbuffer always has room for one,
+ * wherever head happens to be.
+ */
+#define RRECORD_MAX_LEN(size)           ((uint16_t)(((size) / 2) - RRECORD_HDR_SIZE))
+
+/*****************************************************************************
+ * Datatypes                                                                 *
+ *****************************************************************************/
+
+/**
+ * \struct rrecord_t
+ * View of one record payload inside the rbuffer storage.
+ */
+typedef struct
+{
+    uint8_t * data;
+    uint16_t len;
+} rrecord_t;
+
+/*****************************************************************************
+ * Public Functions                                                          *
+ *****************************************************************************/
+
+/**
+ * @brief Pushes one record. On RBUFFER_POLICY_OVERWRITE buffers the oldest
+ * whole records are dropped to make room; the producer must then not be
+ * preempted by the consumer (e.g. ISR producer, main loop consumer).
+ *
+ * @param rb
+ * @param data
+ * @param len 1 to RRECORD_MAX_LEN(rb->size) bytes.
+ * @return int
+ */
+int rrecord_push (rbuffer_t * rb, const uint8_t * data, uint16_t len);
+
+/**
+ * @brief Pops the oldest record into data.
+ *
+ * @param rb
+ * @param data
+ * @param max_len Size of data. The record is left in place if it is larger.
+ * @param len Record length.
+ * @return int
+ */
+int rrecord_pop (rbuffer_t * rb, uint8_t * data, uint16_t max_len, uint16_t * len);
+
+/**
+ * @brief Exposes up to max_recs of the oldest records in place. Release
+ * them with rrecord_consume(rb, *nbytes).
+ *
+ * @param rb
+ * @param recs
+ * @param max_recs
+ * @param count Number of records returned.
+ * @param nbytes rbuffer bytes spanned by the returned records.
+ * @return int
+ */
+int rrecord_peek_batch (rbuffer_t * rb, rrecord_t * recs, uint16_t max_recs,
+                        uint16_t * count, uint16_t * nbytes);
+
+/**
+ * @brief Releases the records returned by rrecord_peek_batch. Returns
+ * ERR_RBUFFER_OVERRUN if the producer dropped them meanwhile; peek again.
+ *
+ * @param rb
+ * @param nbytes
+ * @return int
+ */
+int rrecord_consume (rbuffer_t * rb, uint16_t nbytes);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _RRECORD_H */
+
+/* end of file */
@@ -0,0 +1,208 @@
+/*****************************************************************************
+ *                                                                           *
+ * \file sampler.h                                                           *
+ *                                                                           *
+ * \brief Timer-interrupt-driven sensor sampling into a record rbuffer.      *
+ *                                                                           *
+ * A hardware timer (TC3 on the SAMD21, the simulated timer on native) runs  *
+ * the sampling ISR at a fixed rate. Each tick reads the sensor through a    *
+ * callback and pushes one timestamped record with rrecord_push, so sample   *
+ * timing does not depend on what loop() is doing. The main context takes   *
+ * the records back in batches with sampler_consume. Sensors read outside   *
+ * the ISR add their results to the same stream with sampler_push.          *
+ *                                                                           *
+ * Record layout, native byte order (records never leave the device):       *
+ *   ts_us (4) | seq (2) | src (1) | count (1) | value[count] (4 each)       *
+ * seq counts records of every source plus failed timer reads, so gaps show *
+ * samples lost to a full rbuffer or to a failed read.                       *
+ *                                                                           *
+ * \author blackchacal <ribeiro.tonet@gmail.com>                             *
+ * \date Oct 17, 2026                                                        *
+ *                                                                           *
+ * \version 1.0 | \author blackchacal                                        *
+ * File creation.                                                            *
+ *                                                                           *
+ *****************************************************************************/
+
+#ifndef _SAMPLER_H
+#define _SAMPLER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*****************************************************************************
+ * Includes                                                                  *
+ *****************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "suricata_config.h"
+#include "rbuffer.h"
+
+/*****************************************************************************
+ * Configuration Macros                                                      *
+ *****************************************************************************/
+
+/**
+ * @def SAMPLER_RATE_HZ
+ * Default sampling rate.
+ */
+#ifndef SAMPLER_RATE_HZ
+#define SAMPLER_RATE_HZ         10
+#endif
+
+/**
+ * @def SAMPLER_MAX_VALUES
+ * Values one sensor read may return.
+ */
+#ifndef SAMPLER_MAX_VALUES
+#define SAMPLER_MAX_VALUES      4
+#endif
+
+/**
+ * @def SAMPLER_BATCH
+ * Samples handed to the batch callback at once.
+ */
+#ifndef SAMPLER_BATCH
+#define SAMPLER_BATCH           8
+#endif
+
+/**
+ * @def SAMPLER_BATCH_PERIOD_US
+ * Period of the batch consumer task run from main.
+ */
+#ifndef SAMPLER_BATCH_PERIOD_US
+#define SAMPLER_BATCH_PERIOD_US 100000UL
+#endif
+
+/*****************************************************************************
+ * Macros                                                                    *
+ *****************************************************************************/
+
+/* --- Error codes ----------------------------------------------------------*/
+
+#ifndef ERR_OK
+#define ERR_OK                          (0)
+#endif
+#define ERR_SAMPLER_NULL_POINTER        (-40)
+#define ERR_SAMPLER_INVALID_RATE        (-41)
+#define ERR_SAMPLER_NOT_INIT            (-42)
+#define ERR_SAMPLER_TIMER               (-43)
+#define ERR_SAMPLER_INVALID_COUNT       (-44)
+
+/* --- Record ---------------------------------------------------------------*/
+
+#define SAMPLER_SRC_TIMER               (0)
+
+#define SAMPLER_REC_HDR_SIZE            (8)
+#define SAMPLER_REC_MAX_SIZE            (SAMPLER_REC_HDR_SIZE + 4 * SAMPLER_MAX_VALUES)
+
+/*****************************************************************************
+ * Datatypes                                                                 *
+ *****************************************************************************/
+
+/**
+ * @brief Sensor read, called from the sampling ISR: it must not block for
+ * long nor log through a path that waits for loop(). Fills up to max
+ * values and returns how many, 0 if there is no reading this tick.
+ */
+typedef uint8_t (*sampler_read_t) (int32_t * values, uint8_t max);
+
+/**
+ * \struct sampler_sample_t
+ * One decoded sample.
+ */
+typedef struct
+{
+    uint32_t ts_us;             /* micros() when the timer fired. */
+    uint16_t seq;
+    uint8_t src;                /* SAMPLER_SRC_TIMER or the pushing sensor. */
+    uint8_t count;
+    int32_t value[SAMPLER_MAX_VALUES];
+} sampler_sample_t;
+
+/**
+ * @brief Batch consumer, called from the main context with samples oldest
+ * first.
+ */
+typedef void (*sampler_batch_t) (const sampler_sample_t * samples, uint16_t count);
+
+/**
+ * \struct sampler_stats_t
+ * Pipeline counters.
+ */
+typedef struct
+{
+    uint32_t ticks;             /* Timer interrupts. */
+    uint32_t pushed;            /* Records pushed. */
+    uint32_t failed;            /* Reads without data or pushes that failed. */
+    uint32_t consumed;          /* Samples handed to the batch callback. */
+    uint32_t lost;              /* seq gaps seen by the consumer. */
+    uint32_t resyncs;           /* Framing lost, the rbuffer emptied to recover. */
+} sampler_stats_t;
+
+/*****************************************************************************
+ * Public Functions                                                          *
+ *****************************************************************************/
+
+/**
+ * @brief Sets the destination rbuffer and the sensor read. The rbuffer
+ * should use RBUFFER_POLICY_OVERWRITE, so a slow consumer loses the oldest
+ * samples rather than the newest.
+ *
+ * @param rb
+ * @param read
+ * @return int
+ */
+int sampler_init (rbuffer_t * rb, sampler_read_t read);
+
+/**
+ * @brief Starts the sampling timer.
+ *
+ * @param rate_hz 1 Hz to 10 kHz.
+ * @return int ERR_OK, ERR_SAMPLER_NOT_INIT, ERR_SAMPLER_INVALID_RATE or
+ * ERR_SAMPLER_TIMER.
+ */
+int sampler_start (uint32_t rate_hz);
+
+/**
+ * @brief Stops the sampling timer. Queued records stay available.
+ */
+void sampler_stop (void);
+
+/**
+ * @brief Adds one sample from the main context, timestamped now. Interrupts
+ * are masked around the push so it never interleaves with the timer ISR.
+ *
+ * @param src Source id, other than SAMPLER_SRC_TIMER.
+ * @param values
+ * @param count 1 to SAMPLER_MAX_VALUES.
+ * @return int
+ */
+int sampler_push (uint8_t src, const int32_t * values, uint8_t count);
+
+/**
+ * @brief Hands the queued samples to fn, up to SAMPLER_BATCH at a time.
+ * Records are released only after they have been copied out safely, so a
+ * batch is never torn by the ISR overwriting it.
+ *
+ * @param fn
+ * @param max Records to take at most in this call.
+ * @return uint16_t Records taken from the rbuffer.
+ */
+uint16_t sampler_consume (sampler_batch_t fn, uint16_t max);
+
+/**
+ * @brief Copies the pipeline counters.
+ */
+void sampler_stats (sampler_stats_t * stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _SAMPLER_H */
+
+/* end of file */
@@ -0,0 +1,157 @@
+/*****************************************************************************
+ *                                                                           *
+ * \file sched.h                                                             *
+ *                                                                           *
+ * \brief Cooperative deadline scheduler driven from loop().                 *
+ *                                                                           *
+ * Tasks are plain functions, run to completion from sched_run(). Pending    *
+ * tasks sit in a binary min-heap ordered by deadline, so the next task is   *
+ * found in O(1) and rescheduled in O(log n). Deadlines are in micros() and  *
+ * survive its wrap around.                                                  *
+ *                                                                           *
+ * A periodic task is rescheduled relative to its previous deadline, not to  *
+ * when it actually ran, so its cadence does not drift. If it falls a whole  *
+ * period or more behind, the missed periods are skipped and counted as      *
+ * overruns instead of being run back to back.                               *
+ *                                                                           *
+ * \author blackchacal <ribeiro.tonet@gmail.com>                             *
+ * \date Oct 17, 2026                                                        *
+ *                                                                           *
+ * \version 1.0 | \author blackchacal                                        *
+ * File creation.                                                            *
+ *                                                                           *
+ *****************************************************************************/
+
+#ifndef _SCHED_H
+#define _SCHED_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*****************************************************************************
+ * Includes                                                                  *
+ *****************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "suricata_config.h"
+
+/*****************************************************************************
+ * Configuration Macros                                                      *
+ *****************************************************************************/
+
+/**
+ * @def SCHED_MAX_TASKS
+ * Tasks that can be registered at once. At most 255.
+ */
+#ifndef SCHED_MAX_TASKS
+#define SCHED_MAX_TASKS     8
+#endif
+
+/**
+ * @def SCHED_REPORT_PERIOD_US
+ * Period of the task accounting report run from main.
+ */
+#ifndef SCHED_REPORT_PERIOD_US
+#define SCHED_REPORT_PERIOD_US  10000000UL
+#endif
+
+/*****************************************************************************
+ * Macros                                                                    *
+ *****************************************************************************/
+
+/* --- Error codes ----------------------------------------------------------*/
+
+#ifndef ERR_OK
+#define ERR_OK                          (0)
+#endif
+#define ERR_SCHED_NULL_POINTER          (-30)
+#define ERR_SCHED_FULL                  (-31)
+#define ERR_SCHED_INVALID_TASK          (-32)
+
+/*****************************************************************************
+ * Datatypes                                                                 *
+ *****************************************************************************/
+
+typedef void (*sched_fn_t) (void * arg);
+
+/**
+ * \struct sched_stats_t
+ * Run-time accounting of one task. Times in microseconds.
+ */
+typedef struct
+{
+    uint32_t runs;
+    uint32_t overruns;          /* Periods skipped because the task was late. */
+    uint32_t run_last;
+    uint32_t run_max;
+    uint64_t run_total;
+    uint32_t late_max;          /* Worst start time past the deadline. */
+} sched_stats_t;
+
+/*****************************************************************************
+ * Public Functions                                                          *
+ *****************************************************************************/
+
+/**
+ * @brief Removes every task.
+ */
+void sched_init (void);
+
+/**
+ * @brief Registers a task. May be called from a running task, but not into
+ * that task's slot: a one-shot re-adding itself takes another one.
+ *
+ * @param name Shown in reports, must stay valid (a literal).
+ * @param fn Task function, called with arg.
+ * @param period_us Period of a periodic task, 0 for a one-shot task.
+ * @param delay_us Time from now to the first run.
+ * @param id Optional, receives the task id.
+ * @return int ERR_OK, ERR_SCHED_NULL_POINTER or ERR_SCHED_FULL.
+ */
+int sched_add (const char * name, sched_fn_t fn, void * arg, uint32_t period_us,
+               uint32_t delay_us, uint8_t * id);
+
+/**
+ * @brief Unregisters a task. A one-shot task unregisters itself once run.
+ */
+int sched_cancel (uint8_t id);
+
+/**
+ * @brief Changes the period of a task. The next deadline is kept.
+ */
+int sched_set_period (uint8_t id, uint32_t period_us);
+
+/**
+ * @brief Runs every task whose deadline has passed, earliest first. Call it
+ * from loop().
+ *
+ * @return uint8_t Number of tasks run.
+ */
+uint8_t sched_run (void);
+
+/**
+ * @brief Returns the microseconds until the next deadline, 0 if one is due
+ * and UINT32_MAX if there is no task.
+ */
+uint32_t sched_idle_us (void);
+
+/**
+ * @brief Copies the accounting of a task.
+ */
+int sched_stats (uint8_t id, sched_stats_t * stats);
+
+/**
+ * @brief Logs one line of accounting per task and resets the maxima.
+ */
+void sched_report (void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _SCHED_H */
+
+/* end of file */
@@ -0,0 +1,185 @@
+/*****************************************************************************
+ *                                                                           *
+ * \file sensor.h                                                            *
+ *                                                                           *
+ * \brief Asynchronous sensor drivers as state machines.                     *
+ *                                                                           *
+ * A driver is a step function that advances its sensor by one state and     *
+ * says what to wait for next: a bus transfer (sensor_xfer) or a time        *
+ * (sensor_sleep), such as a conversion in progress. sensor_poll, run        *
+ * periodically from loop(), steps every sensor whose wait is over, so no    *
+ * driver ever blocks and sensors on the same bus overlap their conversions. *
+ * Readings go to the sample stream with sampler_push, tagged with the       *
+ * sensor's source id.                                                       *
+ *                                                                           *
+ * \author blackchacal <ribeiro.tonet@gmail.com>                             *
+ * \date Oct 17, 2026                                                        *
+ *                                                                           *
+ * \version 1.0 | \author blackchacal                                        *
+ * File creation.                                                            *
+ *                                                                           *
+ *****************************************************************************/
+
+#ifndef _SENSOR_H
+#define _SENSOR_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*****************************************************************************
+ * Includes                                                                  *
+ *****************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "suricata_config.h"
+#include "i2c_bus.h"
+#include "sampler.h"
+
+/*****************************************************************************
+ * Configuration Macros                                                      *
+ *****************************************************************************/
+
+/**
+ * @def SENSOR_POLL_PERIOD_US
+ * Period of the sensor_poll task run from main.
+ */
+#ifndef SENSOR_POLL_PERIOD_US
+#define SENSOR_POLL_PERIOD_US   2000UL
+#endif
+
+/**
+ * @def SENSOR_BUF_SIZE
+ * Size of each sensor's transfer buffers.
+ */
+#ifndef SENSOR_BUF_SIZE
+#define SENSOR_BUF_SIZE         8
+#endif
+
+/*****************************************************************************
+ * Macros                                                                    *
+ *****************************************************************************/
+
+/* --- Error codes ----------------------------------------------------------*/
+
+#ifndef ERR_OK
+#define ERR_OK                          (0)
+#endif
+#define ERR_SENSOR_NULL_POINTER         (-60)
+#define ERR_SENSOR_INVALID_SIZE         (-61)
+#define ERR_SENSOR_CRC                  (-62)
+
+/*****************************************************************************
+ * Datatypes                                                                 *
+ *****************************************************************************/
+
+typedef struct sensor_s sensor_t;
+
+/**
+ * \struct sensor_driver_t
+ * A sensor type. step runs in the main context and must end by calling
+ * sensor_xfer or sensor_sleep; a step that does neither runs again on the
+ * next poll.
+ */
+typedef struct
+{
+    const char * name;
+    void (*step) (sensor_t * sensor);
+} sensor_driver_t;
+
+/**
+ * \struct sensor_t
+ * One sensor instance. The driver owns state and the buffers; the
+ * framework owns the rest.
+ */
+struct sensor_s
+{
+    const sensor_driver_t * drv;
+    uint8_t addr;
+    uint8_t src;                /* Source id of its samples. */
+    uint32_t period_us;         /* Time between readings. */
+
+    uint8_t state;
+    bool waiting;               /* Waiting for xfer rather than for wake. */
+    uint32_t wake;
+    uint32_t start;             /* Start of the current reading. */
+    i2c_xfer_t xfer;
+    uint8_t tx[SENSOR_BUF_SIZE];
+    uint8_t rx[SENSOR_BUF_SIZE];
+
+    int32_t value[SAMPLER_MAX_VALUES];
+    uint8_t count;
+    uint32_t reads;
+    uint32_t errors;
+    int last_err;
+
+    sensor_t * next;
+};
+
+/*****************************************************************************
+ * Public Functions                                                          *
+ *****************************************************************************/
+
+/**
+ * @brief Registers a sensor; its first step runs on the next poll.
+ *
+ * @param sensor
+ * @param drv
+ * @param addr Bus address.
+ * @param src Source id for sampler_push.
+ * @param period_us Time between readings.
+ * @return int
+ */
+int sensor_add (sensor_t * sensor, const sensor_driver_t * drv, uint8_t addr, uint8_t src,
+                uint32_t period_us);
+
+/**
+ * @brief Steps every sensor whose transfer completed or whose wake time
+ * passed. Call it periodically from the main context.
+ */
+void sensor_poll (void);
+
+/**
+ * @brief Logs one line per sensor with its last reading and counters.
+ */
+void sensor_report (void);
+
+/* --- For drivers ----------------------------------------------------------*/
+
+/**
+ * @brief Starts a transfer of tx_len bytes from sensor->tx, then rx_len
+ * bytes into sensor->rx. The next step runs once it completes, with the
+ * result in sensor->xfer.result.
+ */
+int sensor_xfer (sensor_t * sensor, uint8_t tx_len, uint8_t rx_len);
+
+/**
+ * @brief Runs the next step in us microseconds.
+ */
+void sensor_sleep (sensor_t * sensor, uint32_t us);
+
+/**
+ * @brief Runs the next step at the start of the next period, counted from
+ * the start of this reading.
+ */
+void sensor_sleep_period (sensor_t * sensor);
+
+/**
+ * @brief Stores a reading and pushes it to the sample stream.
+ */
+int sensor_publish (sensor_t * sensor, const int32_t * values, uint8_t count);
+
+/**
+ * @brief Counts a failed reading.
+ */
+void sensor_fail (sensor_t * sensor, int err);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _SENSOR_H */
+
+/* end of file */
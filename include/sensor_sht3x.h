@@ -0,0 +1,55 @@
+/*****************************************************************************
+ *                                                                           *
+ * \file sensor_sht3x.h                                                      *
+ *                                                                           *
+ * \brief Sensirion SHT3x temperature and humidity driver.                   *
+ *                                                                           *
+ * Single-shot, high repeatability, no clock stretching: the conversion      *
+ * runs while the bus serves other sensors. Samples carry two values,        *
+ * temperature in centi-degrees Celsius and relative humidity in            *
+ * centi-percent.                                                            *
+ *                                                                           *
+ * \author blackchacal <ribeiro.tonet@gmail.com>                             *
+ * \date Oct 17, 2026                                                        *
+ *                                                                           *
+ * \version 1.0 | \author blackchacal                                        *
+ * File creation.                                                            *
+ *                                                                           *
+ *****************************************************************************/
+
+#ifndef _SENSOR_SHT3X_H
+#define _SENSOR_SHT3X_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*****************************************************************************
+ * Includes                                                                  *
+ *****************************************************************************/
+
+#include "sensor.h"
+
+/*****************************************************************************
+ * Macros                                                                    *
+ *****************************************************************************/
+
+#define SHT3X_ADDR_A                    (0x44)
+#define SHT3X_ADDR_B                    (0x45)
+
+/* Worst-case high repeatability conversion time. */
+#define SHT3X_CONVERSION_US             (15500UL)
+
+/*****************************************************************************
+ * Public Variables                                                          *
+ *****************************************************************************/
+
+extern const sensor_driver_t sensor_sht3x;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _SENSOR_SHT3X_H */
+
+/* end of file */
@@ -0,0 +1,196 @@
+/*****************************************************************************
+ *                                                                           *
+ * \file store.h                                                             *
+ *                                                                           *
+ * \brief Log-structured record store in flash, backing a record rbuffer.    *
+ *                                                                           *
+ * The flash region (see flash.h) is split into sectors of                   *
+ * STORE_SECTOR_SIZE bytes used as a circular, append-only log. Records are  *
+ * packed back to back into a RAM page and written a whole flash page at a   *
+ * time. Sectors are taken in turn, so every sector is erased once per lap   *
+ * of the log; that round robin is the wear leveling.                        *
+ *                                                                           *
+ * Sector, little-endian:                                                    *
+ *   magic "SUST" (4) | seq (4) | erases (4) | crc16 (2) | 0xFFFF (2)        *
+ *   entries { len (2) | crc16 (2) | record (len) }                          *
+ * The crc16 (CRC-16/CCITT-FALSE) of an entry covers len and record. len     *
+ * 0xFFFF is padding up to the next page. seq grows with each new sector.    *
+ *                                                                           *
+ * After a reset the sectors are scanned: the oldest seq is read first, the  *
+ * newest is appended to. An entry torn by the reset fails its crc and ends  *
+ * its sector. Sectors are erased once read, so a reset resends at most one  *
+ * sector. Records in the RAM page, or already moved back to the rbuffer,    *
+ * are lost.                                                                 *
+ *                                                                           *
+ * store_poll moves the oldest records of the rbuffer to flash when it is    *
+ * 3/4 full (the uplink is not keeping up), and back once it is under 1/4.   *
+ * While records wait in flash, store_push queues new records behind them,   *
+ * so they still leave the device in order. When the flash is full the       *
+ * oldest sector is dropped.                                                 *
+ *                                                                           *
+ * \author blackchacal <ribeiro.tonet@gmail.com>                             *
+ * \date Oct 17, 2026                                                        *
+ *                                                                           *
+ * \version 1.0 | \author blackchacal                                        *
+ * File creation.                                                            *
+ *                                                                           *
+ *****************************************************************************/
+
+#ifndef _STORE_H
+#define _STORE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*****************************************************************************
+ * Includes                                                                  *
+ *****************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "suricata_config.h"
+#include "rbuffer.h"
+#include "flash.h"
+
+/*****************************************************************************
+ * Configuration Macros                                                      *
+ *****************************************************************************/
+
+/**
+ * @def STORE_SECTOR_SIZE
+ * Sector size, a multiple of FLASH_ERASE_SIZE.
+ */
+#ifndef STORE_SECTOR_SIZE
+#define STORE_SECTOR_SIZE       1024
+#endif
+
+/**
+ * @def STORE_POLL_PERIOD_US
+ * Period of the store_poll task run from main.
+ */
+#ifndef STORE_POLL_PERIOD_US
+#define STORE_POLL_PERIOD_US    250000UL
+#endif
+
+/**
+ * @def STORE_BURST
+ * Record bytes moved per store_poll at most, bounding the time spent
+ * waiting on the flash.
+ */
+#ifndef STORE_BURST
+#define STORE_BURST             1024
+#endif
+
+/*****************************************************************************
+ * Macros                                                                    *
+ *****************************************************************************/
+
+/* --- Error codes ----------------------------------------------------------*/
+
+#ifndef ERR_OK
+#define ERR_OK                          (0)
+#endif
+#define ERR_STORE_NULL_POINTER          (-100)
+#define ERR_STORE_NOT_INIT              (-101)
+#define ERR_STORE_TOO_LARGE             (-102)
+#define ERR_STORE_EMPTY                 (-103)
+
+/* --- Layout ---------------------------------------------------------------*/
+
+#define STORE_SECTORS                   (FLASH_STORE_SIZE / STORE_SECTOR_SIZE)
+#define STORE_HDR_SIZE                  (16)
+#define STORE_ENTRY_HDR_SIZE            (4)
+#define STORE_ENTRY_MAX                 (255)
+
+#if ((STORE_SECTOR_SIZE % FLASH_ERASE_SIZE) != 0) || (STORE_SECTORS < 2)
+#error "STORE_SECTOR_SIZE must be a multiple of FLASH_ERASE_SIZE, with 2 sectors at least"
+#endif
+
+/*****************************************************************************
+ * Datatypes                                                                 *
+ *****************************************************************************/
+
+/**
+ * \struct store_stats_t
+ * Store counters.
+ */
+typedef struct
+{
+    uint32_t spilled;           /* Records written to flash. */
+    uint32_t drained;           /* Records moved back to the rbuffer. */
+    uint32_t dropped;           /* Sectors overwritten, unread, while full. */
+    uint32_t corrupt;           /* Sectors cut short by a bad entry. */
+    uint32_t failed;            /* Flash errors; the store is then off. */
+    uint16_t used;              /* Sectors holding records. */
+    uint32_t wear_min;          /* Fewest and most erases of a sector. */
+    uint32_t wear_max;
+} store_stats_t;
+
+/*****************************************************************************
+ * Public Functions                                                          *
+ *****************************************************************************/
+
+/**
+ * @brief Mounts the store, recovering what the flash holds, and sets the
+ * rbuffer it backs. If the flash fails, store_push still feeds the
+ * rbuffer.
+ *
+ * @param rb A rrecord rbuffer.
+ * @return int
+ */
+int store_init (rbuffer_t * rb);
+
+/**
+ * @brief Queues one record: in the rbuffer, or behind the records waiting
+ * in flash.
+ *
+ * @param data
+ * @param len 1 to STORE_ENTRY_MAX bytes.
+ * @return int
+ */
+int store_push (const uint8_t * data, uint16_t len);
+
+/**
+ * @brief Moves records between the rbuffer and flash. Call it periodically
+ * from the main context, the same as the rbuffer's consumer.
+ */
+void store_poll (void);
+
+/**
+ * @brief Appends one record to the flash log.
+ *
+ * @param data
+ * @param len 1 to STORE_ENTRY_MAX bytes.
+ * @return int
+ */
+int store_append (const uint8_t * data, uint16_t len);
+
+/**
+ * @brief Reads the oldest record of the flash log and removes it.
+ *
+ * @param data
+ * @param max_len Size of data.
+ * @param len Record length.
+ * @return int ERR_OK, ERR_STORE_EMPTY or a flash error.
+ */
+int store_read (uint8_t * data, uint16_t max_len, uint16_t * len);
+
+/**
+ * @brief True while records wait in flash.
+ */
+bool store_pending (void);
+
+/**
+ * @brief Copies the store counters.
+ */
+void store_stats (store_stats_t * stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _STORE_H */
+
+/* end of file */
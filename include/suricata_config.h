@@ -36,14 +36,35 @@ extern "C" {
 
 /**
  * @def DATA_BUFFER_SIZE
- * Defines the size of the general data buffer.
+ * Defines the size of the general data buffer, a power of two. It holds
+ * the compressed sample blocks while they wait for the uplink.
  */
-#define DATA_BUFFER_SIZE        (256)
+#define DATA_BUFFER_SIZE        (4096)
+
+/**
+ * @def STAGE_BUFFER_SIZE
+ * Size of the staging buffer, a power of two. It holds the raw sample
+ * records between the sampler and the encoder, one batch period's worth.
+ */
+#define STAGE_BUFFER_SIZE       (512)
+
+/**
+ * @def RECORD_POOL_BLOCKS
+ * Blocks of record_pool, the TSC_BLOCK_SIZE buffers the encoder fills. One
+ * is open in the encoder; filled ones wait for the store task, which
+ * queues them and frees them. With none free, samples are lost.
+ */
+#define RECORD_POOL_BLOCKS      (2)
 
 /*****************************************************************************
  * Configuration Macros                                                      *
  *****************************************************************************/
 
+/* --- Ring Buffer Module -------------------------------------------------- */
+
+// #define RBUFFER_STATS_EN          0
+// #define RBUFFER_STATS_BUCKETS     20
+
 /* --- Logger Module ------------------------------------------------------- */ 
 
 #define LOGGER_EN                 1
@@ -51,8 +72,98 @@ extern "C" {
 // #define LOG_WARN_EN               1
 // #define LOG_DEBUG_EN              1
 // #define LOG_ERROR_EN              1
-// #define SERIAL_SPEED              9600
+// #define SERIAL_SPEED              115200
 // #define MAX_LOG_MSG_SIZE          512
+#define LOG_DEFERRED_EN           1
+#define LOG_BUFFER_SIZE           2048
+// #define LOG_BINARY_EN             0
+// #define LOG_TAG_SLOTS             16
+// #define LOG_ISR_SLOTS             8
+// #define LOG_ISR_MAX_ARGS          6
+
+/* --- Log Sinks ----------------------------------------------------------- */
+
+// #define LOG_SERIAL_LEVEL          LOG_LEVEL_DEBUG
+// #define LOG_SERIAL_BATCH          256
+// #define LOG_SERIAL_DELAY_US       20000UL
+// #define LOG_RAM_EN                0
+// #define LOG_RAM_SIZE              1024
+// #define LOG_RAM_LEVEL             LOG_LEVEL_WARN
+// #define LOG_UDP_EN                0
+// #define LOG_UDP_HOST              "192.168.1.10"
+// #define LOG_UDP_PORT              47001
+// #define LOG_UDP_LEVEL             LOG_LEVEL_INFO
+// #define LOG_UDP_DATAGRAM          512
+// #define LOG_UDP_BUFFER_SIZE       1024
+// #define LOG_UDP_DELAY_US          1000000UL
+// #define LOG_FILE_EN               0
+// #define LOG_FILE_PATH             "suricata.log"
+// #define LOG_FILE_LEVEL            LOG_LEVEL_DEBUG
+// #define LOG_FILE_BUFFER_SIZE      1024
+// #define LOG_FLUSH_TIMEOUT_US      100000UL
+
+/* --- Boot Module --------------------------------------------------------- */
+
+// #define BOOT_SERIAL_WAIT_MS       3000UL
+// #define BOOT_MAX_STAGES           10
+
+/* --- Scheduler Module ---------------------------------------------------- */
+
+// #define SCHED_MAX_TASKS           8
+// #define SCHED_REPORT_PERIOD_US    10000000UL
+
+/* --- Profiling Module --------------------------------------------------- */
+
+// #define PROF_MAX_ZONES            16
+
+/* --- RAM Budget Module --------------------------------------------------- */
+
+// #define MEMINFO_MAX_BUFFERS       16
+// #define MEMINFO_GAP_WARN          1024
+
+/* --- Sampler Module ------------------------------------------------------ */
+
+// #define SAMPLER_RATE_HZ           10
+// #define SAMPLER_MAX_VALUES        4
+// #define SAMPLER_BATCH             8
+// #define SAMPLER_BATCH_PERIOD_US   100000UL
+
+/* --- Sensor Modules ------------------------------------------------------ */
+
+// #define I2C_BUS_CLOCK_HZ          100000UL
+// #define I2C_MOCK_DEVICES          4
+// #define SENSOR_POLL_PERIOD_US     2000UL
+// #define SENSOR_BUF_SIZE           8
+
+/* --- Time-series Codec Module ------------------------------------------- */
+
+// #define TSC_BLOCK_SIZE            240
+// #define TSC_BLOCK_MAX_US          1000000UL
+
+/* --- Aggregation Module -------------------------------------------------- */
+
+// #define AGG_MAX_PANES             6
+// #define AGG_WINDOW_US             60000000UL
+// #define AGG_HOP_US                10000000UL
+
+/* --- Flash Store Module -------------------------------------------------- */
+
+// #define FLASH_STORE_SIZE          32768UL
+// #define FLASH_SIM_FILE            "suricata_flash.bin"
+// #define STORE_SECTOR_SIZE         1024
+// #define STORE_POLL_PERIOD_US      250000UL
+// #define STORE_BURST               1024
+
+/* --- Uplink Module ------------------------------------------------------- */
+
+// #define UPLINK_HOST               "192.168.1.10"
+// #define UPLINK_PORT               47000
+// #define UPLINK_WIFI_SSID          "network"
+// #define UPLINK_WIFI_PASS          "passphrase"
+// #define UPLINK_FRAME_SIZE         1024
+// #define UPLINK_MAX_DELAY_US       2000000UL
+// #define UPLINK_POLL_PERIOD_US     100000UL
+// #define UPLINK_RETRY_US           10000000UL
 
 
 #ifdef __cplusplus
@@ -0,0 +1,195 @@
+/*****************************************************************************
+ *                                                                           *
+ * \file tscodec.h                                                           *
+ *                                                                           *
+ * \brief Delta / zig-zag varint compression of sample streams.              *
+ *                                                                           *
+ * Samples are packed into self-contained blocks, so a block lost to an     *
+ * overwrite does not break the ones after it. Inside a block each source    *
+ * keeps its own history: timestamps are stored as the change of the        *
+ * interval since its previous sample (a steady rate costs only the         *
+ * jitter), values as the change since its previous value. Both are         *
+ * zig-zag mapped and written as LEB128 varints, so small changes take one  *
+ * byte.                                                                     *
+ *                                                                           *
+ * Block, little-endian:                                                     *
+ *   type 0xB1 (1) | count (1) | base_ts (4) | base_seq (2)                  *
+ *   count x sample:                                                         *
+ *     head (1)   src (bits 0-2) | count - 1 (bits 3-4) | seq gap (bit 5)   *
+ *     [gap]      varint, seq - expected seq, only with the gap bit         *
+ *     ts         zig-zag varint: first sample of a source, ts - base_ts;   *
+ *                after, interval - previous interval of that source        *
+ *     value[]    zig-zag varint: value - previous value of that source     *
+ *                (0 before its first sample)                               *
+ * The expected seq is the previous sample's plus one, base_seq first.      *
+ *                                                                           *
+ * \author blackchacal <ribeiro.tonet@gmail.com>                             *
+ * \date Oct 17, 2026                                                        *
+ *                                                                           *
+ * \version 1.0 | \author blackchacal                                        *
+ * File creation.                                                            *
+ *                                                                           *
+ *****************************************************************************/
+
+#ifndef _TSCODEC_H
+#define _TSCODEC_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*****************************************************************************
+ * Includes                                                                  *
+ *****************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "suricata_config.h"
+#include "sampler.h"
+
+/*****************************************************************************
+ * Configuration Macros                                                      *
+ *****************************************************************************/
+
+/**
+ * @def TSC_BLOCK_SIZE
+ * Largest block. At most 255, the uplink's record length field.
+ */
+#ifndef TSC_BLOCK_SIZE
+#define TSC_BLOCK_SIZE          240
+#endif
+
+/**
+ * @def TSC_BLOCK_MAX_US
+ * Longest a block stays open before it is flushed, full or not.
+ */
+#ifndef TSC_BLOCK_MAX_US
+#define TSC_BLOCK_MAX_US        1000000UL
+#endif
+
+/*****************************************************************************
+ * Macros                                                                    *
+ *****************************************************************************/
+
+/* --- Error codes ----------------------------------------------------------*/
+
+#ifndef ERR_OK
+#define ERR_OK                          (0)
+#endif
+#define ERR_TSC_NULL_POINTER            (-80)
+#define ERR_TSC_FULL                    (-81)
+#define ERR_TSC_INVALID_SAMPLE          (-82)
+#define ERR_TSC_CORRUPT                 (-83)
+#define ERR_TSC_END                     (-84)
+
+/* --- Block ----------------------------------------------------------------*/
+
+#define TSC_BLOCK_TYPE                  (0xB1)
+#define TSC_HDR_SIZE                    (8)
+#define TSC_SOURCES                     (8)
+
+/* Worst case of one sample: head, gap, ts and every value as 5 byte varints. */
+#define TSC_SAMPLE_MAX                  (1 + 3 + 5 + 5 * SAMPLER_MAX_VALUES)
+
+#if SAMPLER_MAX_VALUES > 4
+#error "tscodec stores count - 1 in two bits, SAMPLER_MAX_VALUES must be <= 4"
+#endif
+
+/*****************************************************************************
+ * Datatypes                                                                 *
+ *****************************************************************************/
+
+/**
+ * \struct tsc_source_t
+ * History of one source within the current block.
+ */
+typedef struct
+{
+    bool seen;
+    uint32_t ts;
+    int32_t interval;
+    int32_t value[SAMPLER_MAX_VALUES];
+} tsc_source_t;
+
+/**
+ * \struct tsc_enc_t
+ * Encoder writing one block at a time into buf.
+ */
+typedef struct
+{
+    uint8_t * buf;
+    uint16_t size;
+    uint16_t len;               /* 0 while the block is empty. */
+    uint16_t next_seq;
+    tsc_source_t src[TSC_SOURCES];
+} tsc_enc_t;
+
+/**
+ * \struct tsc_dec_t
+ * Decoder reading one block.
+ */
+typedef struct
+{
+    const uint8_t * buf;
+    uint16_t len;
+    uint16_t pos;
+    uint8_t left;
+    uint32_t base_ts;
+    uint16_t next_seq;
+    tsc_source_t src[TSC_SOURCES];
+} tsc_dec_t;
+
+/*****************************************************************************
+ * Public Functions                                                          *
+ *****************************************************************************/
+
+/**
+ * @brief Sets the block buffer and starts an empty block.
+ *
+ * @param enc
+ * @param buf
+ * @param size TSC_HDR_SIZE + TSC_SAMPLE_MAX at least.
+ * @return int
+ */
+int tsc_enc_init (tsc_enc_t * enc, uint8_t * buf, uint16_t size);
+
+/**
+ * @brief Appends one sample to the block.
+ *
+ * @return int ERR_OK, ERR_TSC_INVALID_SAMPLE (source or count out of
+ * range) or ERR_TSC_FULL: take the block and call again.
+ */
+int tsc_enc_add (tsc_enc_t * enc, const sampler_sample_t * sample);
+
+/**
+ * @brief Returns the block length, 0 if it holds no sample.
+ */
+uint16_t tsc_enc_len (const tsc_enc_t * enc);
+
+/**
+ * @brief Starts a new, empty block, once the current one has been taken.
+ */
+void tsc_enc_reset (tsc_enc_t * enc);
+
+/**
+ * @brief Starts decoding a block.
+ *
+ * @return int ERR_OK or ERR_TSC_CORRUPT if it is not a block.
+ */
+int tsc_dec_init (tsc_dec_t * dec, const uint8_t * block, uint16_t len);
+
+/**
+ * @brief Decodes the next sample.
+ *
+ * @return int ERR_OK, ERR_TSC_END after the last one or ERR_TSC_CORRUPT.
+ */
+int tsc_dec_next (tsc_dec_t * dec, sampler_sample_t * sample);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _TSCODEC_H */
+
+/* end of file */
@@ -0,0 +1,189 @@
+/*****************************************************************************
+ *                                                                           *
+ * \file uplink.h                                                            *
+ *                                                                           *
+ * \brief Batched UDP uplink of the records in a rbuffer.                    *
+ *                                                                           *
+ * Records are not sent one by one: uplink_poll packs as many as fit into a  *
+ * single frame and sends it when the frame is full enough or the oldest     *
+ * record has waited UPLINK_MAX_DELAY_US. Records are released from the      *
+ * rbuffer only once their frame has been handed to the link, so while the   *
+ * link is down or busy the data stays queued (and, on an overwrite          *
+ * rbuffer, the oldest is dropped first).                                    *
+ *                                                                           *
+ * Frame, little-endian:                                                     *
+ *   magic "SU" (2) | version (1) | count (1) | seq (4)                      *
+ *   count x { len (1) | record (len) }                                      *
+ *   crc16 (2), CRC-16/CCITT-FALSE over everything before it                 *
+ * seq counts frames, so the receiver sees lost frames. Version 2 records   *
+ * are tscodec blocks (see tscodec.h). tools/uplink_rx.py is a receiver for  *
+ * testing.                                                                  *
+ *                                                                           *
+ * The link is WiFiNINA UDP on the board, a POSIX UDP socket natively.       *
+ *                                                                           *
+ * \author blackchacal <ribeiro.tonet@gmail.com>                             *
+ * \date Oct 17, 2026                                                        *
+ *                                                                           *
+ * \version 1.0 | \author blackchacal                                        *
+ * File creation.                                                            *
+ *                                                                           *
+ *****************************************************************************/
+
+#ifndef _UPLINK_H
+#define _UPLINK_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*****************************************************************************
+ * Includes                                                                  *
+ *****************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "suricata_config.h"
+#include "rbuffer.h"
+
+/*****************************************************************************
+ * Configuration Macros                                                      *
+ *****************************************************************************/
+
+/**
+ * @def UPLINK_HOST
+ * Receiver IPv4 address.
+ */
+#ifndef UPLINK_HOST
+#define UPLINK_HOST             "127.0.0.1"
+#endif
+
+/**
+ * @def UPLINK_PORT
+ * Receiver UDP port.
+ */
+#ifndef UPLINK_PORT
+#define UPLINK_PORT             47000
+#endif
+
+/**
+ * @def UPLINK_WIFI_SSID
+ * Network to join on the board. Empty disables the uplink there.
+ */
+#ifndef UPLINK_WIFI_SSID
+#define UPLINK_WIFI_SSID        ""
+#endif
+
+#ifndef UPLINK_WIFI_PASS
+#define UPLINK_WIFI_PASS        ""
+#endif
+
+/**
+ * @def UPLINK_FRAME_SIZE
+ * Largest frame, kept under one Ethernet MTU of UDP payload.
+ */
+#ifndef UPLINK_FRAME_SIZE
+#define UPLINK_FRAME_SIZE       1024
+#endif
+
+/**
+ * @def UPLINK_MAX_DELAY_US
+ * Longest a record waits for its frame to fill up.
+ */
+#ifndef UPLINK_MAX_DELAY_US
+#define UPLINK_MAX_DELAY_US     2000000UL
+#endif
+
+/**
+ * @def UPLINK_POLL_PERIOD_US
+ * Period of the uplink_poll task run from main.
+ */
+#ifndef UPLINK_POLL_PERIOD_US
+#define UPLINK_POLL_PERIOD_US   100000UL
+#endif
+
+/**
+ * @def UPLINK_RETRY_US
+ * Time between attempts to join the network.
+ */
+#ifndef UPLINK_RETRY_US
+#define UPLINK_RETRY_US         10000000UL
+#endif
+
+/*****************************************************************************
+ * Macros                                                                    *
+ *****************************************************************************/
+
+/* --- Error codes ----------------------------------------------------------*/
+
+#ifndef ERR_OK
+#define ERR_OK                          (0)
+#endif
+#define ERR_UPLINK_NULL_POINTER         (-70)
+#define ERR_UPLINK_NOT_INIT             (-71)
+#define ERR_UPLINK_LINK_DOWN            (-72)
+#define ERR_UPLINK_SEND                 (-73)
+
+/* --- Frame ----------------------------------------------------------------*/
+
+#define UPLINK_MAGIC_0                  (0x53)
+#define UPLINK_MAGIC_1                  (0x55)
+#define UPLINK_VERSION                  (2)
+#define UPLINK_HDR_SIZE                 (8)
+#define UPLINK_CRC_SIZE                 (2)
+
+/*****************************************************************************
+ * Datatypes                                                                 *
+ *****************************************************************************/
+
+/**
+ * \struct uplink_stats_t
+ * Uplink counters.
+ */
+typedef struct
+{
+    uint32_t frames;            /* Frames sent. */
+    uint32_t records;           /* Records sent. */
+    uint32_t bytes;             /* Frame bytes sent. */
+    uint32_t failed;            /* Sends refused by the link; data kept. */
+    uint32_t deferred;          /* Polls with data but no link. */
+} uplink_stats_t;
+
+/*****************************************************************************
+ * Public Functions                                                          *
+ *****************************************************************************/
+
+/**
+ * @brief Sets the rbuffer to drain and starts bringing the link up. Never
+ * waits for the link.
+ *
+ * @param rb A rrecord rbuffer.
+ * @return int
+ */
+int uplink_init (rbuffer_t * rb);
+
+/**
+ * @brief Keeps the link up and sends the frames that are due. Call it
+ * periodically from the main context.
+ *
+ * @return int ERR_OK, or why data was kept back.
+ */
+int uplink_poll (void);
+
+/**
+ * @brief Copies the uplink counters.
+ */
+void uplink_stats (uplink_stats_t * stats);
+
+/**
+ * @brief CRC-16/CCITT-FALSE: polynomial 0x1021, init 0xFFFF.
+ */
+uint16_t uplink_crc16 (const uint8_t * data, uint16_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _UPLINK_H */
+
+/* end of file */
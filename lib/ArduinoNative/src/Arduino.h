@@ -0,0 +1,200 @@
+/*****************************************************************************
+ *                                                                           *
+ * \file Arduino.h                                                           *
+ *                                                                           *
+ * \brief Minimal Arduino HAL for running the firmware on a Linux host.      *
+ *                                                                           *
+ * Only what the firmware uses is provided:                                  *
+ *   - Serial writes to stdout, or to a file given with -o.                  *
+ *   - millis/micros run on CLOCK_MONOTONIC from program start, delay        *
+ *     really sleeps.                                                        *
+ *   - noInterrupts/interrupts hold back the simulated timer interrupt, a    *
+ *     request meanwhile is latched as in the NVIC. Optional hooks let       *
+ *     critical sections be counted or checked.                              *
+ *   - native_timer_start runs a callback as a simulated interrupt, from a   *
+ *     SIGALRM handler, so ISR paths run truly asynchronously.               *
+ * main() lives in the library: it calls setup() and then loop() until the  *
+ * loop count given with -n is reached or SIGINT/SIGTERM arrives.            *
+ *                                                                           *
+ * \author blackchacal <ribeiro.tonet@gmail.com>                             *
+ * \date Oct 17, 2026                                                        *
+ *                                                                           *
+ * \version 1.0 | \author blackchacal                                        *
+ * File creation.                                                            *
+ *                                                                           *
+ *****************************************************************************/
+
+#ifndef _ARDUINO_NATIVE_H
+#define _ARDUINO_NATIVE_H
+
+/*****************************************************************************
+ * Includes                                                                  *
+ *****************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+/*****************************************************************************
+ * Macros                                                                    *
+ *****************************************************************************/
+
+/**
+ * @def NATIVE_SERIAL_TX_SIZE
+ * Value returned by Serial.availableForWrite(). Matches the SAMD21 USB CDC
+ * endpoint, so drain loops behave as on the board.
+ */
+#ifndef NATIVE_SERIAL_TX_SIZE
+#define NATIVE_SERIAL_TX_SIZE   63
+#endif
+
+/*****************************************************************************
+ * Public Functions                                                          *
+ *****************************************************************************/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* --- Arduino core ---------------------------------------------------------*/
+
+unsigned long millis (void);
+
+unsigned long micros (void);
+
+void delay (unsigned long ms);
+
+void delayMicroseconds (unsigned int us);
+
+void yield (void);
+
+void noInterrupts (void);
+
+void interrupts (void);
+
+/* --- Native extensions ----------------------------------------------------*/
+
+/**
+ * @brief Hooks called on every noInterrupts/interrupts, NULL to remove.
+ */
+void native_irq_hooks (void (*on_disable) (void), void (*on_enable) (void));
+
+/**
+ * @brief Returns true while interrupts are enabled.
+ */
+bool native_irq_enabled (void);
+
+/**
+ * @brief Returns true while the simulated interrupt handler runs.
+ */
+bool native_in_isr (void);
+
+/**
+ * @brief Runs isr every period_us as a simulated interrupt. Only one timer
+ * exists; starting it again replaces the previous one. Returns false if the
+ * host timer could not be armed.
+ */
+bool native_timer_start (uint32_t period_us, void (*isr) (void));
+
+void native_timer_stop (void);
+
+/**
+ * @brief Sends Serial output to path instead of stdout.
+ */
+bool native_serial_open (const char * path);
+
+#ifdef __cplusplus
+}
+#endif
+
+/*****************************************************************************
+ * Serial                                                                    *
+ *****************************************************************************/
+
+#ifdef __cplusplus
+
+class NativeSerial
+{
+public:
+    void begin (unsigned long baud);
+
+    void end (void);
+
+    int available (void)
+    {
+        return 0;
+    }
+
+    int read (void)
+    {
+        return -1;
+    }
+
+    int availableForWrite (void)
+    {
+        return NATIVE_SERIAL_TX_SIZE;
+    }
+
+    size_t write (uint8_t b)
+    {
+        return write(&b, 1);
+    }
+
+    size_t write (const uint8_t * buf, size_t len);
+
+    size_t write (const char * buf, size_t len)
+    {
+        return write((const uint8_t *)buf, len);
+    }
+
+    size_t print (const char * s)
+    {
+        return write(s, strlen(s));
+    }
+
+    size_t print (long v);
+
+    size_t print (unsigned long v);
+
+    size_t print (int v)
+    {
+        return print((long)v);
+    }
+
+    size_t print (unsigned int v)
+    {
+        return print((unsigned long)v);
+    }
+
+    template <typename T>
+    size_t println (T v)
+    {
+        return print(v) + println();
+    }
+
+    size_t println (void)
+    {
+        return write("\r\n", 2);
+    }
+
+    void flush (void);
+
+    operator bool (void)
+    {
+        return true;
+    }
+};
+
+extern NativeSerial Serial;
+
+/* Firmware entry points, defined in src/main.cpp. */
+void setup (void);
+
+void loop (void);
+
+#endif
+
+#endif /* _ARDUINO_NATIVE_H */
+
+/* end of file */
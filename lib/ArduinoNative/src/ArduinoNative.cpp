@@ -0,0 +1,294 @@
+/*****************************************************************************
+ *                                                                           *
+ * \file ArduinoNative.cpp                                                   *
+ *                                                                           *
+ * \brief Minimal Arduino HAL for running the firmware on a Linux host.      *
+ *                                                                           *
+ * \author blackchacal <ribeiro.tonet@gmail.com>                             *
+ * \date Oct 17, 2026                                                        *
+ *                                                                           *
+ * \version 1.0 | \author blackchacal                                        *
+ * File creation.                                                            *
+ *                                                                           *
+ *****************************************************************************/
+
+/*****************************************************************************
+ * Includes                                                                  *
+ *****************************************************************************/
+
+/* --- Standard libraries -------------------- */
+#include <errno.h>
+#include <signal.h>
+#include <stdio.h>
+#include <sys/time.h>
+#include <time.h>
+
+/* --- Custom modules -------------------- */
+#include "Arduino.h"
+
+/*****************************************************************************
+ * Static Variables                                                          *
+ *****************************************************************************/
+
+static FILE * serial_out = NULL;
+
+static volatile sig_atomic_t irq_enabled = 1;
+static volatile sig_atomic_t irq_pending = 0;
+static volatile sig_atomic_t in_isr = 0;
+static void (*irq_on_disable) (void) = NULL;
+static void (*irq_on_enable) (void) = NULL;
+static void (* volatile timer_isr) (void) = NULL;
+
+/*****************************************************************************
+ * Public Variables                                                          *
+ *****************************************************************************/
+
+NativeSerial Serial;
+
+/*****************************************************************************
+ * Private Functions                                                         *
+ *****************************************************************************/
+
+static uint64_t native_now_us (void)
+{
+    static uint64_t start = 0;
+    struct timespec ts;
+    uint64_t now;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    now = (uint64_t)ts.tv_sec * 1000000ULL + (uint64_t)ts.tv_nsec / 1000;
+    if (start == 0)
+    {
+        start = now;
+    }
+
+    return now - start;
+}
+
+static void native_sleep_us (uint64_t us)
+{
+    struct timespec req;
+    struct timespec rem;
+
+    req.tv_sec = (time_t)(us / 1000000ULL);
+    req.tv_nsec = (long)((us % 1000000ULL) * 1000);
+
+    /* The simulated timer interrupts the sleep, keep going until done. */
+    while ((nanosleep(&req, &rem) != 0) && (errno == EINTR))
+    {
+        req = rem;
+    }
+}
+
+/**
+ * @brief Runs the simulated interrupt handler, again if it became pending
+ * meanwhile. Interrupts count as enabled on entry, as on the board.
+ */
+static void native_run_isr (void)
+{
+    void (*isr) (void);
+
+    in_isr = 1;
+    do
+    {
+        irq_pending = 0;
+        irq_enabled = 1;
+        isr = timer_isr;
+        if (isr != NULL)
+        {
+            isr();
+        }
+    } while (irq_pending);
+    irq_enabled = 1;
+    in_isr = 0;
+}
+
+/**
+ * @brief SIGALRM handler, the simulated interrupt request. While interrupts
+ * are masked or the handler already runs the request is only latched, like
+ * the NVIC pending bit, and interrupts() runs it later.
+ */
+static void native_timer_handler (int sig)
+{
+    int saved_errno = errno;
+
+    (void)sig;
+
+    if (!irq_enabled || in_isr)
+    {
+        irq_pending = 1;
+    }
+    else
+    {
+        native_run_isr();
+    }
+
+    errno = saved_errno;
+}
+
+/*****************************************************************************
+ * Public Functions                                                          *
+ *****************************************************************************/
+
+/* --- Arduino core ---------------------------------------------------------*/
+
+unsigned long millis (void)
+{
+    return (unsigned long)(uint32_t)(native_now_us() / 1000);
+}
+
+unsigned long micros (void)
+{
+    return (unsigned long)(uint32_t)native_now_us();
+}
+
+void delay (unsigned long ms)
+{
+    native_sleep_us((uint64_t)ms * 1000);
+}
+
+void delayMicroseconds (unsigned int us)
+{
+    native_sleep_us(us);
+}
+
+void yield (void)
+{
+}
+
+void noInterrupts (void)
+{
+    /* A flag, not sigprocmask: critical sections stay as cheap as on the
+     * board, so benchmarks and profiles are not dominated by syscalls. */
+    irq_enabled = 0;
+    if (irq_on_disable != NULL)
+    {
+        irq_on_disable();
+    }
+}
+
+void interrupts (void)
+{
+    if (irq_on_enable != NULL)
+    {
+        irq_on_enable();
+    }
+    irq_enabled = 1;
+    if (irq_pending && !in_isr)
+    {
+        native_run_isr();
+    }
+}
+
+/* --- Native extensions ----------------------------------------------------*/
+
+void native_irq_hooks (void (*on_disable) (void), void (*on_enable) (void))
+{
+    irq_on_disable = on_disable;
+    irq_on_enable = on_enable;
+}
+
+bool native_irq_enabled (void)
+{
+    return irq_enabled != 0;
+}
+
+bool native_in_isr (void)
+{
+    return in_isr != 0;
+}
+
+bool native_timer_start (uint32_t period_us, void (*isr) (void))
+{
+    struct sigaction sa;
+    struct itimerval it;
+
+    timer_isr = isr;
+
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = native_timer_handler;
+    sa.sa_flags = SA_RESTART;
+    sigemptyset(&sa.sa_mask);
+    if (sigaction(SIGALRM, &sa, NULL) != 0)
+    {
+        return false;
+    }
+
+    it.it_interval.tv_sec = period_us / 1000000UL;
+    it.it_interval.tv_usec = period_us % 1000000UL;
+    it.it_value = it.it_interval;
+
+    return setitimer(ITIMER_REAL, &it, NULL) == 0;
+}
+
+void native_timer_stop (void)
+{
+    struct itimerval it;
+
+    memset(&it, 0, sizeof(it));
+    setitimer(ITIMER_REAL, &it, NULL);
+    timer_isr = NULL;
+}
+
+bool native_serial_open (const char * path)
+{
+    FILE * f = fopen(path, "wb");
+
+    if (f == NULL)
+    {
+        return false;
+    }
+    if ((serial_out != NULL) && (serial_out != stdout))
+    {
+        fclose(serial_out);
+    }
+    serial_out = f;
+
+    return true;
+}
+
+/* --- Serial ---------------------------------------------------------------*/
+
+void NativeSerial::begin (unsigned long baud)
+{
+    (void)baud;
+    if (serial_out == NULL)
+    {
+        serial_out = stdout;
+    }
+}
+
+void NativeSerial::end (void)
+{
+    flush();
+}
+
+size_t NativeSerial::write (const uint8_t * buf, size_t len)
+{
+    FILE * out = (serial_out != NULL) ? serial_out : stdout;
+
+    return fwrite(buf, 1, len, out);
+}
+
+size_t NativeSerial::print (long v)
+{
+    char s[24];
+    int n = snprintf(s, sizeof(s), "%ld", v);
+
+    return write(s, (size_t)n);
+}
+
+size_t NativeSerial::print (unsigned long v)
+{
+    char s[24];
+    int n = snprintf(s, sizeof(s), "%lu", v);
+
+    return write(s, (size_t)n);
+}
+
+void NativeSerial::flush (void)
+{
+    fflush((serial_out != NULL) ? serial_out : stdout);
+}
+
+/* end of file */
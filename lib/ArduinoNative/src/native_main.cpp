@@ -0,0 +1,101 @@
+/*****************************************************************************
+ *                                                                           *
+ * \file native_main.cpp                                                     *
+ *                                                                           *
+ * \brief Host entry point: runs the firmware setup() and loop().            *
+ *                                                                           *
+ *   program [-o serial.log] [-n loops]                                      *
+ *                                                                           *
+ * -n 0 (the default) loops until SIGINT or SIGTERM, like the board.         *
+ * Left out of `pio test` builds (PIO_UNIT_TESTING), where each test brings  *
+ * its own main().                                                           *
+ *                                                                           *
+ * \author blackchacal <ribeiro.tonet@gmail.com>                             *
+ * \date Oct 17, 2026                                                        *
+ *                                                                           *
+ * \version 1.0 | \author blackchacal                                        *
+ * File creation.                                                            *
+ *                                                                           *
+ *****************************************************************************/
+
+#if !defined(PIO_UNIT_TESTING)
+
+/*****************************************************************************
+ * Includes                                                                  *
+ *****************************************************************************/
+
+/* --- Standard libraries -------------------- */
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+/* --- Custom modules -------------------- */
+#include "Arduino.h"
+
+/*****************************************************************************
+ * Static Variables                                                          *
+ *****************************************************************************/
+
+static volatile sig_atomic_t native_stop = 0;
+
+/*****************************************************************************
+ * Private Functions                                                         *
+ *****************************************************************************/
+
+static void native_on_signal (int sig)
+{
+    (void)sig;
+    native_stop = 1;
+}
+
+/*****************************************************************************
+ * Code                                                                      *
+ *****************************************************************************/
+
+int main (int argc, char ** argv)
+{
+    unsigned long loops = 0;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "o:n:h")) != -1)
+    {
+        switch (opt)
+        {
+            case 'o':
+                if (!native_serial_open(optarg))
+                {
+                    perror(optarg);
+                    return 1;
+                }
+                break;
+
+            case 'n':
+                loops = strtoul(optarg, NULL, 0);
+                break;
+
+            default:
+                fprintf(stderr, "usage: %s [-o serial.log] [-n loops]\n", argv[0]);
+                return (opt == 'h') ? 0 : 1;
+        }
+    }
+
+    signal(SIGINT, native_on_signal);
+    signal(SIGTERM, native_on_signal);
+
+    (void)millis();         /* Starts the clock. */
+    setup();
+    for (unsigned long i = 0; !native_stop && ((loops == 0) || (i < loops)); i++)
+    {
+        loop();
+    }
+
+    native_timer_stop();
+    Serial.flush();
+
+    return 0;
+}
+
+#endif /* PIO_UNIT_TESTING */
+
+/* end of file */
@@ -0,0 +1,301 @@
+/*****************************************************************************
+ *                                                                           *
+ * \file agg.c                                                               *
+ *                                                                           *
+ * \brief Incremental windowed aggregation of sample channels.               *
+ *                                                                           *
+ * \author blackchacal <ribeiro.tonet@gmail.com>                             *
+ * \date Oct 17, 2026                                                        *
+ *                                                                           *
+ * \version 1.0 | \author blackchacal                                        *
+ * File creation.                                                            *
+ *                                                                           *
+ *****************************************************************************/
+
+/*****************************************************************************
+ * Includes                                                                  *
+ *****************************************************************************/
+
+/* --- Standard libraries -------------------- */
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <math.h>
+
+/* --- Custom modules -------------------- */
+#include "agg.h"
+
+/*****************************************************************************
+ * Static Variables                                                          *
+ *****************************************************************************/
+
+static agg_t * agg_list = NULL;
+static agg_emit_t agg_emit = NULL;
+
+/*****************************************************************************
+ * Private Functions                                                         *
+ *****************************************************************************/
+
+/* --- Statistics -----------------------------------------------------------*/
+
+static void agg_stat_add (agg_stat_t * stat, int32_t value)
+{
+    float delta = (float)value - stat->mean;
+
+    stat->n++;
+    stat->mean += delta / (float)stat->n;
+    stat->m2 += delta * ((float)value - stat->mean);
+    if ((stat->n == 1) || (value < stat->min))
+    {
+        stat->min = value;
+    }
+    if ((stat->n == 1) || (value > stat->max))
+    {
+        stat->max = value;
+    }
+}
+
+/**
+ * @brief Merges pane b into window a.
+ */
+static void agg_stat_merge (agg_stat_t * a, const agg_stat_t * b)
+{
+    uint32_t n = a->n + b->n;
+    float delta = b->mean - a->mean;
+
+    if (b->n == 0)
+    {
+        return;
+    }
+
+    a->m2 += b->m2 + delta * delta * ((float)a->n * (float)b->n / (float)n);
+    a->mean += delta * ((float)b->n / (float)n);
+    a->n = n;
+}
+
+/**
+ * @brief Takes pane b, merged earlier, back out of window a.
+ */
+static void agg_stat_unmerge (agg_stat_t * a, const agg_stat_t * b)
+{
+    uint32_t n = a->n - b->n;
+    float mean = 0.0f;
+    float delta = 0.0f;
+
+    if (b->n == 0)
+    {
+        return;
+    }
+    if (n == 0)
+    {
+        memset(a, 0, sizeof(*a));
+        return;
+    }
+
+    mean = (a->mean * (float)a->n - b->mean * (float)b->n) / (float)n;
+    delta = b->mean - mean;
+    a->m2 -= b->m2 + delta * delta * ((float)n * (float)b->n / (float)a->n);
+    if (a->m2 < 0.0f)
+    {
+        a->m2 = 0.0f;
+    }
+    a->mean = mean;
+    a->n = n;
+}
+
+/* --- Min / max deques -----------------------------------------------------*/
+
+/**
+ * @brief Pushes pane number p on a monotonic deque of pane numbers: panes
+ * that can no longer be the window's min (or max) are dropped from the
+ * back. The front is the window's extreme.
+ */
+static void agg_deque_push (agg_t * agg, uint32_t * q, uint8_t * head, uint8_t * len,
+                            uint32_t p, bool is_min)
+{
+    const agg_stat_t * pane = &agg->pane[p % agg->panes];
+
+    if (pane->n == 0)
+    {
+        return;
+    }
+
+    while (*len > 0)
+    {
+        const agg_stat_t * back = &agg->pane[q[(*head + *len - 1) % agg->panes] % agg->panes];
+
+        if (is_min ? (back->min < pane->min) : (back->max > pane->max))
+        {
+            break;
+        }
+        (*len)--;
+    }
+
+    q[(*head + *len) % agg->panes] = p;
+    (*len)++;
+}
+
+/**
+ * @brief Drops from the front the panes that are out of the window once
+ * pane p closes.
+ */
+static void agg_deque_expire (agg_t * agg, uint32_t * q, uint8_t * head, uint8_t * len, uint32_t p)
+{
+    while ((*len > 0) && ((q[*head] + agg->panes) <= p))
+    {
+        *head = (uint8_t)((*head + 1) % agg->panes);
+        (*len)--;
+    }
+}
+
+/* --- Windows --------------------------------------------------------------*/
+
+static void agg_emit_window (const agg_t * agg)
+{
+    sampler_sample_t out;
+    float var = 0.0f;
+
+    if ((agg->win.n == 0) || (agg_emit == NULL))
+    {
+        return;
+    }
+
+    if (agg->win.n > 1)
+    {
+        var = agg->win.m2 / (float)(agg->win.n - 1);
+    }
+
+    memset(&out, 0, sizeof(out));
+    out.ts_us = agg->pane_end;
+    out.src = agg->out_src;
+    out.count = AGG_VALUES;
+    out.value[AGG_VALUE_MEAN] = (int32_t)lroundf(agg->win.mean);
+    out.value[AGG_VALUE_MIN] = agg->pane[agg->min_q[agg->min_head] % agg->panes].min;
+    out.value[AGG_VALUE_MAX] = agg->pane[agg->max_q[agg->max_head] % agg->panes].max;
+    out.value[AGG_VALUE_STDDEV] = (int32_t)lroundf(sqrtf(var));
+    agg_emit(&out);
+}
+
+/**
+ * @brief Closes the current pane: the oldest pane leaves the window, the
+ * current one joins it, and the window is emitted.
+ */
+static void agg_close (agg_t * agg)
+{
+    uint32_t p = agg->closed;
+    agg_stat_t * slot = &agg->pane[p % agg->panes];
+
+    /* The slot still holds pane p - panes, the one leaving. */
+    agg_deque_expire(agg, agg->min_q, &agg->min_head, &agg->min_len, p);
+    agg_deque_expire(agg, agg->max_q, &agg->max_head, &agg->max_len, p);
+    if (p >= agg->panes)
+    {
+        agg_stat_unmerge(&agg->win, slot);
+    }
+
+    *slot = agg->cur;
+    memset(&agg->cur, 0, sizeof(agg->cur));
+    agg_deque_push(agg, agg->min_q, &agg->min_head, &agg->min_len, p, true);
+    agg_deque_push(agg, agg->max_q, &agg->max_head, &agg->max_len, p, false);
+
+    if ((p % agg->panes) == (uint32_t)(agg->panes - 1))
+    {
+        /* Once per window length, start over from the panes. */
+        memset(&agg->win, 0, sizeof(agg->win));
+        for (uint8_t i = 0; i < agg->panes; i++)
+        {
+            agg_stat_merge(&agg->win, &agg->pane[i]);
+        }
+    }
+    else
+    {
+        agg_stat_merge(&agg->win, slot);
+    }
+
+    agg->closed++;
+    agg_emit_window(agg);
+}
+
+static void agg_update (agg_t * agg, const sampler_sample_t * sample)
+{
+    if (!agg->started)
+    {
+        agg->started = true;
+        agg->pane_end = sample->ts_us - (sample->ts_us % agg->hop_us) + agg->hop_us;
+    }
+
+    /* Close the panes that ended before this sample. After a long pause
+     * the window is empty once panes have closed: skip to the current one. */
+    for (uint8_t i = 0; (int32_t)(sample->ts_us - agg->pane_end) >= 0; i++)
+    {
+        if (i > agg->panes)
+        {
+            agg->pane_end += agg->hop_us * ((sample->ts_us - agg->pane_end) / agg->hop_us + 1);
+            break;
+        }
+        agg_close(agg);
+        agg->pane_end += agg->hop_us;
+    }
+
+    agg_stat_add(&agg->cur, sample->value[agg->index]);
+}
+
+/*****************************************************************************
+ * Public Functions                                                          *
+ *****************************************************************************/
+
+void agg_init (agg_emit_t emit)
+{
+    agg_list = NULL;
+    agg_emit = emit;
+}
+
+int agg_add (agg_t * agg, uint8_t src, uint8_t index, uint8_t out_src,
+             uint32_t window_us, uint32_t hop_us, bool keep_raw)
+{
+    if (agg == NULL)
+    {
+        return ERR_AGG_NULL_POINTER;
+    }
+    if ((hop_us == 0) || (window_us < hop_us) || ((window_us % hop_us) != 0) ||
+        ((window_us / hop_us) > AGG_MAX_PANES))
+    {
+        return ERR_AGG_INVALID_WINDOW;
+    }
+    if ((index >= SAMPLER_MAX_VALUES) || (out_src == src))
+    {
+        return ERR_AGG_INVALID_CHANNEL;
+    }
+
+    memset(agg, 0, sizeof(*agg));
+    agg->src = src;
+    agg->index = index;
+    agg->out_src = out_src;
+    agg->panes = (uint8_t)(window_us / hop_us);
+    agg->hop_us = hop_us;
+    agg->keep_raw = keep_raw;
+    agg->next = agg_list;
+    agg_list = agg;
+
+    return ERR_OK;
+}
+
+bool agg_feed (const sampler_sample_t * sample)
+{
+    bool keep = true;
+
+    for (agg_t * agg = agg_list; agg != NULL; agg = agg->next)
+    {
+        if ((agg->src != sample->src) || (agg->index >= sample->count))
+        {
+            continue;
+        }
+        agg_update(agg, sample);
+        keep = keep && agg->keep_raw;
+    }
+
+    return keep;
+}
+
+/* end of file */
@@ -0,0 +1,393 @@
+/*****************************************************************************
+ *                                                                           *
+ * \file bench.cpp                                                           *
+ *                                                                           *
+ * \brief Micro-benchmarks of the ring buffer and logger hot paths.          *
+ *                                                                           *
+ * \author blackchacal <ribeiro.tonet@gmail.com>                             *
+ * \date Oct 17, 2026                                                        *
+ *                                                                           *
+ * \version 1.0 | \author blackchacal                                        *
+ * File creation.                                                            *
+ *                                                                           *
+ *****************************************************************************/
+
+/*****************************************************************************
+ * Includes                                                                  *
+ *****************************************************************************/
+
+/* --- Standard libraries -------------------- */
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#if !defined(__arm__)
+#include <time.h>
+#endif
+
+/* --- Arduino libraries -------------------- */
+#include <Arduino.h>
+
+/* --- Custom modules -------------------- */
+#include "bench.h"
+#include "logger.h"
+#include "log_fmt.h"
+#include "rbuffer.h"
+#include "rbuffer_spsc.h"
+
+#if BENCH_EN == 1
+
+/*****************************************************************************
+ * Macros                                                                    *
+ *****************************************************************************/
+
+#define BENCH_RB_SIZE       1024
+#define BENCH_MAX_CHUNK     256
+
+#if defined(__arm__)
+#define BENCH_UNIT          "cyc"
+#else
+#define BENCH_UNIT          "ns"
+#endif
+
+/**
+ * @def BENCH_TIME
+ * Times the statements given after i into sample i.
+ */
+#define BENCH_TIME(i, ...)                                      \
+    do                                                          \
+    {                                                           \
+        uint32_t t0_ = bench_now();                             \
+        __VA_ARGS__;                                            \
+        bench_samples[i] = bench_elapsed(t0_, bench_now());     \
+    } while (0)
+
+/*****************************************************************************
+ * Datatypes                                                                 *
+ *****************************************************************************/
+
+typedef enum
+{
+    BENCH_RB_BYTE,
+    BENCH_RB_BULK,
+    BENCH_SPSC_BULK,
+} bench_rb_mode_t;
+
+/*****************************************************************************
+ * Static Variables                                                          *
+ *****************************************************************************/
+
+static const uint16_t bench_chunks[] = { 1, 4, 16, 64, 256 };
+
+static const char * const bench_rb_mode_str[] = { "byte", "bulk", "spsc" };
+
+static uint32_t bench_samples[BENCH_SAMPLES];
+static uint32_t bench_overhead = 0;
+
+static uint8_t bench_store[BENCH_RB_SIZE];
+static uint8_t bench_spsc_store[BENCH_RB_SIZE];
+static uint8_t bench_scratch[BENCH_RB_SIZE];
+static uint8_t bench_chunk[BENCH_MAX_CHUNK];
+static rbuffer_t bench_rb;
+static rbuffer_spsc_t bench_spsc;
+
+static char bench_line[128];
+
+/*****************************************************************************
+ * Private Functions                                                         *
+ *****************************************************************************/
+
+/**
+ * @brief Current time stamp. On the board this is the SysTick down-counter,
+ * which counts CPU cycles and reloads every millisecond.
+ */
+static inline uint32_t bench_now (void)
+{
+#if defined(__arm__)
+    return SysTick->VAL;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec);
+#endif
+}
+
+/**
+ * @brief Time between two stamps, minus the clock overhead. On the board
+ * intervals must stay under one SysTick period.
+ */
+static inline uint32_t bench_elapsed (uint32_t start, uint32_t end)
+{
+#if defined(__arm__)
+    uint32_t d = (start >= end) ? (start - end) : (start + SysTick->LOAD + 1 - end);
+#else
+    uint32_t d = end - start;
+#endif
+
+    return (d > bench_overhead) ? (d - bench_overhead) : 0;
+}
+
+static void bench_sort (uint32_t * v, uint16_t n)
+{
+    for (uint16_t i = 1; i < n; i++)
+    {
+        uint32_t x = v[i];
+        uint16_t j = i;
+
+        while ((j > 0) && (v[j - 1] > x))
+        {
+            v[j] = v[j - 1];
+            j--;
+        }
+        v[j] = x;
+    }
+}
+
+static void bench_print (const char * fmt, ...)
+{
+    log_fmt_t out;
+    va_list vargs;
+
+    log_fmt_init(&out, bench_line, sizeof(bench_line) - 2);
+    va_start(vargs, fmt);
+    log_fmt_vprintf(&out, fmt, vargs);
+    va_end(vargs);
+    bench_line[out.len++] = '\r';
+    bench_line[out.len++] = '\n';
+
+    Serial.write(bench_line, out.len);
+    Serial.flush();
+}
+
+/**
+ * @brief Reports the percentiles of the last run. With bytes > 0 the median
+ * cost per byte is added, in hundredths.
+ */
+static void bench_report (const char * name, uint16_t bytes)
+{
+    const uint16_t n = BENCH_SAMPLES;
+
+    bench_sort(bench_samples, n);
+    bench_print("%-26s min %6lu p50 %6lu p90 %6lu p99 %6lu max %7lu " BENCH_UNIT,
+                name,
+                (unsigned long)bench_samples[0],
+                (unsigned long)bench_samples[n / 2],
+                (unsigned long)bench_samples[(n * 90) / 100],
+                (unsigned long)bench_samples[(n * 99) / 100],
+                (unsigned long)bench_samples[n - 1]);
+    if (bytes > 0)
+    {
+        bench_print("%-26s %.2k " BENCH_UNIT "/B", "",
+                    (int32_t)((bench_samples[n / 2] * 100UL) / bytes));
+    }
+}
+
+/**
+ * @brief Measures the cost of reading the clock, subtracted from every
+ * later sample.
+ */
+static void bench_calibrate (void)
+{
+    bench_overhead = 0;
+    for (uint16_t i = 0; i < BENCH_SAMPLES; i++)
+    {
+        BENCH_TIME(i, (void)0);
+    }
+    bench_sort(bench_samples, BENCH_SAMPLES);
+    bench_overhead = bench_samples[0];
+}
+
+/**
+ * @brief Empties both rings with head and tail at storage index pos.
+ */
+static void bench_rb_place (uint16_t pos)
+{
+    rbuffer_clear(&bench_rb);
+    rbuffer_add_bytes(&bench_rb, bench_scratch, pos);
+    rbuffer_get_bytes(&bench_rb, bench_scratch, pos);
+
+    rbuffer_spsc_clear(&bench_spsc);
+    rbuffer_spsc_add_bytes(&bench_spsc, bench_scratch, pos);
+    rbuffer_spsc_get_bytes(&bench_spsc, bench_scratch, pos);
+}
+
+static void bench_rb_add (bench_rb_mode_t mode, uint16_t chunk, uint16_t pos)
+{
+    for (uint16_t i = 0; i < BENCH_SAMPLES; i++)
+    {
+        bench_rb_place(pos);
+        switch (mode)
+        {
+            case BENCH_RB_BYTE:
+                BENCH_TIME(i, for (uint16_t k = 0; k < chunk; k++)
+                              {
+                                  rbuffer_add_byte(&bench_rb, bench_chunk[k]);
+                              });
+                break;
+
+            case BENCH_RB_BULK:
+                BENCH_TIME(i, rbuffer_add_bytes(&bench_rb, bench_chunk, chunk));
+                break;
+
+            case BENCH_SPSC_BULK:
+                BENCH_TIME(i, rbuffer_spsc_add_bytes(&bench_spsc, bench_chunk, chunk));
+                break;
+        }
+    }
+}
+
+static void bench_rb_get (bench_rb_mode_t mode, uint16_t chunk, uint16_t pos)
+{
+    for (uint16_t i = 0; i < BENCH_SAMPLES; i++)
+    {
+        bench_rb_place(pos);
+        rbuffer_add_bytes(&bench_rb, bench_chunk, chunk);
+        rbuffer_spsc_add_bytes(&bench_spsc, bench_chunk, chunk);
+        switch (mode)
+        {
+            case BENCH_RB_BYTE:
+                BENCH_TIME(i, for (uint16_t k = 0; k < chunk; k++)
+                              {
+                                  rbuffer_get_byte(&bench_rb, &bench_chunk[k]);
+                              });
+                break;
+
+            case BENCH_RB_BULK:
+                BENCH_TIME(i, rbuffer_get_bytes(&bench_rb, bench_chunk, chunk));
+                break;
+
+            case BENCH_SPSC_BULK:
+                BENCH_TIME(i, rbuffer_spsc_get_bytes(&bench_spsc, bench_chunk, chunk));
+                break;
+        }
+    }
+}
+
+/**
+ * @brief Byte-wise vs bulk vs lock-free SPSC, per chunk size, with the
+ * chunk either starting at the storage start or straddling its end.
+ */
+static void bench_rbuffer (void)
+{
+    char name[32];
+
+    rbuffer_init(&bench_rb, bench_store, BENCH_RB_SIZE, RBUFFER_POLICY_REJECT);
+    rbuffer_spsc_init(&bench_spsc, bench_spsc_store, BENCH_RB_SIZE);
+
+    for (uint8_t c = 0; c < sizeof(bench_chunks) / sizeof(bench_chunks[0]); c++)
+    {
+        uint16_t chunk = bench_chunks[c];
+
+        for (uint8_t wrap = 0; wrap < 2; wrap++)
+        {
+            uint16_t pos = wrap ? (uint16_t)(BENCH_RB_SIZE - (chunk + 1) / 2) : 0;
+
+            for (uint8_t m = BENCH_RB_BYTE; m <= BENCH_SPSC_BULK; m++)
+            {
+                snprintf(name, sizeof(name), "rb add %s %u%s",
+                         bench_rb_mode_str[m], chunk, wrap ? " wrap" : "");
+                bench_rb_add((bench_rb_mode_t)m, chunk, pos);
+                bench_report(name, chunk);
+
+                snprintf(name, sizeof(name), "rb get %s %u%s",
+                         bench_rb_mode_str[m], chunk, wrap ? " wrap" : "");
+                bench_rb_get((bench_rb_mode_t)m, chunk, pos);
+                bench_report(name, chunk);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Cost of one LOG_* call per level, with the deferred buffer emptied
+ * before each sample so no line is dropped. Lines are never written out.
+ */
+static void bench_logger (void)
+{
+    for (uint16_t i = 0; i < BENCH_SAMPLES; i++)
+    {
+        LOG_DISCARD();
+        BENCH_TIME(i, LOG_INFO("BENCH", "sample %d temp %.2k rh %u", i, 2315, 48U));
+    }
+    bench_report("log info", 0);
+
+    for (uint16_t i = 0; i < BENCH_SAMPLES; i++)
+    {
+        LOG_DISCARD();
+        BENCH_TIME(i, LOG_WARN("BENCH", "sample %d temp %.2k rh %u", i, 2315, 48U));
+    }
+    bench_report("log warn", 0);
+
+    for (uint16_t i = 0; i < BENCH_SAMPLES; i++)
+    {
+        LOG_DISCARD();
+        BENCH_TIME(i, LOG_DEBUG("BENCH", "sample %d temp %.2k rh %u", i, 2315, 48U));
+    }
+    bench_report("log debug", 0);
+
+    for (uint16_t i = 0; i < BENCH_SAMPLES; i++)
+    {
+        LOG_DISCARD();
+        BENCH_TIME(i, LOG_ERROR("BENCH", "sample %d temp %.2k rh %u", i, 2315, 48U));
+    }
+    bench_report("log error", 0);
+
+    /* Runs last: once a tag level is set every call takes the table lookup. */
+    LOG_SET_TAG_LEVEL("BENCH:OFF", LOG_LEVEL_NONE);
+    for (uint16_t i = 0; i < BENCH_SAMPLES; i++)
+    {
+        BENCH_TIME(i, LOG_INFO("BENCH:OFF", "sample %d temp %.2k rh %u", i, 2315, 48U));
+    }
+    bench_report("log info filtered", 0);
+
+    LOG_DISCARD();
+}
+
+/**
+ * @brief The logger formatter against the newlib vsnprintf it replaced, on
+ * the same line body.
+ */
+static void bench_format (void)
+{
+    static char buf[MAX_LOG_MSG_SIZE];
+    log_fmt_t out;
+
+    for (uint16_t i = 0; i < BENCH_SAMPLES; i++)
+    {
+        BENCH_TIME(i, log_fmt_init(&out, buf, sizeof(buf));
+                      log_fmt_printf(&out, "%s - %s | sample %d rh %u id %08x",
+                                     "INFO", "BENCH", i, 48U, 0xBEEFU));
+    }
+    bench_report("fmt log_fmt", 0);
+
+    for (uint16_t i = 0; i < BENCH_SAMPLES; i++)
+    {
+        BENCH_TIME(i, snprintf(buf, sizeof(buf), "%s - %s | sample %d rh %u id %08x",
+                               "INFO", "BENCH", i, 48U, 0xBEEFU));
+    }
+    bench_report("fmt snprintf", 0);
+}
+
+#endif
+
+/*****************************************************************************
+ * Public Functions                                                          *
+ *****************************************************************************/
+
+void bench_run (void)
+{
+#if BENCH_EN == 1
+    LOG_FLUSH();
+
+    bench_calibrate();
+    bench_print("bench: %u samples per case, clock overhead %lu " BENCH_UNIT,
+                (unsigned)BENCH_SAMPLES, (unsigned long)bench_overhead);
+
+    bench_rbuffer();
+    bench_logger();
+    bench_format();
+
+    bench_print("bench: done");
+#endif
+}
+
+/* end of file */
@@ -0,0 +1,121 @@
+/*****************************************************************************
+ *                                                                           *
+ * \file boot.cpp                                                            *
+ *                                                                           *
+ * \brief Staged boot sequence with per-stage timing.                        *
+ *                                                                           *
+ * \author blackchacal <ribeiro.tonet@gmail.com>                             *
+ * \date Oct 17, 2026                                                        *
+ *                                                                           *
+ * \version 1.0 | \author blackchacal                                        *
+ * File creation.                                                            *
+ *                                                                           *
+ *****************************************************************************/
+
+/*****************************************************************************
+ * Includes                                                                  *
+ *****************************************************************************/
+
+/* --- Standard libraries -------------------- */
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/* --- Arduino libraries -------------------- */
+#include <Arduino.h>
+
+/* --- Custom modules -------------------- */
+#include "boot.h"
+#include "logger.h"
+
+/*****************************************************************************
+ * Datatypes                                                                 *
+ *****************************************************************************/
+
+/**
+ * \struct boot_record_t
+ * Timing of one stage. Times in microseconds since reset.
+ */
+typedef struct
+{
+    const char * name;
+    uint32_t start_us;
+    uint32_t took_us;
+    int err;
+} boot_record_t;
+
+/*****************************************************************************
+ * Static Variables                                                          *
+ *****************************************************************************/
+
+static boot_record_t boot_records[BOOT_MAX_STAGES];
+static uint8_t boot_count = 0;
+static uint32_t boot_done_us = 0;
+static bool boot_serial_open = (BOOT_SERIAL_WAIT_MS == 0);
+
+/*****************************************************************************
+ * Private Functions                                                         *
+ *****************************************************************************/
+
+/**
+ * @brief True while a serial host holds the port open. On the SAMD21
+ * Serial's bool operator delays 10 ms on every call, the DTR line does
+ * not.
+ */
+static bool boot_serial_host (void)
+{
+#if defined(ARDUINO_ARCH_SAMD)
+    return Serial.dtr();
+#else
+    return (bool)Serial;
+#endif
+}
+
+/*****************************************************************************
+ * Public Functions                                                          *
+ *****************************************************************************/
+
+int boot_stage (const char * name, boot_stage_fn_t fn)
+{
+    uint32_t start = micros();
+    int err = fn();
+    uint32_t end = micros();
+
+    if (boot_count < BOOT_MAX_STAGES)
+    {
+        boot_records[boot_count].name = name;
+        boot_records[boot_count].start_us = start;
+        boot_records[boot_count].took_us = end - start;
+        boot_records[boot_count].err = err;
+        boot_count++;
+    }
+    boot_done_us = end;
+
+    /* Lets a host already attached see the log as boot goes. */
+    LOG_PROCESS();
+
+    return err;
+}
+
+bool boot_serial_ready (void)
+{
+    if (!boot_serial_open)
+    {
+        boot_serial_open = boot_serial_host() || (millis() >= BOOT_SERIAL_WAIT_MS);
+    }
+
+    return boot_serial_open;
+}
+
+void boot_report (void)
+{
+    for (uint8_t i = 0; i < boot_count; i++)
+    {
+        LOG_INFO("BOOT", "%-8s at %7lu us took %7lu us err %d", boot_records[i].name,
+                 (unsigned long)boot_records[i].start_us,
+                 (unsigned long)boot_records[i].took_us, boot_records[i].err);
+    }
+    LOG_INFO("BOOT", "setup done at %lu us", (unsigned long)boot_done_us);
+}
+
+/* end of file */
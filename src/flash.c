@@ -0,0 +1,394 @@
+/*****************************************************************************
+ *                                                                           *
+ * \file flash.c                                                             *
+ *                                                                           *
+ * \brief Raw access to the flash region reserved for data storage.          *
+ *                                                                           *
+ * \author blackchacal <ribeiro.tonet@gmail.com>                             *
+ * \date Oct 17, 2026                                                        *
+ *                                                                           *
+ * \version 1.0 | \author blackchacal                                        *
+ * File creation.                                                            *
+ *                                                                           *
+ *****************************************************************************/
+
+/*****************************************************************************
+ * Includes                                                                  *
+ *****************************************************************************/
+
+/* --- Standard libraries -------------------- */
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#if defined(SURICATA_NATIVE)
+#include <stdio.h>
+#endif
+
+/* --- Arduino libraries -------------------- */
+#include <Arduino.h>
+
+/* --- Custom modules -------------------- */
+#include "flash.h"
+
+/*****************************************************************************
+ * Macros                                                                    *
+ *****************************************************************************/
+
+#if defined(ARDUINO_ARCH_SAMD)
+#if (FLASH_PAGE_SIZE != FLASH_WRITE_SIZE) || ((FLASH_PAGE_SIZE * 4) != FLASH_ERASE_SIZE)
+#error "flash.h geometry does not match this part"
+#endif
+#endif
+
+/*****************************************************************************
+ * Static Variables                                                          *
+ *****************************************************************************/
+
+#if defined(ARDUINO_ARCH_SAMD)
+/* Linker script symbols: end of code, and the initial values of .data
+ * stored right after it. */
+extern uint32_t __etext;
+extern uint32_t __data_start__;
+extern uint32_t __data_end__;
+
+static uint32_t flash_base = 0;
+#elif defined(SURICATA_NATIVE)
+static FILE * flash_file = NULL;
+static uint32_t flash_cut_left = 0;
+static bool flash_cut_armed = false;
+static bool flash_dead = false;
+#endif
+
+/*****************************************************************************
+ * Private Functions                                                         *
+ *****************************************************************************/
+
+static int flash_check (uint32_t addr, uint32_t len, uint32_t align)
+{
+    if ((addr % align) != 0)
+    {
+        return ERR_FLASH_ALIGN;
+    }
+    if ((addr > FLASH_STORE_SIZE) || (len > (FLASH_STORE_SIZE - addr)))
+    {
+        return ERR_FLASH_RANGE;
+    }
+
+    return ERR_OK;
+}
+
+#if defined(ARDUINO_ARCH_SAMD)
+
+/**
+ * @brief Runs one NVM controller command on the given address and waits
+ * for it.
+ */
+static int flash_command (uint32_t addr, uint32_t cmd)
+{
+    while (NVMCTRL->INTFLAG.bit.READY == 0)
+    {
+    }
+    NVMCTRL->STATUS.reg = NVMCTRL_STATUS_MASK;
+    NVMCTRL->ADDR.reg = (flash_base + addr) / 2;
+    NVMCTRL->CTRLA.reg = (uint16_t)(NVMCTRL_CTRLA_CMDEX_KEY | cmd);
+    while (NVMCTRL->INTFLAG.bit.READY == 0)
+    {
+    }
+
+    return (NVMCTRL->STATUS.reg & (NVMCTRL_STATUS_PROGE | NVMCTRL_STATUS_LOCKE | NVMCTRL_STATUS_NVME))
+               ? ERR_FLASH_IO : ERR_OK;
+}
+
+static int flash_hw_init (void)
+{
+    uint32_t image_end = (uint32_t)&__etext +
+                         ((uint32_t)&__data_end__ - (uint32_t)&__data_start__);
+
+    flash_base = FLASH_SIZE - FLASH_STORE_SIZE;
+    if (image_end > flash_base)
+    {
+        return ERR_FLASH_RANGE;
+    }
+
+    /* Pages are written by an explicit command only, not when the page
+     * buffer's last word is loaded. */
+    NVMCTRL->CTRLB.bit.MANW = 1;
+
+    return ERR_OK;
+}
+
+static int flash_hw_read (uint32_t addr, uint8_t * data, uint16_t len)
+{
+    memcpy(data, (const void *)(flash_base + addr), len);
+
+    return ERR_OK;
+}
+
+static int flash_hw_write (uint32_t addr, const uint8_t * data)
+{
+    volatile uint32_t * dst = (volatile uint32_t *)(flash_base + addr);
+    int err = ERR_OK;
+
+    for (uint8_t i = 0; i < FLASH_WRITE_SIZE / 4; i++)
+    {
+        if (dst[i] != 0xFFFFFFFFUL)
+        {
+            err = ERR_FLASH_NOT_ERASED;
+        }
+    }
+    if (err != ERR_OK)
+    {
+        return err;
+    }
+
+    err = flash_command(addr, NVMCTRL_CTRLA_CMD_PBC);
+    if (err == ERR_OK)
+    {
+        /* The page buffer only takes 16 or 32 bit accesses. */
+        for (uint8_t i = 0; i < FLASH_WRITE_SIZE / 4; i++)
+        {
+            uint32_t word = 0;
+
+            memcpy(&word, &data[i * 4], 4);
+            dst[i] = word;
+        }
+        err = flash_command(addr, NVMCTRL_CTRLA_CMD_WP);
+    }
+
+    return err;
+}
+
+static int flash_hw_erase (uint32_t addr)
+{
+    return flash_command(addr, NVMCTRL_CTRLA_CMD_ER);
+}
+
+#elif defined(SURICATA_NATIVE)
+
+/**
+ * @brief Counts one write or erase against a pending flash_sim_cut.
+ *
+ * @return true if this operation is the one torn by the cut.
+ */
+static bool flash_sim_torn (void)
+{
+    if (!flash_cut_armed)
+    {
+        return false;
+    }
+    if (flash_cut_left > 0)
+    {
+        flash_cut_left--;
+        return false;
+    }
+
+    flash_cut_armed = false;
+    flash_dead = true;
+
+    return true;
+}
+
+static int flash_sim_put (uint32_t addr, const uint8_t * data, uint32_t len)
+{
+    if ((fseek(flash_file, (long)addr, SEEK_SET) != 0) ||
+        (fwrite(data, 1, len, flash_file) != len) || (fflush(flash_file) != 0))
+    {
+        return ERR_FLASH_IO;
+    }
+
+    return ERR_OK;
+}
+
+static int flash_hw_init (void)
+{
+    uint8_t row[FLASH_ERASE_SIZE];
+    int err = ERR_OK;
+
+    flash_dead = false;
+    flash_cut_armed = false;
+    if (flash_file == NULL)
+    {
+        flash_file = fopen(FLASH_SIM_FILE, "r+b");
+        if (flash_file == NULL)
+        {
+            flash_file = fopen(FLASH_SIM_FILE, "w+b");
+        }
+        if (flash_file == NULL)
+        {
+            return ERR_FLASH_IO;
+        }
+    }
+
+    /* A new file, or one of another size, starts out erased. */
+    if ((fseek(flash_file, 0, SEEK_END) != 0) || (ftell(flash_file) != (long)FLASH_STORE_SIZE))
+    {
+        flash_file = freopen(FLASH_SIM_FILE, "w+b", flash_file);
+        if (flash_file == NULL)
+        {
+            return ERR_FLASH_IO;
+        }
+        memset(row, 0xFF, sizeof(row));
+        for (uint32_t addr = 0; (addr < FLASH_STORE_SIZE) && (err == ERR_OK); addr += FLASH_ERASE_SIZE)
+        {
+            err = flash_sim_put(addr, row, FLASH_ERASE_SIZE);
+        }
+    }
+
+    return err;
+}
+
+static int flash_hw_read (uint32_t addr, uint8_t * data, uint16_t len)
+{
+    if ((fseek(flash_file, (long)addr, SEEK_SET) != 0) ||
+        (fread(data, 1, len, flash_file) != len))
+    {
+        return ERR_FLASH_IO;
+    }
+
+    return ERR_OK;
+}
+
+static int flash_hw_write (uint32_t addr, const uint8_t * data)
+{
+    uint8_t page[FLASH_WRITE_SIZE];
+    int err = ERR_OK;
+
+    if (flash_dead)
+    {
+        return ERR_FLASH_IO;
+    }
+
+    err = flash_hw_read(addr, page, FLASH_WRITE_SIZE);
+    for (uint8_t i = 0; (err == ERR_OK) && (i < FLASH_WRITE_SIZE); i++)
+    {
+        if (page[i] != 0xFF)
+        {
+            err = ERR_FLASH_NOT_ERASED;
+        }
+    }
+    if (err != ERR_OK)
+    {
+        return err;
+    }
+
+    err = flash_sim_put(addr, data, flash_sim_torn() ? FLASH_WRITE_SIZE / 2 : FLASH_WRITE_SIZE);
+
+    return flash_dead ? ERR_FLASH_IO : err;
+}
+
+static int flash_hw_erase (uint32_t addr)
+{
+    uint8_t row[FLASH_ERASE_SIZE];
+    int err = ERR_OK;
+
+    if (flash_dead)
+    {
+        return ERR_FLASH_IO;
+    }
+
+    memset(row, 0xFF, sizeof(row));
+    err = flash_sim_put(addr, row, flash_sim_torn() ? FLASH_ERASE_SIZE / 2 : FLASH_ERASE_SIZE);
+
+    return flash_dead ? ERR_FLASH_IO : err;
+}
+
+#else
+
+static int flash_hw_init (void)
+{
+    return ERR_FLASH_IO;
+}
+
+static int flash_hw_read (uint32_t addr, uint8_t * data, uint16_t len)
+{
+    (void)addr;
+    (void)data;
+    (void)len;
+
+    return ERR_FLASH_IO;
+}
+
+static int flash_hw_write (uint32_t addr, const uint8_t * data)
+{
+    (void)addr;
+    (void)data;
+
+    return ERR_FLASH_IO;
+}
+
+static int flash_hw_erase (uint32_t addr)
+{
+    (void)addr;
+
+    return ERR_FLASH_IO;
+}
+
+#endif
+
+/*****************************************************************************
+ * Public Functions                                                          *
+ *****************************************************************************/
+
+int flash_init (void)
+{
+    return flash_hw_init();
+}
+
+int flash_read (uint32_t addr, uint8_t * data, uint16_t len)
+{
+    int err = ERR_OK;
+
+    if (data == NULL)
+    {
+        return ERR_FLASH_NULL_POINTER;
+    }
+
+    err = flash_check(addr, len, 1);
+    if (err == ERR_OK)
+    {
+        err = flash_hw_read(addr, data, len);
+    }
+
+    return err;
+}
+
+int flash_write (uint32_t addr, const uint8_t * data)
+{
+    int err = ERR_OK;
+
+    if (data == NULL)
+    {
+        return ERR_FLASH_NULL_POINTER;
+    }
+
+    err = flash_check(addr, FLASH_WRITE_SIZE, FLASH_WRITE_SIZE);
+    if (err == ERR_OK)
+    {
+        err = flash_hw_write(addr, data);
+    }
+
+    return err;
+}
+
+int flash_erase (uint32_t addr)
+{
+    int err = flash_check(addr, FLASH_ERASE_SIZE, FLASH_ERASE_SIZE);
+
+    if (err == ERR_OK)
+    {
+        err = flash_hw_erase(addr);
+    }
+
+    return err;
+}
+
+#if defined(SURICATA_NATIVE)
+void flash_sim_cut (uint32_t ops)
+{
+    flash_cut_left = ops;
+    flash_cut_armed = (ops > 0);
+}
+#endif
+
+/* end of file */
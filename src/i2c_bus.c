@@ -0,0 +1,418 @@
+/*****************************************************************************
+ *                                                                           *
+ * \file i2c_bus.c                                                           *
+ *                                                                           *
+ * \brief Non-blocking I2C master with a transfer queue.                     *
+ *                                                                           *
+ * \author blackchacal <ribeiro.tonet@gmail.com>                             *
+ * \date Oct 17, 2026                                                        *
+ *                                                                           *
+ * \version 1.0 | \author blackchacal                                        *
+ * File creation.                                                            *
+ *                                                                           *
+ *****************************************************************************/
+
+/*****************************************************************************
+ * Includes                                                                  *
+ *****************************************************************************/
+
+/* --- Standard libraries -------------------- */
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+/* --- Arduino libraries -------------------- */
+#include <Arduino.h>
+#if defined(ARDUINO_ARCH_SAMD)
+#include <wiring_private.h>
+#endif
+
+/* --- Custom modules -------------------- */
+#include "i2c_bus.h"
+
+/*****************************************************************************
+ * Macros                                                                    *
+ *****************************************************************************/
+
+#if defined(ARDUINO_ARCH_SAMD)
+/* The Wire pins; the Wire library must not be linked as well. */
+#define I2C_REGS            (&SERCOM4->I2CM)
+#define I2C_IRQN            SERCOM4_IRQn
+#define I2C_HANDLER         SERCOM4_Handler
+#define I2C_GCLK_ID         GCLK_CLKCTRL_ID_SERCOM4_CORE
+#define I2C_APB_MASK        PM_APBCMASK_SERCOM4
+#define I2C_RISE_NS         125UL
+
+#define I2C_CMD_READ        (2)
+#define I2C_CMD_STOP        (3)
+#endif
+
+/*****************************************************************************
+ * Static Variables                                                          *
+ *****************************************************************************/
+
+/* Queue, head is the transfer on the bus. Shared with the bus interrupt. */
+static i2c_xfer_t * volatile i2c_head = NULL;
+static i2c_xfer_t * volatile i2c_tail = NULL;
+static bool i2c_ready = false;
+
+#if defined(ARDUINO_ARCH_SAMD)
+static volatile uint8_t i2c_pos = 0;
+static volatile bool i2c_reading = false;
+#elif defined(SURICATA_NATIVE)
+typedef struct
+{
+    uint8_t addr;
+    const i2c_mock_step_t * steps;
+    uint8_t count;
+    uint8_t next;
+} i2c_mock_t;
+
+static i2c_mock_t i2c_mocks[I2C_MOCK_DEVICES];
+static uint8_t i2c_mock_count = 0;
+static uint32_t i2c_clock = I2C_BUS_CLOCK_HZ;
+static uint32_t i2c_started = 0;
+static uint32_t i2c_duration = 0;
+#endif
+
+/*****************************************************************************
+ * Private Functions                                                         *
+ *****************************************************************************/
+
+static void i2c_start (i2c_xfer_t * xfer);
+
+/**
+ * @brief Ends the transfer on the bus and starts the next one. Called with
+ * the bus interrupt masked or from it.
+ */
+static void i2c_finish (int8_t result)
+{
+    i2c_xfer_t * xfer = i2c_head;
+
+    i2c_head = xfer->next;
+    if (i2c_head == NULL)
+    {
+        i2c_tail = NULL;
+    }
+    xfer->next = NULL;
+    xfer->result = result;
+
+    if (i2c_head != NULL)
+    {
+        i2c_start(i2c_head);
+    }
+}
+
+#if defined(ARDUINO_ARCH_SAMD)
+
+static void i2c_sync (void)
+{
+    while (I2C_REGS->SYNCBUSY.reg)
+    {
+    }
+}
+
+static void i2c_start (i2c_xfer_t * xfer)
+{
+    i2c_pos = 0;
+    i2c_reading = (xfer->tx_len == 0) && (xfer->rx_len > 0);
+    I2C_REGS->ADDR.reg = (uint32_t)((xfer->addr << 1) | (i2c_reading ? 1U : 0U));
+}
+
+static void i2c_command (uint32_t cmd, bool nack)
+{
+    I2C_REGS->CTRLB.reg = (I2C_REGS->CTRLB.reg & ~(SERCOM_I2CM_CTRLB_CMD_Msk | SERCOM_I2CM_CTRLB_ACKACT)) |
+                          SERCOM_I2CM_CTRLB_CMD(cmd) | (nack ? SERCOM_I2CM_CTRLB_ACKACT : 0);
+    i2c_sync();
+}
+
+/**
+ * @brief SERCOM interrupt: MB after each address or byte written, SB after
+ * each byte read.
+ */
+void I2C_HANDLER (void)
+{
+    uint8_t flags = I2C_REGS->INTFLAG.reg;
+    i2c_xfer_t * xfer = i2c_head;
+
+    if (xfer == NULL)
+    {
+        I2C_REGS->INTFLAG.reg = flags;
+        return;
+    }
+
+    if (flags & SERCOM_I2CM_INTFLAG_ERROR)
+    {
+        I2C_REGS->INTFLAG.reg = SERCOM_I2CM_INTFLAG_ERROR;
+        I2C_REGS->STATUS.reg = SERCOM_I2CM_STATUS_BUSERR | SERCOM_I2CM_STATUS_ARBLOST;
+        i2c_command(I2C_CMD_STOP, true);
+        i2c_finish(ERR_I2C_BUS);
+    }
+    else if (flags & SERCOM_I2CM_INTFLAG_MB)
+    {
+        if (I2C_REGS->STATUS.bit.ARBLOST)
+        {
+            /* Writing ADDR or a command clears MB; arbitration lost needs the
+             * flag cleared by hand and leaves the bus to the other master. */
+            I2C_REGS->INTFLAG.reg = SERCOM_I2CM_INTFLAG_MB;
+            i2c_finish(ERR_I2C_BUS);
+        }
+        else if (I2C_REGS->STATUS.bit.RXNACK || i2c_reading)
+        {
+            /* NACKed, or a read address that was not acknowledged. */
+            i2c_command(I2C_CMD_STOP, true);
+            i2c_finish(ERR_I2C_NACK);
+        }
+        else if (i2c_pos < xfer->tx_len)
+        {
+            I2C_REGS->DATA.reg = xfer->tx[i2c_pos++];
+        }
+        else if (xfer->rx_len > 0)
+        {
+            /* Repeated start into the read phase. */
+            i2c_pos = 0;
+            i2c_reading = true;
+            I2C_REGS->ADDR.reg = (uint32_t)((xfer->addr << 1) | 1U);
+        }
+        else
+        {
+            i2c_command(I2C_CMD_STOP, false);
+            i2c_finish(ERR_OK);
+        }
+    }
+    else if (flags & SERCOM_I2CM_INTFLAG_SB)
+    {
+        uint8_t pos = i2c_pos;
+
+        /* NACK and stop are set before reading the last byte, so the bus
+         * does not clock in one more. */
+        if (pos + 1 >= xfer->rx_len)
+        {
+            i2c_command(I2C_CMD_STOP, true);
+            xfer->rx[pos] = I2C_REGS->DATA.reg;
+            i2c_finish(ERR_OK);
+        }
+        else
+        {
+            xfer->rx[pos] = I2C_REGS->DATA.reg;
+            i2c_pos = (uint8_t)(pos + 1);
+            i2c_command(I2C_CMD_READ, false);
+        }
+    }
+}
+
+static int i2c_hw_init (uint32_t clock_hz)
+{
+    uint32_t baud = SystemCoreClock / (2 * clock_hz) - 5 -
+                    ((SystemCoreClock / 1000000UL) * I2C_RISE_NS) / 2000UL;
+
+    pinPeripheral(PIN_WIRE_SDA, g_APinDescription[PIN_WIRE_SDA].ulPinType);
+    pinPeripheral(PIN_WIRE_SCL, g_APinDescription[PIN_WIRE_SCL].ulPinType);
+
+    PM->APBCMASK.reg |= I2C_APB_MASK;
+    GCLK->CLKCTRL.reg = (uint16_t)(GCLK_CLKCTRL_CLKEN | GCLK_CLKCTRL_GEN_GCLK0 | I2C_GCLK_ID);
+    while (GCLK->STATUS.bit.SYNCBUSY)
+    {
+    }
+
+    I2C_REGS->CTRLA.reg = SERCOM_I2CM_CTRLA_SWRST;
+    while (I2C_REGS->CTRLA.bit.SWRST || I2C_REGS->SYNCBUSY.bit.SWRST)
+    {
+    }
+
+    I2C_REGS->CTRLA.reg = SERCOM_I2CM_CTRLA_MODE_I2C_MASTER;
+    I2C_REGS->BAUD.reg = SERCOM_I2CM_BAUD_BAUD(baud);
+    I2C_REGS->INTENSET.reg = SERCOM_I2CM_INTENSET_MB | SERCOM_I2CM_INTENSET_SB |
+                             SERCOM_I2CM_INTENSET_ERROR;
+
+    I2C_REGS->CTRLA.bit.ENABLE = 1;
+    i2c_sync();
+    /* Force the bus state machine to idle, it starts as unknown. */
+    I2C_REGS->STATUS.bit.BUSSTATE = 1;
+    i2c_sync();
+
+    NVIC_ClearPendingIRQ(I2C_IRQN);
+    NVIC_SetPriority(I2C_IRQN, 2);
+    NVIC_EnableIRQ(I2C_IRQN);
+
+    return ERR_OK;
+}
+
+#elif defined(SURICATA_NATIVE)
+
+static bool i2c_mock_match (const i2c_mock_step_t * step, const i2c_xfer_t * xfer)
+{
+    return (step->tx_len == xfer->tx_len) && (step->rx_len == xfer->rx_len) &&
+           ((xfer->tx_len == 0) || (memcmp(step->tx, xfer->tx, xfer->tx_len) == 0));
+}
+
+/**
+ * @brief Bus time of a transfer: 9 clocks per address and data byte, plus
+ * start, repeated start and stop.
+ */
+static void i2c_start (i2c_xfer_t * xfer)
+{
+    uint32_t bytes = 1U + xfer->tx_len + xfer->rx_len + ((xfer->tx_len && xfer->rx_len) ? 1U : 0U);
+
+    i2c_started = micros();
+    i2c_duration = (uint32_t)(((uint64_t)bytes * 9U + 3U) * 1000000ULL / i2c_clock);
+}
+
+/**
+ * @brief Answers the transfer on the bus from the recorded steps.
+ */
+static int8_t i2c_mock_reply (i2c_xfer_t * xfer)
+{
+    for (uint8_t i = 0; i < i2c_mock_count; i++)
+    {
+        i2c_mock_t * dev = &i2c_mocks[i];
+        const i2c_mock_step_t * step = NULL;
+
+        if (dev->addr != xfer->addr)
+        {
+            continue;
+        }
+
+        step = &dev->steps[dev->next];
+        if (!i2c_mock_match(step, xfer))
+        {
+            return ERR_I2C_NACK;
+        }
+        if (xfer->rx_len > 0)
+        {
+            memcpy(xfer->rx, step->rx, xfer->rx_len);
+        }
+        dev->next = (uint8_t)((dev->next + 1) % dev->count);
+
+        return ERR_OK;
+    }
+
+    return ERR_I2C_NACK;
+}
+
+static int i2c_hw_init (uint32_t clock_hz)
+{
+    i2c_clock = clock_hz;
+
+    return ERR_OK;
+}
+
+#else
+
+static void i2c_start (i2c_xfer_t * xfer)
+{
+    (void)xfer;
+    i2c_finish(ERR_I2C_BUS);
+}
+
+static int i2c_hw_init (uint32_t clock_hz)
+{
+    (void)clock_hz;
+
+    return ERR_I2C_NOT_INIT;
+}
+
+#endif
+
+/*****************************************************************************
+ * Public Functions                                                          *
+ *****************************************************************************/
+
+int i2c_bus_init (uint32_t clock_hz)
+{
+    int err = ERR_OK;
+
+    if (clock_hz == 0)
+    {
+        clock_hz = I2C_BUS_CLOCK_HZ;
+    }
+
+    i2c_head = NULL;
+    i2c_tail = NULL;
+    err = i2c_hw_init(clock_hz);
+    i2c_ready = (err == ERR_OK);
+
+    return err;
+}
+
+int i2c_submit (i2c_xfer_t * xfer)
+{
+    if (xfer == NULL)
+    {
+        return ERR_I2C_NULL_POINTER;
+    }
+    if ((xfer->tx_len > 0 && xfer->tx == NULL) || (xfer->rx_len > 0 && xfer->rx == NULL))
+    {
+        return ERR_I2C_NULL_POINTER;
+    }
+    if (!i2c_ready)
+    {
+        return ERR_I2C_NOT_INIT;
+    }
+    if (xfer->result == I2C_XFER_PENDING)
+    {
+        return ERR_I2C_BUSY;
+    }
+
+    xfer->result = I2C_XFER_PENDING;
+    xfer->next = NULL;
+
+    noInterrupts();
+    if (i2c_tail == NULL)
+    {
+        i2c_head = xfer;
+        i2c_tail = xfer;
+        i2c_start(xfer);
+    }
+    else
+    {
+        i2c_tail->next = xfer;
+        i2c_tail = xfer;
+    }
+    interrupts();
+
+    return ERR_OK;
+}
+
+void i2c_bus_poll (void)
+{
+#if defined(SURICATA_NATIVE)
+    /* Completes every transfer whose bus time has passed, each one starting
+     * when the previous one ended. */
+    while ((i2c_head != NULL) && ((uint32_t)(micros() - i2c_started) >= i2c_duration))
+    {
+        uint32_t end = i2c_started + i2c_duration;
+
+        i2c_finish(i2c_mock_reply(i2c_head));
+        if (i2c_head != NULL)
+        {
+            i2c_started = end;
+        }
+    }
+#endif
+}
+
+#if defined(SURICATA_NATIVE)
+int i2c_mock_device (uint8_t addr, const i2c_mock_step_t * steps, uint8_t count)
+{
+    if ((steps == NULL) || (count == 0))
+    {
+        return ERR_I2C_NULL_POINTER;
+    }
+    if (i2c_mock_count >= I2C_MOCK_DEVICES)
+    {
+        return ERR_I2C_BUSY;
+    }
+
+    i2c_mocks[i2c_mock_count].addr = addr;
+    i2c_mocks[i2c_mock_count].steps = steps;
+    i2c_mocks[i2c_mock_count].count = count;
+    i2c_mocks[i2c_mock_count].next = 0;
+    i2c_mock_count++;
+
+    return ERR_OK;
+}
+#endif
+
+/* end of file */
@@ -0,0 +1,572 @@
+/*****************************************************************************
+ *                                                                           *
+ * \file log_fmt.c                                                           *
+ *                                                                           *
+ * \brief Small printf-style formatter used by the logger.                   *
+ *                                                                           *
+ * \author blackchacal <ribeiro.tonet@gmail.com>                             *
+ * \date Oct 17, 2026                                                        *
+ *                                                                           *
+ * \version 1.0 | \author blackchacal                                        *
+ * File creation.                                                            *
+ *                                                                           *
+ *****************************************************************************/
+
+/*****************************************************************************
+ * Includes                                                                  *
+ *****************************************************************************/
+
+/* --- Standard libraries -------------------- */
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdarg.h>
+#include <stddef.h>
+
+/* --- Custom modules -------------------- */
+#include "log_fmt.h"
+
+/*****************************************************************************
+ * Macros                                                                    *
+ *****************************************************************************/
+
+/* 20 digits of a 64 bit value, a decimal point and a leading zero. */
+#define LOG_FMT_DIGITS      (24)
+
+/* 32 bit words a captured argument takes. Pointers take two on 64 bit hosts. */
+#define LOG_FMT_WORDS(kind) \
+    ((((kind) == LOG_FMT_ARG_LLONG) || ((kind) == LOG_FMT_ARG_ULLONG) || \
+      (((kind) == LOG_FMT_ARG_PTR) && (sizeof(void *) > sizeof(uint32_t)))) ? 2 : 1)
+
+#define LOG_FMT_LEFT        (0x01)
+#define LOG_FMT_ZERO        (0x02)
+#define LOG_FMT_UPPER       (0x04)
+#define LOG_FMT_PLUS        (0x08)
+
+/*****************************************************************************
+ * Datatypes                                                                 *
+ *****************************************************************************/
+
+/**
+ * \struct log_fmt_spec_t
+ * One parsed conversion specification.
+ */
+typedef struct
+{
+    uint8_t flags;
+    uint8_t width;
+    int8_t prec;            /* -1 when absent */
+    uint8_t longs;          /* number of 'l' modifiers */
+} log_fmt_spec_t;
+
+/**
+ * \struct log_fmt_va_args_t
+ * Argument reader over a va_list.
+ */
+typedef struct
+{
+    log_fmt_args_t base;
+    va_list vargs;
+} log_fmt_va_args_t;
+
+/*****************************************************************************
+ * Private Functions                                                         *
+ *****************************************************************************/
+
+static void log_fmt_pad (log_fmt_t * out, char c, uint16_t n)
+{
+    while (n-- > 0)
+    {
+        log_fmt_putc(out, c);
+    }
+}
+
+/**
+ * @brief Writes digits (most significant first) with sign and padding as
+ * the specification asks. A precision is the least number of digits,
+ * made up with leading zeros.
+ */
+static void log_fmt_field (log_fmt_t * out, const log_fmt_spec_t * spec, char sign,
+                           const char * digits, uint8_t ndigits)
+{
+    uint16_t zeros = (spec->prec > ndigits) ? (uint16_t)(spec->prec - ndigits) : 0;
+    uint16_t len = zeros + ndigits + ((sign != '\0') ? 1 : 0);
+    uint16_t pad = (spec->width > len) ? (spec->width - len) : 0;
+
+    if ((spec->flags & (LOG_FMT_LEFT | LOG_FMT_ZERO)) == 0)
+    {
+        log_fmt_pad(out, ' ', pad);
+    }
+    if (sign != '\0')
+    {
+        log_fmt_putc(out, sign);
+    }
+    if ((spec->flags & (LOG_FMT_LEFT | LOG_FMT_ZERO)) == LOG_FMT_ZERO)
+    {
+        log_fmt_pad(out, '0', pad);
+    }
+    log_fmt_pad(out, '0', zeros);
+    while (ndigits-- > 0)
+    {
+        log_fmt_putc(out, *digits++);
+    }
+    if (spec->flags & LOG_FMT_LEFT)
+    {
+        log_fmt_pad(out, ' ', pad);
+    }
+}
+
+/**
+ * @brief Formats value in base 10 or 16. frac > 0 places a decimal point
+ * frac digits from the right, for the fixed-point conversion. As in printf,
+ * a precision of 0 prints nothing for a 0 value.
+ */
+static void log_fmt_number (log_fmt_t * out, const log_fmt_spec_t * spec, uint64_t value,
+                            bool negative, uint8_t base, uint8_t frac)
+{
+    const char * hex = (spec->flags & LOG_FMT_UPPER) ? "0123456789ABCDEF" : "0123456789abcdef";
+    char tmp[LOG_FMT_DIGITS];
+    uint8_t pos = LOG_FMT_DIGITS;
+    uint8_t n = 0;
+
+    if (frac > LOG_FMT_DIGITS - 3)
+    {
+        frac = LOG_FMT_DIGITS - 3;
+    }
+
+    /* Digits are produced from the right. 32 bit values avoid the 64 bit
+     * division helpers, which are slow on a Cortex-M0+. */
+    while ((value != 0) || ((frac > 0) && (n <= frac)) || ((n == 0) && (spec->prec != 0)))
+    {
+        if (value >> 32)
+        {
+            tmp[--pos] = hex[value % base];
+            value /= base;
+        }
+        else
+        {
+            uint32_t v32 = (uint32_t)value;
+            tmp[--pos] = hex[v32 % base];
+            value = v32 / base;
+        }
+        if (++n == frac)
+        {
+            tmp[--pos] = '.';
+        }
+    }
+
+    log_fmt_field(out, spec, negative ? '-' : ((spec->flags & LOG_FMT_PLUS) ? '+' : '\0'),
+                  &tmp[pos], LOG_FMT_DIGITS - pos);
+}
+
+/**
+ * @brief Parses flags, width, precision and length after a '%'. Returns
+ * the position of the conversion character.
+ */
+static const char * log_fmt_parse (const char * p, log_fmt_spec_t * spec)
+{
+    spec->flags = 0;
+    spec->width = 0;
+    spec->prec = -1;
+    spec->longs = 0;
+
+    for (;; p++)
+    {
+        if (*p == '-')
+        {
+            spec->flags |= LOG_FMT_LEFT;
+        }
+        else if (*p == '0')
+        {
+            spec->flags |= LOG_FMT_ZERO;
+        }
+        else if (*p == '+')
+        {
+            spec->flags |= LOG_FMT_PLUS;
+        }
+        else
+        {
+            break;
+        }
+    }
+    while ((*p >= '0') && (*p <= '9'))
+    {
+        spec->width = (uint8_t)(spec->width * 10 + (*p++ - '0'));
+    }
+    if (*p == '.')
+    {
+        spec->prec = 0;
+        p++;
+        while ((*p >= '0') && (*p <= '9'))
+        {
+            spec->prec = (int8_t)(spec->prec * 10 + (*p++ - '0'));
+        }
+    }
+    while (*p == 'l')
+    {
+        spec->longs++;
+        p++;
+    }
+
+    return p;
+}
+
+/**
+ * @brief Kind of argument a conversion consumes, LOG_FMT_ARG_NONE if it
+ * takes none.
+ */
+static uint8_t log_fmt_kind (char conv, uint8_t longs)
+{
+    uint8_t kind = LOG_FMT_ARG_NONE;
+
+    switch (conv)
+    {
+        case 'd':
+        case 'i':
+        case 'k':
+            kind = (longs >= 2) ? LOG_FMT_ARG_LLONG : ((longs == 1) ? LOG_FMT_ARG_LONG : LOG_FMT_ARG_INT);
+            break;
+
+        case 'u':
+        case 'x':
+        case 'X':
+            kind = (longs >= 2) ? LOG_FMT_ARG_ULLONG : ((longs == 1) ? LOG_FMT_ARG_ULONG : LOG_FMT_ARG_UINT);
+            break;
+
+        case 'c':
+            kind = LOG_FMT_ARG_INT;
+            break;
+
+        case 's':
+            kind = LOG_FMT_ARG_PTR;
+            break;
+
+        default:
+            break;
+    }
+
+    return kind;
+}
+
+/**
+ * @brief Argument reader over a va_list.
+ */
+static uint64_t log_fmt_va_read (log_fmt_args_t * base, uint8_t kind)
+{
+    log_fmt_va_args_t * args = (log_fmt_va_args_t *)base;
+    uint64_t v = 0;
+
+    switch (kind)
+    {
+        case LOG_FMT_ARG_INT:    v = (uint64_t)(int64_t)va_arg(args->vargs, int);         break;
+        case LOG_FMT_ARG_UINT:   v = va_arg(args->vargs, unsigned int);                   break;
+        case LOG_FMT_ARG_LONG:   v = (uint64_t)(int64_t)va_arg(args->vargs, long);        break;
+        case LOG_FMT_ARG_ULONG:  v = va_arg(args->vargs, unsigned long);                  break;
+        case LOG_FMT_ARG_LLONG:  v = (uint64_t)va_arg(args->vargs, long long);            break;
+        case LOG_FMT_ARG_ULLONG: v = va_arg(args->vargs, unsigned long long);             break;
+        case LOG_FMT_ARG_PTR:    v = (uintptr_t)va_arg(args->vargs, const void *);        break;
+        default:                                                                          break;
+    }
+
+    return v;
+}
+
+/**
+ * @brief Argument reader over captured 32 bit words. 64 bit kinds take two
+ * words, low first. Missing arguments read as 0.
+ */
+static uint64_t log_fmt_raw_read (log_fmt_args_t * base, uint8_t kind)
+{
+    log_fmt_raw_args_t * args = (log_fmt_raw_args_t *)base;
+    uint64_t v = 0;
+
+    if (args->pos < args->argc)
+    {
+        v = args->argv[args->pos++];
+    }
+
+    switch (kind)
+    {
+        case LOG_FMT_ARG_INT:
+        case LOG_FMT_ARG_LONG:
+            v = (uint64_t)(int64_t)(int32_t)v;
+            break;
+
+        case LOG_FMT_ARG_PTR:
+            if (LOG_FMT_WORDS(kind) == 1)
+            {
+                break;
+            }
+            /* fall through */
+        case LOG_FMT_ARG_LLONG:
+        case LOG_FMT_ARG_ULLONG:
+            if (args->pos < args->argc)
+            {
+                v |= (uint64_t)args->argv[args->pos++] << 32;
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    return v;
+}
+
+/*****************************************************************************
+ * Public Functions                                                          *
+ *****************************************************************************/
+
+void log_fmt_init (log_fmt_t * out, char * buf, uint16_t size)
+{
+    out->buf = buf;
+    out->size = size;
+    out->len = 0;
+    out->truncated = false;
+}
+
+void log_fmt_putc (log_fmt_t * out, char c)
+{
+    if (out->len < out->size)
+    {
+        out->buf[out->len++] = c;
+    }
+    else
+    {
+        out->truncated = true;
+    }
+}
+
+void log_fmt_puts (log_fmt_t * out, const char * s)
+{
+    if (s == NULL)
+    {
+        s = "(null)";
+    }
+    while (*s != '\0')
+    {
+        log_fmt_putc(out, *s++);
+    }
+}
+
+void log_fmt_format (log_fmt_t * out, const char * fmt, log_fmt_args_t * args)
+{
+    log_fmt_spec_t spec;
+    const char * start;
+
+    while (*fmt != '\0')
+    {
+        if (*fmt != '%')
+        {
+            log_fmt_putc(out, *fmt++);
+            continue;
+        }
+
+        start = fmt;
+        fmt = log_fmt_parse(fmt + 1, &spec);
+
+        switch (*fmt)
+        {
+            case 'd':
+            case 'i':
+            case 'k':
+            {
+                int64_t v = (int64_t)args->read(args, log_fmt_kind(*fmt, spec.longs));
+                uint8_t frac = 0;
+
+                if (*fmt == 'k')
+                {
+                    /* The precision places the point, it does not pad. */
+                    frac = (spec.prec > 0) ? (uint8_t)spec.prec : 0;
+                    spec.prec = -1;
+                }
+                else if (spec.prec >= 0)
+                {
+                    spec.flags &= ~LOG_FMT_ZERO;
+                }
+                log_fmt_number(out, &spec, (v < 0) ? (0 - (uint64_t)v) : (uint64_t)v, v < 0, 10, frac);
+                break;
+            }
+
+            case 'u':
+            case 'x':
+            case 'X':
+            {
+                uint64_t v = args->read(args, log_fmt_kind(*fmt, spec.longs));
+
+                if (*fmt == 'X')
+                {
+                    spec.flags |= LOG_FMT_UPPER;
+                }
+                if (spec.prec >= 0)
+                {
+                    spec.flags &= ~LOG_FMT_ZERO;
+                }
+                spec.flags &= ~LOG_FMT_PLUS;
+                log_fmt_number(out, &spec, v, false, (*fmt == 'u') ? 10 : 16, 0);
+                break;
+            }
+
+            case 'c':
+            {
+                char c = (char)args->read(args, LOG_FMT_ARG_INT);
+                spec.flags &= ~LOG_FMT_ZERO;
+                spec.prec = -1;
+                log_fmt_field(out, &spec, '\0', &c, 1);
+                break;
+            }
+
+            case 's':
+            {
+                const char * s = (const char *)(uintptr_t)args->read(args, LOG_FMT_ARG_PTR);
+                uint16_t n = 0;
+
+                if (s == NULL)
+                {
+                    s = "(null)";
+                }
+                while ((s[n] != '\0') && ((spec.prec < 0) || (n < (uint16_t)spec.prec)))
+                {
+                    n++;
+                }
+                spec.flags &= ~LOG_FMT_ZERO;
+                if ((spec.width > n) && !(spec.flags & LOG_FMT_LEFT))
+                {
+                    log_fmt_pad(out, ' ', spec.width - n);
+                }
+                for (uint16_t i = 0; i < n; i++)
+                {
+                    log_fmt_putc(out, s[i]);
+                }
+                if ((spec.width > n) && (spec.flags & LOG_FMT_LEFT))
+                {
+                    log_fmt_pad(out, ' ', spec.width - n);
+                }
+                break;
+            }
+
+            case '%':
+                log_fmt_putc(out, '%');
+                break;
+
+            default:
+                /* Unsupported: copy the specification verbatim. */
+                while ((start <= fmt) && (*start != '\0'))
+                {
+                    log_fmt_putc(out, *start++);
+                }
+                if (*fmt == '\0')
+                {
+                    return;
+                }
+                break;
+        }
+        fmt++;
+    }
+}
+
+void log_fmt_vprintf (log_fmt_t * out, const char * fmt, va_list vargs)
+{
+    log_fmt_va_args_t args;
+
+    args.base.read = log_fmt_va_read;
+    va_copy(args.vargs, vargs);
+    log_fmt_format(out, fmt, &args.base);
+    va_end(args.vargs);
+}
+
+void log_fmt_printf (log_fmt_t * out, const char * fmt, ...)
+{
+    va_list vargs;
+    va_start(vargs, fmt);
+    log_fmt_vprintf(out, fmt, vargs);
+    va_end(vargs);
+}
+
+uint8_t log_fmt_capture (const char * fmt, va_list vargs, uint32_t * argv, uint8_t max)
+{
+    log_fmt_va_args_t args;
+    log_fmt_spec_t spec;
+    uint8_t argc = 0;
+
+    args.base.read = log_fmt_va_read;
+    va_copy(args.vargs, vargs);
+
+    while (*fmt != '\0')
+    {
+        if (*fmt++ != '%')
+        {
+            continue;
+        }
+
+        fmt = log_fmt_parse(fmt, &spec);
+        if (*fmt == '\0')
+        {
+            break;
+        }
+
+        uint8_t kind = log_fmt_kind(*fmt++, spec.longs);
+        if (kind == LOG_FMT_ARG_NONE)
+        {
+            continue;
+        }
+
+        uint8_t words = LOG_FMT_WORDS(kind);
+        if ((argc + words) > max)
+        {
+            break;
+        }
+
+        uint64_t v = args.base.read(&args.base, kind);
+        argv[argc++] = (uint32_t)v;
+        if (words == 2)
+        {
+            argv[argc++] = (uint32_t)(v >> 32);
+        }
+    }
+
+    va_end(args.vargs);
+
+    return argc;
+}
+
+void log_fmt_walk (const char * fmt, va_list vargs, log_fmt_visit_t fn, void * ctx)
+{
+    log_fmt_va_args_t args;
+    log_fmt_spec_t spec;
+
+    args.base.read = log_fmt_va_read;
+    va_copy(args.vargs, vargs);
+
+    while (*fmt != '\0')
+    {
+        if (*fmt++ != '%')
+        {
+            continue;
+        }
+
+        fmt = log_fmt_parse(fmt, &spec);
+        if (*fmt == '\0')
+        {
+            break;
+        }
+
+        char conv = *fmt++;
+        uint8_t kind = log_fmt_kind(conv, spec.longs);
+        if (kind != LOG_FMT_ARG_NONE)
+        {
+            fn(ctx, conv, args.base.read(&args.base, kind));
+        }
+    }
+
+    va_end(args.vargs);
+}
+
+void log_fmt_raw_init (log_fmt_raw_args_t * args, const uint32_t * argv, uint8_t argc)
+{
+    args->base.read = log_fmt_raw_read;
+    args->argv = argv;
+    args->argc = argc;
+    args->pos = 0;
+}
+
+/* end of file */
@@ -0,0 +1,243 @@
+/*****************************************************************************
+ *                                                                           *
+ * \file log_isr.c                                                           *
+ *                                                                           *
+ * \brief Lock-free capture of log lines written from interrupt handlers.    *
+ *                                                                           *
+ * \author blackchacal <ribeiro.tonet@gmail.com>                             *
+ * \date Oct 17, 2026                                                        *
+ *                                                                           *
+ * \version 1.0 | \author blackchacal                                        *
+ * File creation.                                                            *
+ *                                                                           *
+ *****************************************************************************/
+
+/*****************************************************************************
+ * Includes                                                                  *
+ *****************************************************************************/
+
+/* --- Standard libraries -------------------- */
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#if defined(SURICATA_NATIVE)
+/* --- Arduino libraries -------------------- */
+#include <Arduino.h>
+#endif
+
+/* --- Custom modules -------------------- */
+#include "log_isr.h"
+#include "log_fmt.h"
+
+/*****************************************************************************
+ * Macros                                                                    *
+ *****************************************************************************/
+
+#define LOG_ISR_FREE        (0)
+#define LOG_ISR_BUSY        (1)
+#define LOG_ISR_READY       (2)
+
+#define LOAD_ACQUIRE(p)     __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define STORE_RELEASE(p, v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+
+/*****************************************************************************
+ * Static Variables                                                          *
+ *****************************************************************************/
+
+static log_isr_slot_t log_isr_slots[LOG_ISR_SLOTS];
+static uint32_t log_isr_seq = 0;           /* Next number to hand out. */
+static uint32_t log_isr_out = 0;           /* Next number to read. */
+static uint32_t log_isr_drops = 0;
+
+/*****************************************************************************
+ * Private Functions                                                         *
+ *****************************************************************************/
+
+#if defined(__ARM_ARCH_6M__)
+
+/* No LDREX/STREX: mask interrupts around the few instructions instead. */
+static inline uint32_t log_isr_lock (void)
+{
+    uint32_t primask;
+    __asm volatile ("mrs %0, primask" : "=r" (primask));
+    __asm volatile ("cpsid i" ::: "memory");
+    return primask;
+}
+
+static inline void log_isr_unlock (uint32_t primask)
+{
+    __asm volatile ("msr primask, %0" :: "r" (primask) : "memory");
+}
+
+/**
+ * @brief Claims a free slot and numbers it. Returns NULL if none is free.
+ */
+static log_isr_slot_t * log_isr_claim (void)
+{
+    log_isr_slot_t * slot = NULL;
+    uint32_t primask = log_isr_lock();
+
+    for (uint8_t i = 0; i < LOG_ISR_SLOTS; i++)
+    {
+        if (log_isr_slots[i].state == LOG_ISR_FREE)
+        {
+            slot = &log_isr_slots[i];
+            slot->state = LOG_ISR_BUSY;
+            slot->seq = log_isr_seq++;
+            break;
+        }
+    }
+    if (slot == NULL)
+    {
+        log_isr_drops++;
+    }
+
+    log_isr_unlock(primask);
+
+    return slot;
+}
+
+static void log_isr_drop (void)
+{
+    uint32_t primask = log_isr_lock();
+    log_isr_drops++;
+    log_isr_unlock(primask);
+}
+
+#else
+
+static void log_isr_drop (void)
+{
+    __atomic_fetch_add(&log_isr_drops, 1, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Claims a free slot, then numbers it. A number is only taken once
+ * a slot is held, so the numbers have no gaps and log_isr_next can wait for
+ * exactly the next one: a line claimed but not yet numbered, or numbered
+ * and not yet ready, holds back every later line.
+ */
+static log_isr_slot_t * log_isr_claim (void)
+{
+    for (uint8_t i = 0; i < LOG_ISR_SLOTS; i++)
+    {
+        uint8_t expected = LOG_ISR_FREE;
+
+        if (__atomic_compare_exchange_n(&log_isr_slots[i].state, &expected, LOG_ISR_BUSY,
+                                        false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+        {
+            __atomic_store_n(&log_isr_slots[i].seq,
+                             __atomic_fetch_add(&log_isr_seq, 1, __ATOMIC_RELAXED),
+                             __ATOMIC_RELEASE);
+            return &log_isr_slots[i];
+        }
+    }
+
+    log_isr_drop();
+
+    return NULL;
+}
+
+#endif
+
+/*****************************************************************************
+ * Public Functions                                                          *
+ *****************************************************************************/
+
+bool log_isr_active (void)
+{
+#if defined(__arm__)
+    uint32_t ipsr;
+    __asm volatile ("mrs %0, ipsr" : "=r" (ipsr));
+    return (ipsr & 0x1FF) != 0;
+#else
+    return log_isr_host_hook();
+#endif
+}
+
+#if defined(SURICATA_NATIVE)
+bool log_isr_host_hook (void)
+{
+    return native_in_isr();
+}
+#elif !defined(__arm__)
+__attribute__((weak)) bool log_isr_host_hook (void)
+{
+    return false;
+}
+#endif
+
+bool log_isr_vcapture (uint8_t type, const char * tag, const char * fmt, va_list vargs)
+{
+    log_isr_slot_t * slot = log_isr_claim();
+
+    if (slot == NULL)
+    {
+        return false;
+    }
+
+    slot->type = type;
+    slot->u.text.tag = tag;
+    slot->u.text.fmt = fmt;
+    slot->len = log_fmt_capture(fmt, vargs, slot->u.text.argv, LOG_ISR_MAX_ARGS);
+    STORE_RELEASE(&slot->state, LOG_ISR_READY);
+
+    return true;
+}
+
+bool log_isr_frame (const uint8_t * frame, uint16_t len)
+{
+    log_isr_slot_t * slot;
+
+    if (len > LOG_ISR_FRAME_SIZE)
+    {
+        log_isr_drop();
+        return false;
+    }
+
+    slot = log_isr_claim();
+    if (slot == NULL)
+    {
+        return false;
+    }
+
+    slot->type = LOG_ISR_FRAME;
+    slot->len = (uint8_t)len;
+    memcpy(slot->u.frame, frame, len);
+    STORE_RELEASE(&slot->state, LOG_ISR_READY);
+
+    return true;
+}
+
+log_isr_slot_t * log_isr_next (void)
+{
+    for (uint8_t i = 0; i < LOG_ISR_SLOTS; i++)
+    {
+        log_isr_slot_t * slot = &log_isr_slots[i];
+
+        /* Keep the order: while the next number is claimed but not ready,
+         * wait for that interrupted writer rather than skip it. */
+        if ((LOAD_ACQUIRE(&slot->state) == LOG_ISR_READY) &&
+            (LOAD_ACQUIRE(&slot->seq) == log_isr_out))
+        {
+            return slot;
+        }
+    }
+
+    return NULL;
+}
+
+void log_isr_release (log_isr_slot_t * slot)
+{
+    log_isr_out++;
+    STORE_RELEASE(&slot->state, LOG_ISR_FREE);
+}
+
+uint32_t log_isr_dropped (void)
+{
+    return __atomic_load_n(&log_isr_drops, __ATOMIC_RELAXED);
+}
+
+/* end of file */
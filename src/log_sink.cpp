@@ -0,0 +1,490 @@
+/*****************************************************************************
+ *                                                                           *
+ * \file log_sink.cpp                                                        *
+ *                                                                           *
+ * \brief Built-in log sinks: serial, RAM, UDP and, on the host, file.       *
+ *                                                                           *
+ * \author blackchacal <ribeiro.tonet@gmail.com>                             *
+ * \date Oct 17, 2026                                                        *
+ *                                                                           *
+ * \version 1.0 | \author blackchacal                                        *
+ * File creation.                                                            *
+ *                                                                           *
+ *****************************************************************************/
+
+/*****************************************************************************
+ * Includes                                                                  *
+ *****************************************************************************/
+
+/* --- Standard libraries -------------------- */
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#if defined(SURICATA_NATIVE)
+#include <stdio.h>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+/* --- Arduino libraries -------------------- */
+#include <Arduino.h>
+#if defined(ARDUINO_ARCH_SAMD)
+#include <WiFiNINA.h>
+#include <WiFiUdp.h>
+#endif
+
+/* --- Custom modules -------------------- */
+#include "log_sink.h"
+#include "logger.h"
+#include "rbuffer.h"
+#include "meminfo.h"
+
+/*****************************************************************************
+ * Macros                                                                    *
+ *****************************************************************************/
+
+/* The file is written in batches, each flushed, so a crash loses at most
+ * what is still queued. */
+#define LOG_FILE_BATCH          512
+#define LOG_FILE_DELAY_US       1000000UL
+
+/*****************************************************************************
+ * Static Variables                                                          *
+ *****************************************************************************/
+
+static log_sink_t log_serial;
+#if LOG_DEFERRED_EN == 1
+static uint8_t log_buf[LOG_BUFFER_SIZE];
+#endif
+
+#if LOG_RAM_EN == 1
+static log_sink_t log_ram;
+static rbuffer_t log_ram_rb;
+static uint8_t log_ram_buf[LOG_RAM_SIZE];
+#endif
+
+#if LOG_UDP_EN == 1
+static log_sink_t log_udp;
+static uint8_t log_udp_dgram[LOG_UDP_DATAGRAM];
+#if LOG_DEFERRED_EN == 1
+static uint8_t log_udp_buf[LOG_UDP_BUFFER_SIZE];
+#endif
+#endif
+
+#if defined(ARDUINO_ARCH_SAMD) && (LOG_UDP_EN == 1)
+static WiFiUDP log_udp_sock;
+static IPAddress log_udp_ip;
+static bool log_udp_open = false;
+#elif defined(SURICATA_NATIVE) && (LOG_UDP_EN == 1)
+static int log_udp_sock = -1;
+static struct sockaddr_in log_udp_addr;
+#endif
+
+#if defined(SURICATA_NATIVE) && (LOG_FILE_EN == 1)
+static log_sink_t log_file;
+#if LOG_DEFERRED_EN == 1
+static uint8_t log_file_buf[LOG_FILE_BUFFER_SIZE];
+#endif
+#endif
+
+#if defined(SURICATA_NATIVE)
+static FILE * log_file_out = NULL;
+#endif
+
+/*****************************************************************************
+ * Private Functions                                                         *
+ *****************************************************************************/
+
+/* --- Serial ---------------------------------------------------------------*/
+
+/**
+ * @brief True while a host holds the port open. Nothing is written before:
+ * the SAMD21 would wait out a USB timeout per write, and the lines stay
+ * queued for a host that attaches late.
+ */
+static bool log_serial_host (void)
+{
+#if defined(ARDUINO_ARCH_SAMD)
+    return Serial.dtr();
+#else
+    return (bool)Serial;
+#endif
+}
+
+/**
+ * @brief Writes what the spans hold. A queued sink is written as long as
+ * the TX buffer has room, asked again after each chunk, so Serial.write
+ * never waits on a slow or stalled host and the rest stays queued. A sink
+ * without a queue has nowhere to keep a rest, so it gets the whole line.
+ */
+static uint16_t log_serial_write (log_sink_t * sink, const rbuffer_span_t * span, uint8_t count)
+{
+    uint16_t sent = 0;
+    bool queued = false;
+
+#if LOG_DEFERRED_EN == 1
+    queued = (sink->queue.buf != NULL);
+#else
+    (void)sink;
+#endif
+    if (!log_serial_host())
+    {
+        return 0;
+    }
+
+    for (uint8_t i = 0; (i < count) && (span[i].len > 0); i++)
+    {
+        uint16_t done = 0;
+
+        while (done < span[i].len)
+        {
+            uint16_t n = (uint16_t)(span[i].len - done);
+            uint16_t w = 0;
+
+            if (queued)
+            {
+                int room = Serial.availableForWrite();
+
+                if (room <= 0)
+                {
+                    return sent;
+                }
+                if (n > room)
+                {
+                    n = (uint16_t)room;
+                }
+            }
+
+            w = (uint16_t)Serial.write(span[i].ptr + done, n);
+            done += w;
+            sent += w;
+            if (w < n)
+            {
+                return sent;
+            }
+        }
+    }
+
+    return sent;
+}
+
+static void log_serial_flush (log_sink_t * sink)
+{
+    (void)sink;
+    Serial.flush();
+}
+
+/* --- RAM ------------------------------------------------------------------*/
+
+/**
+ * @brief Always takes everything: the ring drops its oldest bytes.
+ */
+static uint16_t log_ram_write (log_sink_t * sink, const rbuffer_span_t * span, uint8_t count)
+{
+    rbuffer_t * rb = (rbuffer_t *)sink->ctx;
+    uint16_t taken = 0;
+
+    for (uint8_t i = 0; i < count; i++)
+    {
+        const uint8_t * p = span[i].ptr;
+        uint16_t n = span[i].len;
+
+        /* Only the tail of a span larger than the ring would survive. */
+        if (n > rb->size)
+        {
+            p += n - rb->size;
+            n = rb->size;
+        }
+        if (n > 0)
+        {
+            rbuffer_add_bytes(rb, p, n);
+        }
+        taken += span[i].len;
+    }
+
+    return taken;
+}
+
+/* --- UDP ------------------------------------------------------------------*/
+
+#if LOG_UDP_EN == 1
+#if defined(ARDUINO_ARCH_SAMD)
+
+/**
+ * @brief The uplink joins the network; until then the lines stay queued.
+ */
+static bool log_udp_up (void)
+{
+    if (WiFi.status() != WL_CONNECTED)
+    {
+        log_udp_open = false;
+        return false;
+    }
+
+    if (!log_udp_open)
+    {
+        log_udp_open = log_udp_ip.fromString(LOG_UDP_HOST) &&
+                       (log_udp_sock.begin(LOG_UDP_PORT) == 1);
+    }
+
+    return log_udp_open;
+}
+
+static bool log_udp_send (const uint8_t * data, uint16_t len)
+{
+    return (log_udp_sock.beginPacket(log_udp_ip, LOG_UDP_PORT) == 1) &&
+           (log_udp_sock.write(data, len) == len) &&
+           (log_udp_sock.endPacket() == 1);
+}
+
+#elif defined(SURICATA_NATIVE)
+
+static bool log_udp_up (void)
+{
+    if (log_udp_sock >= 0)
+    {
+        return true;
+    }
+
+    memset(&log_udp_addr, 0, sizeof(log_udp_addr));
+    log_udp_addr.sin_family = AF_INET;
+    log_udp_addr.sin_port = htons(LOG_UDP_PORT);
+    if (inet_pton(AF_INET, LOG_UDP_HOST, &log_udp_addr.sin_addr) != 1)
+    {
+        return false;
+    }
+
+    log_udp_sock = socket(AF_INET, SOCK_DGRAM, 0);
+    if ((log_udp_sock >= 0) && (fcntl(log_udp_sock, F_SETFL, O_NONBLOCK) != 0))
+    {
+        close(log_udp_sock);
+        log_udp_sock = -1;
+    }
+
+    return log_udp_sock >= 0;
+}
+
+/**
+ * @brief Non-blocking: a full socket buffer refuses the datagram.
+ */
+static bool log_udp_send (const uint8_t * data, uint16_t len)
+{
+    ssize_t n = sendto(log_udp_sock, data, len, 0, (const struct sockaddr *)&log_udp_addr,
+                       sizeof(log_udp_addr));
+
+    return n == (ssize_t)len;
+}
+
+#else
+
+static bool log_udp_up (void)
+{
+    return false;
+}
+
+static bool log_udp_send (const uint8_t * data, uint16_t len)
+{
+    (void)data;
+    (void)len;
+
+    return false;
+}
+
+#endif
+#endif
+
+/**
+ * @brief Sends one datagram of what is queued. A text datagram that does
+ * not take it all ends at the last whole line, so a lost datagram loses
+ * whole lines.
+ */
+static uint16_t log_udp_write (log_sink_t * sink, const rbuffer_span_t * span, uint8_t count)
+{
+#if LOG_UDP_EN == 1
+    uint16_t len = 0;
+    bool all = true;
+
+    (void)sink;
+    if (!log_udp_up())
+    {
+        return 0;
+    }
+
+    for (uint8_t i = 0; i < count; i++)
+    {
+        uint16_t n = span[i].len;
+
+        if (n > (uint16_t)(LOG_UDP_DATAGRAM - len))
+        {
+            n = (uint16_t)(LOG_UDP_DATAGRAM - len);
+            all = false;
+        }
+        memcpy(&log_udp_dgram[len], span[i].ptr, n);
+        len += n;
+    }
+
+#if LOG_BINARY_EN == 0
+    if (!all)
+    {
+        uint16_t end = len;
+
+        while ((end > 0) && (log_udp_dgram[end - 1] != '\n'))
+        {
+            end--;
+        }
+        if (end > 0)
+        {
+            len = end;
+        }
+    }
+#else
+    (void)all;
+#endif
+
+    return ((len > 0) && log_udp_send(log_udp_dgram, len)) ? len : 0;
+#else
+    (void)sink;
+    (void)span;
+    (void)count;
+
+    return 0;
+#endif
+}
+
+/* --- File -----------------------------------------------------------------*/
+
+#if defined(SURICATA_NATIVE)
+static uint16_t log_file_write (log_sink_t * sink, const rbuffer_span_t * span, uint8_t count)
+{
+    uint16_t sent = 0;
+
+    (void)sink;
+    if (log_file_out == NULL)
+    {
+        log_file_out = fopen(LOG_FILE_PATH, "ab");
+        if (log_file_out == NULL)
+        {
+            return 0;
+        }
+    }
+
+    for (uint8_t i = 0; (i < count) && (span[i].len > 0); i++)
+    {
+        uint16_t w = (uint16_t)fwrite(span[i].ptr, 1, span[i].len, log_file_out);
+
+        sent += w;
+        if (w < span[i].len)
+        {
+            break;
+        }
+    }
+    fflush(log_file_out);
+
+    return sent;
+}
+#endif
+
+/*****************************************************************************
+ * Public Variables                                                          *
+ *****************************************************************************/
+
+const log_sink_driver_t log_sink_serial = {
+    "serial", log_serial_write, log_serial_flush, LOG_SERIAL_BATCH, LOG_SERIAL_DELAY_US
+};
+
+const log_sink_driver_t log_sink_ram = {
+    "ram", log_ram_write, NULL, 0, 0
+};
+
+const log_sink_driver_t log_sink_udp = {
+    "udp", log_udp_write, NULL, LOG_UDP_DATAGRAM * 3 / 4, LOG_UDP_DELAY_US
+};
+
+#if defined(SURICATA_NATIVE)
+const log_sink_driver_t log_sink_file = {
+    "file", log_file_write, NULL, LOG_FILE_BATCH, LOG_FILE_DELAY_US
+};
+#endif
+
+/*****************************************************************************
+ * Public Functions                                                          *
+ *****************************************************************************/
+
+void log_sink_builtin (void)
+{
+#if LOG_DEFERRED_EN == 1
+    log_sink_add(&log_serial, &log_sink_serial, NULL, LOG_SERIAL_LEVEL, log_buf, LOG_BUFFER_SIZE);
+    MEMINFO_REGISTER(log_buf);
+#else
+    log_sink_add(&log_serial, &log_sink_serial, NULL, LOG_SERIAL_LEVEL, NULL, 0);
+#endif
+
+#if LOG_RAM_EN == 1
+    rbuffer_init(&log_ram_rb, log_ram_buf, LOG_RAM_SIZE, RBUFFER_POLICY_OVERWRITE);
+    log_sink_add(&log_ram, &log_sink_ram, &log_ram_rb, LOG_RAM_LEVEL, NULL, 0);
+    MEMINFO_REGISTER(log_ram_buf);
+#endif
+
+#if LOG_UDP_EN == 1
+#if LOG_DEFERRED_EN == 1
+    log_sink_add(&log_udp, &log_sink_udp, NULL, LOG_UDP_LEVEL, log_udp_buf, LOG_UDP_BUFFER_SIZE);
+    MEMINFO_REGISTER(log_udp_buf);
+#else
+    log_sink_add(&log_udp, &log_sink_udp, NULL, LOG_UDP_LEVEL, NULL, 0);
+#endif
+    MEMINFO_REGISTER(log_udp_dgram);
+#endif
+
+#if defined(SURICATA_NATIVE) && (LOG_FILE_EN == 1)
+#if LOG_DEFERRED_EN == 1
+    log_sink_add(&log_file, &log_sink_file, NULL, LOG_FILE_LEVEL, log_file_buf, LOG_FILE_BUFFER_SIZE);
+#else
+    log_sink_add(&log_file, &log_sink_file, NULL, LOG_FILE_LEVEL, NULL, 0);
+#endif
+#endif
+}
+
+uint16_t log_ram_copy (uint8_t * out, uint16_t len)
+{
+#if LOG_RAM_EN == 1
+    rbuffer_span_t span[RBUFFER_MAX_SPANS];
+    uint16_t skip = 0;
+    uint16_t copied = 0;
+
+    if ((out == NULL) || (rbuffer_peek(&log_ram_rb, span) != ERR_OK))
+    {
+        return 0;
+    }
+
+    skip = (rbuffer_used(&log_ram_rb) > len) ? (uint16_t)(rbuffer_used(&log_ram_rb) - len) : 0;
+    for (uint8_t i = 0; i < RBUFFER_MAX_SPANS; i++)
+    {
+        uint16_t n = span[i].len;
+        const uint8_t * p = span[i].ptr;
+
+        if (skip >= n)
+        {
+            skip -= n;
+            continue;
+        }
+        p += skip;
+        n -= skip;
+        skip = 0;
+        memcpy(&out[copied], p, n);
+        copied += n;
+    }
+
+    return copied;
+#else
+    (void)out;
+    (void)len;
+
+    return 0;
+#endif
+}
+
+/* end of file */
@@ -18,7 +18,6 @@
 
 /* --- Standard libraries -------------------- */
 #include <stdarg.h>
-#include <stdio.h>
 #include <string.h>
 
 /* --- Arduino libraries -------------------- */
@@ -26,122 +25,550 @@
 
 /* --- Custom modules -------------------- */
 #include "logger.h"
+#include "log_fmt.h"
+#include "log_isr.h"
+#include "log_sink.h"
+#include "rbuffer.h"
+#include "prof.h"
+#include "meminfo.h"
 
 /*****************************************************************************
  * Macros                                                                    *
  *****************************************************************************/
 
+#define LOG_TAG_MASK    (LOG_TAG_SLOTS - 1)
+
 /*****************************************************************************
  * Datatypes                                                                 *
  *****************************************************************************/
 
 /**
- * \enum log_type_t
- * Defines the types of logs.
+ * \struct log_tag_t
+ * Per-tag threshold. A zero hash marks a free slot.
  */
-typedef enum 
+typedef struct
 {
-    LOG_TYPE_INFO,
-    LOG_TYPE_WARNING,
-    LOG_TYPE_DEBUG,
-    LOG_TYPE_ERROR,
-} log_type_t;
+    uint32_t hash;
+    uint8_t level;
+} log_tag_t;
+
+/*****************************************************************************
+ * Public Variables                                                          *
+ *****************************************************************************/
+
+uint8_t log_default_level = LOG_LEVEL_DEBUG;
+uint8_t log_tag_count = 0;
+uint8_t log_sink_floor = LOG_LEVEL_NONE;
 
 /*****************************************************************************
  * Static Variables                                                          *
  *****************************************************************************/
 
+static log_tag_t log_tags[LOG_TAG_SLOTS];
+
+/* Level of each log_type_t. */
+static const uint8_t log_type_level[] = {
+    LOG_LEVEL_INFO, LOG_LEVEL_WARN, LOG_LEVEL_DEBUG, LOG_LEVEL_ERROR
+};
+
+#if LOG_BINARY_EN == 0
+static const char * const log_type_str[] = { "INFO", "WARN", "DEBUG", "ERROR" };
+
 static char log_msg[MAX_LOG_MSG_SIZE];
+#endif
+
+static log_sink_t * log_sinks = NULL;
+static log_sink_t * log_only = NULL;        /* Set while reporting one sink's drops. */
+#if LOGGER_EN == 1
+static uint32_t log_isr_reported = 0;
+#endif
 
 /*****************************************************************************
- * Public Functions                                                          *
+ * Private Functions                                                         *
  *****************************************************************************/
 
-void LOG_INIT (void)
+/**
+ * @brief Level of a log_type_t, or of the type byte of a binary frame,
+ * whose flags it drops.
+ */
+static inline uint8_t log_level_of (uint8_t type)
 {
-    Serial.begin(SERIAL_SPEED);
+    return log_type_level[type & 0x03];
 }
 
-void LOG_INFO (const char * tag, const char * fmt, ...)
+/**
+ * @brief Hands a finished line or frame to every sink of its level: queued
+ * if the sink has a queue, written otherwise. A line that does not fit is
+ * dropped by that sink only. Thread context only.
+ */
+static void log_output (uint8_t level, const uint8_t * data, uint16_t len)
 {
-#if LOGGER_EN == 1
-#if LOG_INFO_EN == 1
-    snprintf(log_msg, sizeof(log_msg), "INFO - %s | ", tag);
-    Serial.print(log_msg);
+    rbuffer_span_t span[RBUFFER_MAX_SPANS];
 
-    va_list vargs;
-    va_start(vargs, fmt);
-    vsnprintf(log_msg, sizeof(log_msg), fmt, vargs);
-    Serial.println(log_msg);
-    va_end(vargs);
+    memset(span, 0, sizeof(span));
+    span[0].ptr = (uint8_t *)data;
+    span[0].len = len;
+
+    for (log_sink_t * sink = log_sinks; sink != NULL; sink = sink->next)
+    {
+        uint16_t sent = 0;
+
+        if ((level < sink->level) || ((log_only != NULL) && (sink != log_only)))
+        {
+            continue;
+        }
+
+#if LOG_DEFERRED_EN == 1
+        if (sink->queue.buf != NULL)
+        {
+            bool idle = rbuffer_empty(&sink->queue);
+
+            if (rbuffer_add_bytes(&sink->queue, data, len) != ERR_OK)
+            {
+                sink->dropped++;
+            }
+            else if (idle)
+            {
+                sink->since = micros();
+            }
+            continue;
+        }
 #endif
+
+        sent = sink->drv->write(sink, span, RBUFFER_MAX_SPANS);
+        sink->bytes += sent;
+        if (sent < len)
+        {
+            sink->dropped++;
+        }
+    }
+}
+
+#if LOG_DEFERRED_EN == 1
+/**
+ * @brief Writes what the sink's queue holds once a batch is due, or now if
+ * forced. Returns the bytes it took.
+ */
+static uint16_t log_sink_drain (log_sink_t * sink, bool force)
+{
+    rbuffer_span_t span[RBUFFER_MAX_SPANS];
+    uint16_t used = rbuffer_used(&sink->queue);
+    uint16_t sent = 0;
+
+    if ((used == 0) ||
+        (!force && (used < sink->batch) &&
+         ((uint32_t)(micros() - sink->since) < sink->drv->max_delay_us)))
+    {
+        return 0;
+    }
+
+    if (rbuffer_peek(&sink->queue, span) == ERR_OK)
+    {
+        sent = sink->drv->write(sink, span, RBUFFER_MAX_SPANS);
+    }
+    if (sent > 0)
+    {
+        rbuffer_consume(&sink->queue, sent);
+        sink->bytes += sent;
+        sink->since = micros();
+    }
+
+    return sent;
+}
 #endif
+
+#if LOG_BINARY_EN == 0
+/**
+ * @brief Starts a line in log_msg with its prefix. Room is kept for the
+ * line ending, so a truncated line still ends.
+ */
+static void log_line_begin (log_fmt_t * out, uint8_t type, const char * tag)
+{
+    log_fmt_init(out, log_msg, sizeof(log_msg) - 2);
+    log_fmt_puts(out, log_type_str[type]);
+    log_fmt_puts(out, " - ");
+    log_fmt_puts(out, tag);
+    log_fmt_puts(out, " | ");
 }
 
-void LOG_WARN (const char * tag, const char * fmt, ...)
+/**
+ * @brief Ends the line in log_msg and outputs it.
+ */
+static void log_line_end (log_fmt_t * out, uint8_t type)
 {
-#if LOGGER_EN == 1
-#if LOG_WARN_EN == 1
-    snprintf(log_msg, sizeof(log_msg), "WARN - %s | ", tag);
-    Serial.print(log_msg);
+    log_msg[out->len++] = '\r';
+    log_msg[out->len++] = '\n';
+    log_output(log_level_of(type), (const uint8_t *)log_msg, out->len);
+}
 
-    va_list vargs;
-    va_start(vargs, fmt);
-    vsnprintf(log_msg, sizeof(log_msg), fmt, vargs);
-    Serial.println(log_msg);
-    va_end(vargs);
+/**
+ * @brief Formats one log line in one pass and hands it to the output.
+ */
+static void log_vprint (log_type_t type, const char * tag, const char * fmt, va_list vargs)
+{
+    log_fmt_t out;
+
+    log_line_begin(&out, type, tag);
+    log_fmt_vprintf(&out, fmt, vargs);
+    log_line_end(&out, type);
+}
 #endif
+
+/**
+ * @brief Outputs the lines interrupt handlers captured, oldest first.
+ */
+static void log_drain_isr (void)
+{
+    log_isr_slot_t * slot;
+
+    while ((slot = log_isr_next()) != NULL)
+    {
+        if (slot->type == LOG_ISR_FRAME)
+        {
+            log_output(log_level_of(slot->u.frame[2]), slot->u.frame, slot->len);
+        }
+#if LOG_BINARY_EN == 0
+        else
+        {
+            log_fmt_raw_args_t args;
+            log_fmt_t out;
+
+            log_fmt_raw_init(&args, slot->u.text.argv, slot->len);
+            log_line_begin(&out, slot->type, slot->u.text.tag);
+            log_fmt_format(&out, slot->u.text.fmt, &args.base);
+            log_line_end(&out, slot->type);
+        }
 #endif
+        log_isr_release(slot);
+    }
+}
+
+/**
+ * @brief Returns the table slot holding hash, or the free slot where it
+ * would go. Returns -1 if it is absent and the table is full.
+ */
+static int log_tag_slot (uint32_t hash)
+{
+    uint8_t i = (uint8_t)(hash & LOG_TAG_MASK);
+
+    for (uint8_t n = 0; n < LOG_TAG_SLOTS; n++)
+    {
+        if ((log_tags[i].hash == hash) || (log_tags[i].hash == 0))
+        {
+            return i;
+        }
+        i = (i + 1) & LOG_TAG_MASK;
+    }
+
+    return -1;
 }
 
-void LOG_DEBUG (const char * tag, const char * fmt, ...)
+#if LOG_BINARY_EN == 1
+/**
+ * @brief log_fmt_walk visitor: encodes one argument of a C call site as
+ * LOG_BIN_WRITE would have.
+ */
+static void log_bin_put (void * ctx, char conv, uint64_t value)
 {
+    log_bin::Encoder * enc = (log_bin::Encoder *)ctx;
+
+    if (conv == 's')
+    {
+        enc->put((const char *)(uintptr_t)value);
+    }
+    else
+    {
+        enc->put((int64_t)value);
+    }
+}
+#endif
+
+/* Only LOG_PROCESS reports drops, and it does nothing without the logger. */
 #if LOGGER_EN == 1
-#if LOG_DEBUG_EN == 1
-    snprintf(log_msg, sizeof(log_msg), "DEBUG - %s | ", tag);
-    Serial.print(log_msg);
+/**
+ * @brief Reports lines interrupt handlers could not capture, to every sink.
+ */
+static void log_report_isr (void)
+{
+    uint32_t dropped = log_isr_dropped();
+
+    if (dropped != log_isr_reported)
+    {
+#if LOG_BINARY_EN == 1
+        LOG_BIN_WRITE(LOG_TYPE_WARNING, "LOG", "%lu lines dropped in interrupts",
+                      (unsigned long)(dropped - log_isr_reported));
+#else
+        log_write(LOG_TYPE_WARNING, "LOG", "%lu lines dropped in interrupts",
+                  (unsigned long)(dropped - log_isr_reported));
+#endif
+        log_isr_reported = dropped;
+    }
+}
+
+#if LOG_DEFERRED_EN == 1
+/**
+ * @brief Reports the lines one sink dropped into that sink only: the others
+ * did not lose them. Retried later if the report itself is dropped.
+ */
+static void log_report_sink (log_sink_t * sink)
+{
+    uint32_t dropped = sink->dropped;
+
+    log_only = sink;
+#if LOG_BINARY_EN == 1
+    LOG_BIN_WRITE(LOG_TYPE_WARNING, "LOG", "%lu lines dropped",
+                  (unsigned long)(dropped - sink->reported));
+#else
+    log_write(LOG_TYPE_WARNING, "LOG", "%lu lines dropped",
+              (unsigned long)(dropped - sink->reported));
+#endif
+    log_only = NULL;
+
+    if (sink->dropped == dropped)
+    {
+        sink->reported = dropped;
+    }
+}
+#endif
+#endif
+
+/*****************************************************************************
+ * Public Functions                                                          *
+ *****************************************************************************/
 
+void LOG_INIT (void)
+{
+    Serial.begin(SERIAL_SPEED);
+#if LOG_BINARY_EN == 0
+    MEMINFO_REGISTER(log_msg);
+#endif
+    log_sink_builtin();
+}
+
+int log_sink_add (log_sink_t * sink, const log_sink_driver_t * drv, void * ctx,
+                  log_level_t level, uint8_t * buf, uint16_t size)
+{
+    int err = ERR_OK;
+    log_sink_t ** link = &log_sinks;
+
+    if ((sink == NULL) || (drv == NULL) || (drv->write == NULL))
+    {
+        return ERR_LOG_SINK_NULL_POINTER;
+    }
+
+    while ((*link != NULL) && (*link != sink))
+    {
+        link = &(*link)->next;
+    }
+
+    sink->drv = drv;
+    sink->ctx = ctx;
+    sink->level = (uint8_t)level;
+    sink->batch = drv->batch;
+    sink->bytes = 0;
+    sink->dropped = 0;
+    sink->reported = 0;
+#if LOG_DEFERRED_EN == 1
+    memset(&sink->queue, 0, sizeof(sink->queue));
+    sink->since = 0;
+    if (buf != NULL)
+    {
+        err = rbuffer_init(&sink->queue, buf, size, RBUFFER_POLICY_REJECT);
+        /* A batch the queue cannot hold would only go out on its delay. */
+        if (sink->batch > size / 2)
+        {
+            sink->batch = size / 2;
+        }
+    }
+#else
+    (void)buf;
+    (void)size;
+#endif
+
+    if ((err == ERR_OK) && (*link == NULL))
+    {
+        sink->next = NULL;
+        *link = sink;
+    }
+
+    log_sink_floor = LOG_LEVEL_NONE;
+    for (log_sink_t * s = log_sinks; s != NULL; s = s->next)
+    {
+        if (s->level < log_sink_floor)
+        {
+            log_sink_floor = s->level;
+        }
+    }
+
+    return err;
+}
+
+void log_write (log_type_t type, const char * tag, const char * fmt, ...)
+{
+#if LOG_BINARY_EN == 0
+    PROF_SCOPE(log_write);
+    va_list vargs;
+    va_start(vargs, fmt);
+    if (log_isr_active())
+    {
+        /* Never format in an interrupt, only capture the arguments. */
+        log_isr_vcapture((uint8_t)type, tag, fmt, vargs);
+    }
+    else
+    {
+        log_vprint(type, tag, fmt, vargs);
+    }
+    va_end(vargs);
+#else
+    /* C callers: the token is hashed here rather than at compile time, the
+     * string table has it all the same. */
+    PROF_SCOPE(log_write);
+    log_bin::Encoder enc((uint8_t)type, log_bin::token(tag, fmt), millis());
     va_list vargs;
     va_start(vargs, fmt);
-    vsnprintf(log_msg, sizeof(log_msg), fmt, vargs);
-    Serial.println(log_msg);
+    log_fmt_walk(fmt, vargs, log_bin_put, &enc);
     va_end(vargs);
+    enc.emit();
 #endif
-#endif  
 }
 
-void LOG_ERROR (const char * tag, const char * fmt, ...)
+void LOG_SET_LEVEL (log_level_t level)
+{
+    log_default_level = (uint8_t)level;
+}
+
+bool LOG_SET_TAG_LEVEL (const char * tag, log_level_t level)
+{
+    uint32_t hash = log_hash(tag, LOG_HASH_SEED);
+    int slot;
+
+    /* Zero marks a free slot, such a tag cannot be stored. */
+    slot = (hash == 0) ? -1 : log_tag_slot(hash);
+    if (slot < 0)
+    {
+        return false;
+    }
+
+    if (log_tags[slot].hash == 0)
+    {
+        log_tags[slot].hash = hash;
+        log_tag_count++;
+    }
+    log_tags[slot].level = (uint8_t)level;
+
+    return true;
+}
+
+bool log_tag_enabled (uint32_t hash, log_level_t level)
+{
+    int slot = log_tag_slot(hash);
+
+    if ((slot < 0) || (log_tags[slot].hash == 0))
+    {
+        return (uint8_t)level >= log_default_level;
+    }
+
+    return (uint8_t)level >= log_tags[slot].level;
+}
+
+void LOG_PROCESS (void)
 {
 #if LOGGER_EN == 1
-#if LOG_ERROR_EN == 1
-    snprintf(log_msg, sizeof(log_msg), "ERROR - %s | ", tag);
-    Serial.print(log_msg);
+    PROF_SCOPE(log_process);
 
-    va_list vargs;
-    va_start(vargs, fmt);
-    vsnprintf(log_msg, sizeof(log_msg), fmt, vargs);
-    Serial.println(log_msg);
-    va_end(vargs);
+    log_drain_isr();
+    log_report_isr();
+
+#if LOG_DEFERRED_EN == 1
+    for (log_sink_t * sink = log_sinks; sink != NULL; sink = sink->next)
+    {
+        if (sink->queue.buf == NULL)
+        {
+            continue;
+        }
+
+        /* Drops are only reported once the sink takes data again, so a
+         * stuck sink does not keep refusing its own reports. */
+        if (((log_sink_drain(sink, false) > 0) || rbuffer_empty(&sink->queue)) &&
+            (sink->dropped != sink->reported))
+        {
+            log_report_sink(sink);
+        }
+    }
 #endif
 #endif
 }
 
-void LOG_ERROR_LOCK (const char * tag, const char * fmt, ...)
+void LOG_FLUSH (void)
 {
-#if LOGGER_EN == 1
-#if LOG_ERROR_EN == 1
-    snprintf(log_msg, sizeof(log_msg), "ERROR - %s | ", tag);
-    Serial.print(log_msg);
+    log_drain_isr();
 
-    va_list vargs;
-    va_start(vargs, fmt);
-    vsnprintf(log_msg, sizeof(log_msg), fmt, vargs);
-    Serial.println(log_msg);
-    va_end(vargs);
-    
-    while(1) {}
+    for (log_sink_t * sink = log_sinks; sink != NULL; sink = sink->next)
+    {
+#if LOG_DEFERRED_EN == 1
+        uint32_t idle = micros();
+
+        while ((sink->queue.buf != NULL) && !rbuffer_empty(&sink->queue) &&
+               ((uint32_t)(micros() - idle) < LOG_FLUSH_TIMEOUT_US))
+        {
+            if (log_sink_drain(sink, true) > 0)
+            {
+                idle = micros();
+            }
+        }
 #endif
+        if (sink->drv->flush != NULL)
+        {
+            sink->drv->flush(sink);
+        }
+    }
+}
+
+void LOG_DISCARD (void)
+{
+#if LOG_DEFERRED_EN == 1
+    for (log_sink_t * sink = log_sinks; sink != NULL; sink = sink->next)
+    {
+        if (sink->queue.buf != NULL)
+        {
+            rbuffer_clear(&sink->queue);
+        }
+    }
 #endif
 }
 
+void log_halt (void)
+{
+    /* Nothing else will run, so flush everything queued before locking. */
+    LOG_FLUSH();
+
+    while(1) {}
+}
+
+#if LOG_BINARY_EN == 1
+void log_bin_emit (const uint8_t * frame, uint16_t len)
+{
+    if (log_isr_active())
+    {
+        log_isr_frame(frame, len);
+    }
+    else
+    {
+        log_output(log_level_of(frame[2]), frame, len);
+    }
+}
+#endif
+
+uint32_t LOG_DROPPED (void)
+{
+    uint32_t dropped = log_isr_dropped();
+
+    for (log_sink_t * sink = log_sinks; sink != NULL; sink = sink->next)
+    {
+        dropped += sink->dropped;
+    }
+
+    return dropped;
+}
+
 /* end of file */
\ No newline at end of file
@@ -23,6 +23,20 @@
 #include "suricata_config.h"
 #include "logger.h"
 #include "rbuffer.h"
+#include "sched.h"
+#include "sampler.h"
+#include "i2c_bus.h"
+#include "sensor.h"
+#include "sensor_sht3x.h"
+#include "tscodec.h"
+#include "agg.h"
+#include "uplink.h"
+#include "store.h"
+#include "pool.h"
+#include "meminfo.h"
+#include "boot.h"
+#include "prof.h"
+#include "bench.h"
 
 /*****************************************************************************
  * Public Vars                                                               *
@@ -31,46 +45,511 @@
 /* --- Array Buffers ------------------- */
 
 uint8_t data_buf[DATA_BUFFER_SIZE] = {0};
+uint8_t stage_buf[STAGE_BUFFER_SIZE] = {0};
 
 /* --- Module vars --------------------- */
 
 rbuffer_t data_rbuffer;
+rbuffer_t stage_rbuffer;
+
+/* --- Pools --------------------------- */
+
+POOL_DEFINE(record_pool, TSC_BLOCK_SIZE, RECORD_POOL_BLOCKS);
+
+/*****************************************************************************
+ * Private Vars                                                              *
+ *****************************************************************************/
+
+/* --- Sample encoder ----------------- */
+
+static tsc_enc_t encoder;
+static uint8_t * block_buf = NULL;      /* From record_pool while a block is open. */
+static uint32_t block_opened = 0;
+static uint32_t blocks_lost = 0;
+static uint16_t stage_seq = 0;          /* Next seq expected from the sampler. */
+static uint16_t encode_seq = 0;         /* Next seq given to an encoded sample. */
+static bool first_sample = true;
+
+/* Filled blocks waiting for the store task, oldest first. Each holds a
+ * record_pool block, so there are never more than the pool has. */
+static uint8_t * ready_buf[RECORD_POOL_BLOCKS];
+static uint16_t ready_len[RECORD_POOL_BLOCKS];
+static uint8_t ready_count = 0;
+
+/* --- Sample sources ------------------ */
+
+#define SRC_SHT3X_A     (1)
+#define SRC_SHT3X_B     (2)
+#define SRC_AGG_ADC     (3)
+#define SRC_AGG_SHT3X_A (4)
+
+static sensor_t sht3x_a;
+static sensor_t sht3x_b;
+
+/* --- Aggregates ---------------------- */
+
+static agg_t adc_agg;
+static agg_t sht3x_a_agg;
+
+#if defined(SURICATA_NATIVE)
+/* --- Recorded sensor responses ------- */
+
+static const uint8_t sht3x_measure[] = {0x24, 0x00};
+
+static const uint8_t sht3x_a_data[][6] = {
+    {0x61, 0x47, 0x8A, 0x7B, 0x64, 0xDF},   /* 21.50 C, 48.2 % */
+    {0x61, 0x5A, 0x85, 0x7B, 0x22, 0x44},   /* 21.55 C, 48.1 % */
+    {0x61, 0x70, 0xD8, 0x7A, 0x9F, 0x43},   /* 21.61 C, 47.9 % */
+};
+
+static const uint8_t sht3x_b_data[][6] = {
+    {0x5E, 0xCB, 0xA6, 0x8C, 0xCC, 0x2C},   /* 19.80 C, 55.0 % */
+    {0x5E, 0xD2, 0x6D, 0x8D, 0xD2, 0x84},   /* 19.82 C, 55.4 % */
+    {0x5E, 0xC7, 0xDB, 0x8D, 0x0E, 0xFD},   /* 19.79 C, 55.1 % */
+};
+
+static const i2c_mock_step_t sht3x_a_steps[] = {
+    {sht3x_measure, 2, NULL, 0}, {NULL, 0, sht3x_a_data[0], 6},
+    {sht3x_measure, 2, NULL, 0}, {NULL, 0, sht3x_a_data[1], 6},
+    {sht3x_measure, 2, NULL, 0}, {NULL, 0, sht3x_a_data[2], 6},
+};
+
+static const i2c_mock_step_t sht3x_b_steps[] = {
+    {sht3x_measure, 2, NULL, 0}, {NULL, 0, sht3x_b_data[0], 6},
+    {sht3x_measure, 2, NULL, 0}, {NULL, 0, sht3x_b_data[1], 6},
+    {sht3x_measure, 2, NULL, 0}, {NULL, 0, sht3x_b_data[2], 6},
+};
+#endif
 
 /*****************************************************************************
  * Function Prototypes                                                       *
  *****************************************************************************/
 
+static int boot_logger (void);
+static int boot_rbuffers (void);
+static int boot_sched (void);
+static int boot_sampler (void);
+static int boot_sensors (void);
+static int boot_uplink (void);
+static int boot_store (void);
+static uint8_t adc_read (int32_t * values, uint8_t max);
+static void encode_batch (const sampler_sample_t * samples, uint16_t count);
+static void encode_sample (const sampler_sample_t * sample);
+static void encode_flush (void);
+static void encode_task (void * arg);
+static void uplink_task (void * arg);
+static void store_task (void * arg);
+static void sensor_task (void * arg);
+static void report_task (void * arg);
+static void report_rbuffer (const char * name, const rbuffer_t * rb);
+
 /*****************************************************************************
  * Code                                                                      *
  *****************************************************************************/
 
 void setup() 
 {
-    int err = ERR_OK;
+    /* Before anything else runs deep on the stack. */
+    meminfo_paint();
+    prof_init();
 
-    delay(5000);
-    /* Init log system */
+    /* No wait for a serial host here: see boot.h. */
+    boot_stage("logger", boot_logger);
+    boot_stage("rbuffers", boot_rbuffers);
+    boot_stage("sched", boot_sched);
+    boot_stage("sampler", boot_sampler);
+    boot_stage("sensors", boot_sensors);
+    boot_stage("uplink", boot_uplink);
+    boot_stage("store", boot_store);
+    boot_report();
+
+#if BENCH_EN == 1
+    bench_run();
+#endif
+}
+
+void loop() 
+{
+    sched_run();
+    LOG_PROCESS();
+}
+
+/* --- Private functions --------------------------------------------------- */
+
+/* --- Boot stages, in setup order -------- */
+
+static int boot_logger (void)
+{
     LOG_INIT();
+#if LOG_DEFERRED_EN == 0
+    /* Lines are written as they come, nothing holds them for a host. */
+    while (!boot_serial_ready())
+    {
+    }
+#endif
 
     LOG_INFO("SETUP", "> ----- Suricata ----- <\n");
     LOG_INFO("SETUP", "FW Version: %d.%d.%d", FW_MAJOR, FW_MINOR, FW_PATCH);
     LOG_INFO("SETUP", "HW Version: %d.%d\n", HW_MAJOR, HW_MINOR);
     LOG_INFO("SETUP", "> System init...\n");
 
-    /* Init ring buffer */
+    return ERR_OK;
+}
+
+static int boot_rbuffers (void)
+{
+    int err = ERR_OK;
+
     LOG_INFO("SETUP:RBUFFER", "> Init Data Ring Buffer...");
-    err = rbuffer_init(&data_rbuffer, data_buf, DATA_BUFFER_SIZE);
+    err = rbuffer_init(&data_rbuffer, data_buf, DATA_BUFFER_SIZE, RBUFFER_POLICY_OVERWRITE);
     if (err != ERR_OK)
     {
         LOG_ERROR_LOCK("SETUP:RBUFFER", ">> Data Ring Buffer init error: %d", err);
     }
     LOG_INFO("SETUP:RBUFFER", ">> Data Ring Buffer initialized.");
+
+    LOG_INFO("SETUP:RBUFFER", "> Init Stage Ring Buffer...");
+    err = rbuffer_init(&stage_rbuffer, stage_buf, STAGE_BUFFER_SIZE, RBUFFER_POLICY_OVERWRITE);
+    if (err != ERR_OK)
+    {
+        LOG_ERROR_LOCK("SETUP:RBUFFER", ">> Stage Ring Buffer init error: %d", err);
+    }
+    LOG_INFO("SETUP:RBUFFER", ">> Stage Ring Buffer initialized.");
+
+    MEMINFO_REGISTER(data_buf);
+    MEMINFO_REGISTER(stage_buf);
+    MEMINFO_REGISTER(record_pool_storage);
+
+    return err;
 }
 
-void loop() 
+static int boot_sched (void)
 {
+    int err = ERR_OK;
+
+    LOG_INFO("SETUP:SCHED", "> Init Scheduler...");
+    sched_init();
+    err = sched_add("report", report_task, NULL, SCHED_REPORT_PERIOD_US,
+                    SCHED_REPORT_PERIOD_US, NULL);
+    if (err != ERR_OK)
+    {
+        LOG_ERROR("SETUP:SCHED", ">> Scheduler report task error: %d", err);
+    }
+    LOG_INFO("SETUP:SCHED", ">> Scheduler initialized.");
+
+    return err;
 }
 
-/* --- Private functions --------------------------------------------------- */
+static int boot_sampler (void)
+{
+    int err = ERR_OK;
+
+    LOG_INFO("SETUP:SAMPLER", "> Init Sampler...");
+    err = sampler_init(&stage_rbuffer, adc_read);
+    if (err == ERR_OK)
+    {
+        /* The ADC is only uplinked as tumbling windows; SHT3x A also as
+         * raw samples, with a sliding window. */
+        agg_init(encode_sample);
+        err = agg_add(&adc_agg, SAMPLER_SRC_TIMER, 0, SRC_AGG_ADC,
+                      AGG_WINDOW_US, AGG_WINDOW_US, false);
+    }
+    if (err == ERR_OK)
+    {
+        err = agg_add(&sht3x_a_agg, SRC_SHT3X_A, 0, SRC_AGG_SHT3X_A,
+                      AGG_WINDOW_US, AGG_HOP_US, true);
+    }
+    if (err == ERR_OK)
+    {
+        err = sched_add("encode", encode_task, NULL, SAMPLER_BATCH_PERIOD_US, 0, NULL);
+    }
+    if (err == ERR_OK)
+    {
+        err = sampler_start(SAMPLER_RATE_HZ);
+    }
+    if (err != ERR_OK)
+    {
+        LOG_ERROR("SETUP:SAMPLER", ">> Sampler init error: %d", err);
+    }
+    else
+    {
+        LOG_INFO("SETUP:SAMPLER", ">> Sampler running at %d Hz.", SAMPLER_RATE_HZ);
+    }
+
+    return err;
+}
+
+static int boot_sensors (void)
+{
+    int err = ERR_OK;
+
+    LOG_INFO("SETUP:SENSOR", "> Init Sensors...");
+#if defined(SURICATA_NATIVE)
+    i2c_mock_device(SHT3X_ADDR_A, sht3x_a_steps, sizeof(sht3x_a_steps) / sizeof(sht3x_a_steps[0]));
+    i2c_mock_device(SHT3X_ADDR_B, sht3x_b_steps, sizeof(sht3x_b_steps) / sizeof(sht3x_b_steps[0]));
+#endif
+    err = i2c_bus_init(I2C_BUS_CLOCK_HZ);
+    if (err == ERR_OK)
+    {
+        sensor_add(&sht3x_a, &sensor_sht3x, SHT3X_ADDR_A, SRC_SHT3X_A, 1000000UL);
+        sensor_add(&sht3x_b, &sensor_sht3x, SHT3X_ADDR_B, SRC_SHT3X_B, 1000000UL);
+        err = sched_add("sensor", sensor_task, NULL, SENSOR_POLL_PERIOD_US, 0, NULL);
+    }
+    if (err != ERR_OK)
+    {
+        LOG_ERROR("SETUP:SENSOR", ">> Sensors init error: %d", err);
+    }
+    else
+    {
+        LOG_INFO("SETUP:SENSOR", ">> Sensors initialized.");
+    }
+
+    return err;
+}
+
+static int boot_uplink (void)
+{
+    int err = ERR_OK;
+    int task_err = ERR_OK;
+
+    LOG_INFO("SETUP:UPLINK", "> Init Uplink...");
+    err = uplink_init(&data_rbuffer);
+    if (err != ERR_OK)
+    {
+        /* The records stay queued; the rbuffer drops the oldest. */
+        LOG_WARN("SETUP:UPLINK", ">> Uplink unavailable: %d", err);
+    }
+    task_err = sched_add("uplink", uplink_task, NULL, UPLINK_POLL_PERIOD_US, 0, NULL);
+    if (task_err != ERR_OK)
+    {
+        err = task_err;
+        LOG_ERROR("SETUP:UPLINK", ">> Uplink task error: %d", err);
+    }
+    LOG_INFO("SETUP:UPLINK", ">> Uplink to %s:%d.", UPLINK_HOST, UPLINK_PORT);
+
+    return err;
+}
+
+static int boot_store (void)
+{
+    int err = ERR_OK;
+
+    LOG_INFO("SETUP:STORE", "> Init Flash Store...");
+    err = store_init(&data_rbuffer);
+    if (err != ERR_OK)
+    {
+        /* Blocks then only queue in RAM. */
+        LOG_WARN("SETUP:STORE", ">> Flash store unavailable: %d", err);
+    }
+    else
+    {
+        err = sched_add("store", store_task, NULL, STORE_POLL_PERIOD_US, 0, NULL);
+        if (err != ERR_OK)
+        {
+            LOG_ERROR("SETUP:STORE", ">> Flash store task error: %d", err);
+        }
+        LOG_INFO("SETUP:STORE", ">> Flash store mounted, %s.",
+                 store_pending() ? "records pending" : "empty");
+    }
+
+    return err;
+}
+
+/* --- Sampling and tasks ----------------- */
+
+/**
+ * @brief Sensor read for the sampler, runs in its ISR. Natively a fake
+ * sensor gives a triangle wave; on the board the analog input A0 is
+ * sampled. I2C sensors run apart, see sensor.h.
+ */
+static uint8_t adc_read (int32_t * values, uint8_t max)
+{
+#if defined(SURICATA_NATIVE)
+    static int32_t level = 0;
+    static int32_t step = 10;
+
+    level += step;
+    if ((level <= 0) || (level >= 1000))
+    {
+        step = -step;
+    }
+    values[0] = level;
+#else
+    values[0] = analogRead(A0);
+#endif
+    (void)max;
+
+    return 1;
+}
+
+/**
+ * @brief Batch callback of sampler_consume: feeds the samples to the
+ * aggregates and encodes those passed on. Samples kept local are not
+ * numbered, so a gap in the uplinked seq still means a lost sample.
+ */
+static void encode_batch (const sampler_sample_t * samples, uint16_t count)
+{
+    if (first_sample && (count > 0))
+    {
+        first_sample = false;
+        LOG_INFO("BOOT", "first sample at %lu us", (unsigned long)samples[0].ts_us);
+    }
+
+    for (uint16_t i = 0; i < count; i++)
+    {
+        encode_seq += (uint16_t)(samples[i].seq - stage_seq);
+        stage_seq = samples[i].seq + 1;
+        if (agg_feed(&samples[i]))
+        {
+            encode_sample(&samples[i]);
+        }
+    }
+}
+
+/**
+ * @brief Compresses one sample, raw or aggregate, into the open block,
+ * handing it to the store task whenever it fills up.
+ */
+static void encode_sample (const sampler_sample_t * sample)
+{
+    sampler_sample_t out = *sample;
+
+    out.seq = encode_seq++;
+    if ((block_buf != NULL) && (tsc_enc_add(&encoder, &out) != ERR_TSC_FULL))
+    {
+        return;
+    }
+
+    encode_flush();
+    block_buf = (uint8_t *)pool_alloc(&record_pool);
+    if (block_buf == NULL)
+    {
+        /* Counted by the pool; the sample shows as a seq gap. */
+        return;
+    }
+    tsc_enc_init(&encoder, block_buf, TSC_BLOCK_SIZE);
+    block_opened = micros();
+    tsc_enc_add(&encoder, &out);
+}
+
+/**
+ * @brief Closes the open block and hands it, buffer and all, to the store
+ * task, which frees it once queued.
+ */
+static void encode_flush (void)
+{
+    if (block_buf == NULL)
+    {
+        return;
+    }
+
+    if (tsc_enc_len(&encoder) > 0)
+    {
+        ready_buf[ready_count] = block_buf;
+        ready_len[ready_count] = tsc_enc_len(&encoder);
+        ready_count++;
+    }
+    else
+    {
+        pool_free(&record_pool, block_buf);
+    }
+    block_buf = NULL;
+}
+
+static void encode_task (void * arg)
+{
+    (void)arg;
+    sampler_consume(encode_batch, UINT16_MAX);
+    if ((block_buf != NULL) && ((uint32_t)(micros() - block_opened) >= TSC_BLOCK_MAX_US))
+    {
+        encode_flush();
+    }
+}
+
+/**
+ * @brief Queues the blocks the encoder filled, giving their buffers back
+ * to record_pool, then lets the store move data on.
+ */
+static void store_task (void * arg)
+{
+    (void)arg;
+    for (uint8_t i = 0; i < ready_count; i++)
+    {
+        if (store_push(ready_buf[i], ready_len[i]) != ERR_OK)
+        {
+            blocks_lost++;
+        }
+        pool_free(&record_pool, ready_buf[i]);
+    }
+    ready_count = 0;
+    store_poll();
+}
+
+static void uplink_task (void * arg)
+{
+    (void)arg;
+    uplink_poll();
+}
+
+static void sensor_task (void * arg)
+{
+    (void)arg;
+    sensor_poll();
+}
+
+static void report_task (void * arg)
+{
+    static bool mem_listed = false;
+    sampler_stats_t stats;
+    uplink_stats_t up;
+    store_stats_t st;
+
+    (void)arg;
+    sched_report();
+    sensor_report();
+    sampler_stats(&stats);
+    LOG_INFO("SAMPLER", "ticks %lu pushed %lu failed %lu lost %lu resyncs %lu overrun %lu bytes",
+             (unsigned long)stats.ticks, (unsigned long)stats.pushed,
+             (unsigned long)stats.failed, (unsigned long)stats.lost,
+             (unsigned long)stats.resyncs, (unsigned long)rbuffer_overruns(&stage_rbuffer));
+    LOG_INFO("ENCODE", "blocks lost %lu overrun %lu bytes", (unsigned long)blocks_lost,
+             (unsigned long)rbuffer_overruns(&data_rbuffer));
+    report_rbuffer("stage", &stage_rbuffer);
+    report_rbuffer("data", &data_rbuffer);
+    pool_report(&record_pool);
+    meminfo_report(!mem_listed);
+    mem_listed = true;
+    store_stats(&st);
+    LOG_INFO("STORE", "spilled %lu drained %lu dropped %lu corrupt %lu failed %lu used %u/%u wear %lu-%lu",
+             (unsigned long)st.spilled, (unsigned long)st.drained, (unsigned long)st.dropped,
+             (unsigned long)st.corrupt, (unsigned long)st.failed, st.used, STORE_SECTORS,
+             (unsigned long)st.wear_min, (unsigned long)st.wear_max);
+    uplink_stats(&up);
+    LOG_INFO("UPLINK", "frames %lu records %lu bytes %lu failed %lu deferred %lu",
+             (unsigned long)up.frames, (unsigned long)up.records, (unsigned long)up.bytes,
+             (unsigned long)up.failed, (unsigned long)up.deferred);
+    prof_report();
+}
+
+/**
+ * @brief Logs the occupancy and residence statistics of one rbuffer, to
+ * size it from a real run. Nothing unless RBUFFER_STATS_EN is 1.
+ */
+static void report_rbuffer (const char * name, const rbuffer_t * rb)
+{
+#if RBUFFER_STATS_EN == 1
+    rbuffer_stats_t st;
+
+    rbuffer_stats(rb, &st);
+    LOG_INFO("RBUFFER", "%s: high %u/%u rejected %lu in %lu out %lu residence p50 %lu p99 %lu us",
+             name, st.high_water, rb->size, (unsigned long)st.rejected,
+             (unsigned long)st.bytes_in, (unsigned long)st.bytes_out,
+             (unsigned long)rbuffer_stats_residence(&st, 50),
+             (unsigned long)rbuffer_stats_residence(&st, 99));
+#else
+    (void)name;
+    (void)rb;
+#endif
+}
 
 /* end of file */
\ No newline at end of file
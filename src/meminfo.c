@@ -0,0 +1,226 @@
+/*****************************************************************************
+ *                                                                           *
+ * \file meminfo.c                                                           *
+ *                                                                           *
+ * \brief RAM budget: stack high-water mark, heap and static buffers.        *
+ *                                                                           *
+ * \author blackchacal <ribeiro.tonet@gmail.com>                             *
+ * \date Oct 17, 2026                                                        *
+ *                                                                           *
+ * \version 1.0 | \author blackchacal                                        *
+ * File creation.                                                            *
+ *                                                                           *
+ *****************************************************************************/
+
+/*****************************************************************************
+ * Includes                                                                  *
+ *****************************************************************************/
+
+/* --- Standard libraries -------------------- */
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#if defined(ARDUINO_ARCH_SAMD)
+#include <malloc.h>
+#include <unistd.h>
+#endif
+
+/* --- Arduino libraries -------------------- */
+#include <Arduino.h>
+
+/* --- Custom modules -------------------- */
+#include "meminfo.h"
+#include "logger.h"
+
+/*****************************************************************************
+ * Macros                                                                    *
+ *****************************************************************************/
+
+#define MEMINFO_PAINT           (0xA5A5A5A5UL)
+
+/* Left unpainted below the stack pointer of meminfo_paint, for its own
+ * frame and whatever it calls. */
+#define MEMINFO_PAINT_MARGIN    (64)
+
+/*****************************************************************************
+ * Datatypes                                                                 *
+ *****************************************************************************/
+
+/**
+ * \struct meminfo_buffer_t
+ * One registered buffer.
+ */
+typedef struct
+{
+    const char * name;
+    const void * buf;
+    uint32_t size;
+} meminfo_buffer_t;
+
+/*****************************************************************************
+ * Static Variables                                                          *
+ *****************************************************************************/
+
+static meminfo_buffer_t meminfo_buffers[MEMINFO_MAX_BUFFERS];
+static uint8_t meminfo_count = 0;
+
+#if defined(ARDUINO_ARCH_SAMD)
+/* From the linker script: .data starts the RAM, the heap starts at end and
+ * the stack starts at __StackTop, the end of the RAM. */
+extern char __data_start__;
+extern char end;
+extern char __StackTop;
+
+static uint32_t * meminfo_painted = NULL;   /* Lowest painted word. */
+#endif
+
+/*****************************************************************************
+ * Private Functions                                                         *
+ *****************************************************************************/
+
+#if defined(ARDUINO_ARCH_SAMD)
+/**
+ * @brief Current top of the heap, word aligned up.
+ */
+static uint32_t * meminfo_heap_top (void)
+{
+    uintptr_t brk = (uintptr_t)sbrk(0);
+
+    return (uint32_t *)((brk + 3) & ~(uintptr_t)3);
+}
+#endif
+
+/*****************************************************************************
+ * Public Functions                                                          *
+ *****************************************************************************/
+
+void meminfo_paint (void)
+{
+#if defined(ARDUINO_ARCH_SAMD)
+    uint32_t * p = meminfo_heap_top();
+    uint32_t * top = (uint32_t *)((__get_MSP() - MEMINFO_PAINT_MARGIN) & ~(uint32_t)3);
+
+    /* An ISR may push its frame below the stack pointer meanwhile: it then
+     * simply counts as used. */
+    meminfo_painted = p;
+    while (p < top)
+    {
+        *p++ = MEMINFO_PAINT;
+    }
+#endif
+}
+
+int meminfo_register (const char * name, const void * buf, size_t size)
+{
+    uint8_t i = 0;
+
+    if ((name == NULL) || (buf == NULL))
+    {
+        return ERR_MEMINFO_NULL_POINTER;
+    }
+
+    for (i = 0; i < meminfo_count; i++)
+    {
+        if (meminfo_buffers[i].buf == buf)
+        {
+            /* Registered again, by a second init. */
+            break;
+        }
+    }
+    if (i == MEMINFO_MAX_BUFFERS)
+    {
+        return ERR_MEMINFO_FULL;
+    }
+
+    meminfo_buffers[i].name = name;
+    meminfo_buffers[i].buf = buf;
+    meminfo_buffers[i].size = (uint32_t)size;
+    if (i == meminfo_count)
+    {
+        meminfo_count++;
+    }
+
+    return ERR_OK;
+}
+
+void meminfo_stats (meminfo_stats_t * stats)
+{
+    if (stats == NULL)
+    {
+        return;
+    }
+
+    memset(stats, 0, sizeof(*stats));
+    for (uint8_t i = 0; i < meminfo_count; i++)
+    {
+        stats->buffers += meminfo_buffers[i].size;
+    }
+
+#if defined(ARDUINO_ARCH_SAMD)
+    {
+        uint32_t * heap_top = meminfo_heap_top();
+        uint32_t * sp = (uint32_t *)__get_MSP();
+        uint32_t * p = heap_top;
+        struct mallinfo mi = mallinfo();
+
+        if (meminfo_painted == NULL)
+        {
+            /* Not painted: only the current depth is known. */
+            p = sp;
+        }
+        else
+        {
+            /* The heap may have grown over the bottom of the paint since. */
+            if (p < meminfo_painted)
+            {
+                p = meminfo_painted;
+            }
+            while ((p < sp) && (*p == MEMINFO_PAINT))
+            {
+                p++;
+            }
+        }
+
+        stats->ram = (uint32_t)(&__StackTop - &__data_start__);
+        stats->statics = (uint32_t)(&end - &__data_start__);
+        stats->heap = (uint32_t)((char *)heap_top - &end);
+        stats->heap_free = (uint32_t)mi.fordblks;
+        stats->stack = (uint32_t)(&__StackTop - (char *)sp);
+        stats->stack_high = (uint32_t)(&__StackTop - (char *)p);
+        stats->gap = (uint32_t)((char *)p - (char *)heap_top);
+    }
+#endif
+}
+
+void meminfo_report (bool buffers)
+{
+    meminfo_stats_t st;
+
+    meminfo_stats(&st);
+
+    if (buffers)
+    {
+        for (uint8_t i = 0; i < meminfo_count; i++)
+        {
+            LOG_INFO("MEM", "%-20s %6lu B", meminfo_buffers[i].name,
+                     (unsigned long)meminfo_buffers[i].size);
+        }
+    }
+
+#if defined(ARDUINO_ARCH_SAMD)
+    LOG_INFO("MEM", "ram %lu static %lu (buffers %lu) heap %lu (%lu free) stack %lu high %lu gap %lu B",
+             (unsigned long)st.ram, (unsigned long)st.statics, (unsigned long)st.buffers,
+             (unsigned long)st.heap, (unsigned long)st.heap_free, (unsigned long)st.stack,
+             (unsigned long)st.stack_high, (unsigned long)st.gap);
+    if (st.gap < MEMINFO_GAP_WARN)
+    {
+        LOG_WARN("MEM", "only %lu B left between heap and stack", (unsigned long)st.gap);
+    }
+#else
+    LOG_INFO("MEM", "buffers %lu B in %u, no stack or heap figures on the host",
+             (unsigned long)st.buffers, meminfo_count);
+#endif
+}
+
+/* end of file */
@@ -0,0 +1,177 @@
+/*****************************************************************************
+ *                                                                           *
+ * \file pool.c                                                              *
+ *                                                                           *
+ * \brief Static fixed-block pool allocator.                                 *
+ *                                                                           *
+ * \author blackchacal <ribeiro.tonet@gmail.com>                             *
+ * \date Oct 17, 2026                                                        *
+ *                                                                           *
+ * \version 1.0 | \author blackchacal                                        *
+ * File creation.                                                            *
+ *                                                                           *
+ *****************************************************************************/
+
+/*****************************************************************************
+ * Includes                                                                  *
+ *****************************************************************************/
+
+/* --- Standard libraries -------------------- */
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+/* --- Arduino libraries -------------------- */
+#include <Arduino.h>
+
+/* --- Custom modules -------------------- */
+#include "pool.h"
+#include "logger.h"
+
+/*****************************************************************************
+ * Private Functions                                                         *
+ *****************************************************************************/
+
+/**
+ * @brief Masks interrupts and returns the previous mask, which pool_unlock
+ * restores, so a pool may be used inside another critical section or an
+ * ISR. On the host the mask is the simulated interrupt flag.
+ */
+static uint32_t pool_lock (void)
+{
+#if defined(ARDUINO_ARCH_SAMD)
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+
+    return primask;
+#elif defined(SURICATA_NATIVE)
+    uint32_t enabled = native_irq_enabled() ? 1 : 0;
+
+    noInterrupts();
+
+    return enabled;
+#else
+    noInterrupts();
+
+    return 1;
+#endif
+}
+
+static void pool_unlock (uint32_t state)
+{
+#if defined(ARDUINO_ARCH_SAMD)
+    __set_PRIMASK(state);
+#else
+    /* 0 if interrupts were already masked: leave them so. */
+    if (state != 0)
+    {
+        interrupts();
+    }
+#endif
+}
+
+/*****************************************************************************
+ * Public Functions                                                          *
+ *****************************************************************************/
+
+void * pool_alloc (pool_t * pool)
+{
+    void * block = NULL;
+    uint32_t state = 0;
+
+    if (pool == NULL)
+    {
+        return NULL;
+    }
+
+    state = pool_lock();
+    if (pool->free_list != NULL)
+    {
+        block = pool->free_list;
+        pool->free_list = *(void **)block;
+    }
+    else if (pool->carved < pool->count)
+    {
+        block = pool->storage + (uint32_t)pool->carved * pool->stride;
+        pool->carved++;
+    }
+
+    if (block != NULL)
+    {
+        pool->used++;
+        if (pool->used > pool->high_water)
+        {
+            pool->high_water = pool->used;
+        }
+    }
+    else
+    {
+        pool->failed++;
+    }
+    pool_unlock(state);
+
+    return block;
+}
+
+int pool_free (pool_t * pool, void * block)
+{
+    uint32_t off = 0;
+    uint32_t state = 0;
+
+    if ((pool == NULL) || (block == NULL))
+    {
+        return ERR_POOL_NULL_POINTER;
+    }
+
+    off = (uint32_t)((uint8_t *)block - pool->storage);
+    if (((uint8_t *)block < pool->storage) || (off >= (uint32_t)pool->carved * pool->stride) ||
+        ((off % pool->stride) != 0))
+    {
+        return ERR_POOL_INVALID_BLOCK;
+    }
+
+    state = pool_lock();
+    *(void **)block = pool->free_list;
+    pool->free_list = block;
+    pool->used--;
+    pool_unlock(state);
+
+    return ERR_OK;
+}
+
+void pool_stats (const pool_t * pool, pool_stats_t * stats)
+{
+    uint32_t state = 0;
+
+    if ((pool == NULL) || (stats == NULL))
+    {
+        return;
+    }
+
+    state = pool_lock();
+    stats->size = pool->size;
+    stats->count = pool->count;
+    stats->used = pool->used;
+    stats->high_water = pool->high_water;
+    stats->failed = pool->failed;
+    pool_unlock(state);
+}
+
+void pool_report (const pool_t * pool)
+{
+    pool_stats_t stats;
+
+    if (pool == NULL)
+    {
+        return;
+    }
+
+    pool_stats(pool, &stats);
+    LOG_INFO("POOL", "%s: %u x %u bytes, used %u high %u failed %lu", pool->name,
+             stats.count, stats.size, stats.used, stats.high_water,
+             (unsigned long)stats.failed);
+}
+
+/* end of file */
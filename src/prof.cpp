@@ -0,0 +1,283 @@
+/*****************************************************************************
+ *                                                                           *
+ * \file prof.cpp                                                            *
+ *                                                                           *
+ * \brief Profiling zones for the hot paths, reported through the logger.    *
+ *                                                                           *
+ * \author blackchacal <ribeiro.tonet@gmail.com>                             *
+ * \date Oct 17, 2026                                                        *
+ *                                                                           *
+ * \version 1.0 | \author blackchacal                                        *
+ * File creation.                                                            *
+ *                                                                           *
+ *****************************************************************************/
+
+/*****************************************************************************
+ * Includes                                                                  *
+ *****************************************************************************/
+
+/* --- Standard libraries -------------------- */
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#if !defined(__arm__)
+#include <time.h>
+#endif
+
+/* --- Arduino libraries -------------------- */
+#include <Arduino.h>
+
+/* --- Custom modules -------------------- */
+#include "prof.h"
+#include "logger.h"
+
+#if PROF_EN == 1
+
+/*****************************************************************************
+ * Macros                                                                    *
+ *****************************************************************************/
+
+#if defined(__arm__)
+#define PROF_UNIT           "cyc"
+#else
+#define PROF_UNIT           "ns"
+#endif
+
+#define PROF_CALIBRATE_RUNS 32
+
+/*****************************************************************************
+ * Datatypes                                                                 *
+ *****************************************************************************/
+
+/**
+ * \struct prof_zone_t
+ * Accumulated timing of one zone since the last report.
+ */
+typedef struct
+{
+    const char * name;
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint64_t total;
+} prof_zone_t;
+
+/*****************************************************************************
+ * Static Variables                                                          *
+ *****************************************************************************/
+
+static prof_zone_t prof_zones[PROF_MAX_ZONES];
+static uint8_t prof_count = 0;
+static uint32_t prof_overhead = 0;
+
+/*****************************************************************************
+ * Private Functions                                                         *
+ *****************************************************************************/
+
+/**
+ * @brief Current time stamp. On the board SysTick counts the CPU cycles of
+ * the current millisecond, down; a tick still pending (interrupts masked)
+ * means it has just reloaded.
+ */
+static inline uint32_t prof_now (void)
+{
+#if defined(__arm__)
+    uint32_t load = SysTick->LOAD + 1;
+    uint32_t ms = 0;
+    uint32_t val = 0;
+    bool pend = false;
+
+    do
+    {
+        ms = millis();
+        val = SysTick->VAL;
+        pend = (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) != 0;
+    } while (ms != millis());
+
+    if (pend && (val > load / 2))
+    {
+        ms++;
+    }
+
+    return ms * load + (load - 1 - val);
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec);
+#endif
+}
+
+/**
+ * @brief Zone updates run from the main context and from ISRs. On the
+ * board the previous mask is restored, so zones may sit inside critical
+ * sections. The host's interrupts() would run a pending simulated ISR
+ * inside such a section, so there updates are left unguarded: a rare lost
+ * update only blurs the numbers.
+ */
+static inline uint32_t prof_lock (void)
+{
+#if defined(__arm__)
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+
+    return primask;
+#else
+    return 0;
+#endif
+}
+
+static inline void prof_unlock (uint32_t state)
+{
+#if defined(__arm__)
+    __set_PRIMASK(state);
+#else
+    (void)state;
+#endif
+}
+
+/**
+ * @brief Returns the zone called name, adding it if needed. Returns
+ * PROF_MAX_ZONES if the table is full.
+ */
+static uint8_t prof_register (const char * name)
+{
+    uint8_t i = 0;
+
+    for (i = 0; i < prof_count; i++)
+    {
+        if ((prof_zones[i].name == name) || (strcmp(prof_zones[i].name, name) == 0))
+        {
+            return i;
+        }
+    }
+
+    if (prof_count < PROF_MAX_ZONES)
+    {
+        memset(&prof_zones[i], 0, sizeof(prof_zones[i]));
+        prof_zones[i].name = name;
+        prof_zones[i].min = UINT32_MAX;
+        prof_count++;
+    }
+
+    return i;
+}
+
+/*****************************************************************************
+ * Public Functions                                                          *
+ *****************************************************************************/
+
+void prof_init (void)
+{
+    uint32_t best = UINT32_MAX;
+
+    prof_overhead = 0;
+    for (uint8_t i = 0; i < PROF_CALIBRATE_RUNS; i++)
+    {
+        uint32_t t0 = prof_now();
+        uint32_t d = prof_now() - t0;
+
+        if (d < best)
+        {
+            best = d;
+        }
+    }
+    prof_overhead = best;
+}
+
+uint32_t prof_begin (uint8_t * id, const char * name)
+{
+    if (*id == PROF_NO_ZONE)
+    {
+        uint32_t state = prof_lock();
+
+        if (*id == PROF_NO_ZONE)
+        {
+            *id = prof_register(name);
+        }
+        prof_unlock(state);
+    }
+
+    return prof_now();
+}
+
+void prof_end (uint8_t id, uint32_t start)
+{
+    uint32_t d = prof_now() - start;
+    uint32_t state = 0;
+    prof_zone_t * zone = NULL;
+
+    if (id >= PROF_MAX_ZONES)
+    {
+        return;
+    }
+
+    d = (d > prof_overhead) ? (d - prof_overhead) : 0;
+    zone = &prof_zones[id];
+
+    state = prof_lock();
+    zone->count++;
+    zone->total += d;
+    if (d < zone->min)
+    {
+        zone->min = d;
+    }
+    if (d > zone->max)
+    {
+        zone->max = d;
+    }
+    prof_unlock(state);
+}
+
+void prof_report (void)
+{
+    for (uint8_t i = 0; i < prof_count; i++)
+    {
+        prof_zone_t zone;
+        uint32_t state = prof_lock();
+
+        /* Logging runs zones too: copy and restart first. */
+        zone = prof_zones[i];
+        prof_zones[i].count = 0;
+        prof_zones[i].min = UINT32_MAX;
+        prof_zones[i].max = 0;
+        prof_zones[i].total = 0;
+        prof_unlock(state);
+
+        if (zone.count > 0)
+        {
+            LOG_INFO("PROF", "%-12s n %lu min %lu avg %lu max %lu total %lu %s",
+                     zone.name, (unsigned long)zone.count, (unsigned long)zone.min,
+                     (unsigned long)(zone.total / zone.count), (unsigned long)zone.max,
+                     (unsigned long)zone.total, PROF_UNIT);
+        }
+    }
+}
+
+#else
+
+void prof_init (void)
+{
+}
+
+uint32_t prof_begin (uint8_t * id, const char * name)
+{
+    (void)id;
+    (void)name;
+
+    return 0;
+}
+
+void prof_end (uint8_t id, uint32_t start)
+{
+    (void)id;
+    (void)start;
+}
+
+void prof_report (void)
+{
+}
+
+#endif
+
+/* end of file */
@@ -0,0 +1,518 @@
+/*****************************************************************************
+ *                                                                           *
+ * \file rbuffer.cpp                                                         *
+ *                                                                           *
+ * \brief Ring buffer module.                                                *
+ *                                                                           *
+ * \author blackchacal <ribeiro.tonet@gmail.com>                             *
+ * \date May 30, 2022                                                        *
+ *                                                                           *
+ * \version 1.0 | \author blackchacal                                        *
+ * File creation.                                                            *
+ *                                                                           *
+ *****************************************************************************/
+
+/*****************************************************************************
+ * Includes                                                                  *
+ *****************************************************************************/
+
+/* --- Standard libraries -------------------- */
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+/* --- Custom modules -------------------- */
+#include "rbuffer.h"
+#include "rbuffer.hpp"
+#include "prof.h"
+
+/*****************************************************************************
+ * Datatypes                                                                 *
+ *****************************************************************************/
+
+namespace
+{
+
+/**
+ * \struct CRing
+ * Adapts a C rbuffer_t to the ring interface expected by rbuffer_core.
+ */
+struct CRing
+{
+    typedef uint8_t value_type;
+
+    rbuffer_t * rb;
+
+    uint8_t * data (void)                   { return rb->buf; }
+    uint16_t size (void) const              { return rb->size; }
+    uint16_t mask (void) const              { return rb->size - 1; }
+    uint16_t & head (void)                  { return rb->head; }
+    uint16_t & tail (void)                  { return rb->tail; }
+    uint16_t & lot (void)                   { return rb->lot; }
+    const uint16_t & lot (void) const       { return rb->lot; }
+    rbuffer_policy_t policy (void) const    { return (rbuffer_policy_t)rb->policy; }
+    uint32_t & ovr (void)                   { return rb->overruns; }
+    uint32_t & mark (void)                  { return rb->mark; }
+};
+
+typedef rbuffer_core::Ops<CRing> ops;
+
+inline CRing ring (const rbuffer_t * rb)
+{
+    CRing r = { const_cast<rbuffer_t *>(rb) };
+    return r;
+}
+
+/* --- Statistics -----------------------------------------------------------*/
+
+#if RBUFFER_STATS_EN == 1
+
+/**
+ * @brief Producer side, after an add or commit. Starts following the last
+ * byte added if no byte is followed.
+ */
+inline void stats_in (rbuffer_t * rb, int err, uint16_t n)
+{
+    rbuffer_stats_t * stats = &rb->stats;
+
+    if ((err == ERR_RBUFFER_FULL) || (err == ERR_RBUFFER_NOT_ENOUGH_SPACE))
+    {
+        stats->rejected++;
+    }
+    if (err != ERR_OK)
+    {
+        return;
+    }
+
+    stats->bytes_in += n;
+    if (rbuffer_core::load(rb->lot) > stats->high_water)
+    {
+        stats->high_water = rbuffer_core::load(rb->lot);
+    }
+    if (__atomic_load_n(&rb->probe_armed, __ATOMIC_ACQUIRE) == 0)
+    {
+        rb->probe_pos = stats->bytes_in;
+        rb->probe_us = micros();
+        __atomic_store_n(&rb->probe_armed, 1, __ATOMIC_RELEASE);
+    }
+}
+
+/**
+ * @brief Consumer side, after n bytes were removed. Bytes leave in order,
+ * taken or dropped as overruns, so the followed byte left once bytes_out
+ * plus overruns reach probe_pos. Its residence is only recorded if this
+ * removal took it.
+ */
+inline void stats_out (rbuffer_t * rb, int err, uint16_t n, bool taken)
+{
+    rbuffer_stats_t * stats = &rb->stats;
+    uint32_t before = 0;
+    uint8_t bucket = 0;
+
+    if (err != ERR_OK)
+    {
+        return;
+    }
+
+    before = stats->bytes_out + rbuffer_core::load(rb->overruns);
+    stats->bytes_out += n;
+    if ((__atomic_load_n(&rb->probe_armed, __ATOMIC_ACQUIRE) == 0) ||
+        ((int32_t)(before + n - rb->probe_pos) < 0))
+    {
+        return;
+    }
+
+    if (taken && ((int32_t)(before - rb->probe_pos) < 0))
+    {
+        for (uint32_t us = (micros() - rb->probe_us) >> 7;
+             (us > 0) && (bucket < (RBUFFER_STATS_BUCKETS - 1)); us >>= 1)
+        {
+            bucket++;
+        }
+        stats->residence[bucket]++;
+    }
+    __atomic_store_n(&rb->probe_armed, 0, __ATOMIC_RELEASE);
+}
+
+#else
+
+inline void stats_in (rbuffer_t * rb, int err, uint16_t n)
+{
+    (void)rb;
+    (void)err;
+    (void)n;
+}
+
+inline void stats_out (rbuffer_t * rb, int err, uint16_t n, bool taken)
+{
+    (void)rb;
+    (void)err;
+    (void)n;
+    (void)taken;
+}
+
+#endif
+
+} /* namespace */
+
+/*****************************************************************************
+ * Public Functions                                                          *
+ *****************************************************************************/
+
+/**
+ * @brief Initializes rbuffer struct.
+ */
+int rbuffer_init (rbuffer_t * rb, uint8_t * buffer, uint16_t buf_size, rbuffer_policy_t policy)
+{
+    int err = ERR_OK;
+
+    if ((rb == NULL) || (buffer == NULL))
+    {
+        err = ERR_RBUFFER_NULL_POINTER;
+    }
+    else if ((buf_size == 0) || ((buf_size & (buf_size - 1)) != 0))
+    {
+        err = ERR_RBUFFER_INVALID_SIZE;
+    }
+    else
+    {
+        rb->buf = buffer;
+        rb->head = 0;
+        rb->tail = 0;
+        rb->lot = 0;
+        rb->size = buf_size;
+        rb->policy = (uint8_t)policy;
+        rb->overruns = 0;
+        rb->mark = 0;
+#if RBUFFER_STATS_EN == 1
+        memset(&rb->stats, 0, sizeof(rb->stats));
+        rb->probe_armed = 0;
+#endif
+    }
+
+    return err;
+}
+
+/**
+ * @brief Adds one byte to rbuffer.
+ */
+int rbuffer_add_byte (rbuffer_t * rb, uint8_t byte)
+{
+    int err = ERR_OK;
+
+    if (rb == NULL)
+    {
+        err = ERR_RBUFFER_NULL_POINTER;
+    }
+    else
+    {
+        CRing r = ring(rb);
+        err = ops::add(r, byte);
+        stats_in(rb, err, 1);
+    }
+
+    return err;
+}
+
+/**
+ * @brief Adds several bytes to rbuffer.
+ */
+int rbuffer_add_bytes (rbuffer_t * rb, const uint8_t * data, uint16_t nbytes)
+{
+    int err = ERR_OK;
+
+    if ((rb == NULL) || (data == NULL))
+    {
+        err = ERR_RBUFFER_NULL_POINTER;
+    }
+    else
+    {
+        PROF_SCOPE(rb_add);
+        CRing r = ring(rb);
+        err = ops::add(r, data, nbytes);
+        stats_in(rb, err, nbytes);
+    }
+
+    return err;
+}
+
+/**
+ * @brief Gets one byte from rbuffer.
+ */
+int rbuffer_get_byte (rbuffer_t * rb, uint8_t * byte)
+{
+    int err = ERR_OK;
+
+    if ((rb == NULL) || (byte == NULL))
+    {
+        err = ERR_RBUFFER_NULL_POINTER;
+    }
+    else
+    {
+        CRing r = ring(rb);
+        err = ops::get(r, *byte);
+        stats_out(rb, err, 1, true);
+    }
+
+    return err;
+}
+
+/**
+ * @brief Gets several bytes from rbuffer.
+ */
+int rbuffer_get_bytes (rbuffer_t * rb, uint8_t * data, uint16_t nbytes)
+{
+    int err = ERR_OK;
+
+    if ((rb == NULL) || (data == NULL))
+    {
+        err = ERR_RBUFFER_NULL_POINTER;
+    }
+    else
+    {
+        PROF_SCOPE(rb_get);
+        CRing r = ring(rb);
+        err = ops::get(r, data, nbytes);
+        stats_out(rb, err, nbytes, true);
+    }
+
+    return err;
+}
+
+/**
+ * @brief Reserves nbytes of free space for in-place writing.
+ */
+int rbuffer_reserve (rbuffer_t * rb, uint16_t nbytes, rbuffer_span_t span[RBUFFER_MAX_SPANS])
+{
+    int err = ERR_OK;
+
+    if ((rb == NULL) || (span == NULL))
+    {
+        err = ERR_RBUFFER_NULL_POINTER;
+    }
+    else
+    {
+        PROF_SCOPE(rb_reserve);
+        CRing r = ring(rb);
+        err = ops::reserve(r, nbytes, span);
+        if (err != ERR_OK)
+        {
+            stats_in(rb, err, 0);
+        }
+    }
+
+    return err;
+}
+
+/**
+ * @brief Publishes nbytes previously written through rbuffer_reserve.
+ */
+int rbuffer_commit (rbuffer_t * rb, uint16_t nbytes)
+{
+    int err = ERR_OK;
+
+    if (rb == NULL)
+    {
+        err = ERR_RBUFFER_NULL_POINTER;
+    }
+    else
+    {
+        PROF_SCOPE(rb_commit);
+        CRing r = ring(rb);
+        err = ops::commit(r, nbytes);
+        stats_in(rb, err, nbytes);
+    }
+
+    return err;
+}
+
+/**
+ * @brief Exposes all readable data in place without removing it.
+ */
+int rbuffer_peek (rbuffer_t * rb, rbuffer_span_t span[RBUFFER_MAX_SPANS])
+{
+    int err = ERR_OK;
+
+    if ((rb == NULL) || (span == NULL))
+    {
+        err = ERR_RBUFFER_NULL_POINTER;
+    }
+    else
+    {
+        PROF_SCOPE(rb_peek);
+        CRing r = ring(rb);
+        err = ops::peek(r, span);
+    }
+
+    return err;
+}
+
+/**
+ * @brief Removes nbytes of data, typically after rbuffer_peek.
+ */
+int rbuffer_consume (rbuffer_t * rb, uint16_t nbytes)
+{
+    int err = ERR_OK;
+
+    if (rb == NULL)
+    {
+        err = ERR_RBUFFER_NULL_POINTER;
+    }
+    else
+    {
+        PROF_SCOPE(rb_consume);
+        CRing r = ring(rb);
+        err = ops::consume(r, nbytes);
+        stats_out(rb, err, nbytes, true);
+    }
+
+    return err;
+}
+
+/**
+ * @brief Producer-side removal of the oldest nbytes, counted as overruns.
+ */
+int rbuffer_drop (rbuffer_t * rb, uint16_t nbytes)
+{
+    int err = ERR_OK;
+
+    if (rb == NULL)
+    {
+        err = ERR_RBUFFER_NULL_POINTER;
+    }
+    else
+    {
+        CRing r = ring(rb);
+        err = ops::drop(r, nbytes);
+    }
+
+    return err;
+}
+
+/**
+ * @brief Check if rbuffer is empty.
+ */
+bool rbuffer_empty (const rbuffer_t * rb)
+{
+    return (rb == NULL) ? false : ops::empty(ring(rb));
+}
+
+/**
+ * @brief Checks if rbuffer is full.
+ */
+bool rbuffer_full (const rbuffer_t * rb)
+{
+    return (rb == NULL) ? false : ops::full(ring(rb));
+}
+
+/**
+ * @brief Returns rbuffer free space.
+ */
+uint16_t rbuffer_free (const rbuffer_t * rb)
+{
+    return (rb == NULL) ? 0 : ops::free(ring(rb));
+}
+
+/**
+ * @brief Returns rbuffer used space.
+ */
+uint16_t rbuffer_used (const rbuffer_t * rb)
+{
+    return (rb == NULL) ? 0 : ops::used(ring(rb));
+}
+
+/**
+ * @brief Returns the number of bytes dropped by RBUFFER_POLICY_OVERWRITE.
+ */
+uint32_t rbuffer_overruns (const rbuffer_t * rb)
+{
+    return (rb == NULL) ? 0 : rbuffer_core::load(rb->overruns);
+}
+
+/**
+ * @brief Clears rbuffer by resetting all pointers.
+ */
+int rbuffer_clear (rbuffer_t * rb)
+{
+    int err = ERR_OK;
+
+    if (rb == NULL)
+    {
+        err = ERR_RBUFFER_NULL_POINTER;
+    }
+    else
+    {
+        CRing r = ring(rb);
+        uint16_t held = ops::used(r);
+
+        ops::clear(r);
+        if (held > 0)
+        {
+            stats_out(rb, ERR_OK, held, false);
+        }
+    }
+
+    return err;
+}
+
+/**
+ * @brief Takes a consistent copy of the statistics.
+ */
+int rbuffer_stats (const rbuffer_t * rb, rbuffer_stats_t * stats)
+{
+    int err = ERR_OK;
+
+    if ((rb == NULL) || (stats == NULL))
+    {
+        err = ERR_RBUFFER_NULL_POINTER;
+    }
+    else
+    {
+#if RBUFFER_STATS_EN == 1
+        rbuffer_core::enter_critical();
+        *stats = rb->stats;
+        rbuffer_core::exit_critical();
+#else
+        memset(stats, 0, sizeof(*stats));
+#endif
+    }
+
+    return err;
+}
+
+/**
+ * @brief Residence time under which pct percent of the samples fall.
+ */
+uint32_t rbuffer_stats_residence (const rbuffer_stats_t * stats, uint8_t pct)
+{
+    uint32_t total = 0;
+    uint32_t seen = 0;
+    uint8_t i = 0;
+
+    if (stats == NULL)
+    {
+        return 0;
+    }
+
+    for (i = 0; i < RBUFFER_STATS_BUCKETS; i++)
+    {
+        total += stats->residence[i];
+    }
+    if (total == 0)
+    {
+        return 0;
+    }
+
+    for (i = 0; i < (RBUFFER_STATS_BUCKETS - 1); i++)
+    {
+        seen += stats->residence[i];
+        if ((uint64_t)seen * 100 >= (uint64_t)total * pct)
+        {
+            break;
+        }
+    }
+
+    return 1UL << (i + 7);
+}
+
+/* end of file */
\ No newline at end of file
@@ -0,0 +1,447 @@
+/*****************************************************************************
+ *                                                                           *
+ * \file rbuffer_spsc.c                                                      *
+ *                                                                           *
+ * \brief Lock-free single-producer/single-consumer ring buffer module.      *
+ *                                                                           *
+ * \author blackchacal <ribeiro.tonet@gmail.com>                             *
+ * \date Oct 17, 2026                                                        *
+ *                                                                           *
+ * \version 1.0 | \author blackchacal                                        *
+ * File creation.                                                            *
+ *                                                                           *
+ *****************************************************************************/
+
+/*****************************************************************************
+ * Includes                                                                  *
+ *****************************************************************************/
+
+/* --- Standard libraries -------------------- */
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+/* --- Custom modules -------------------- */
+#include "rbuffer_spsc.h"
+
+/*****************************************************************************
+ * Macros                                                                    *
+ *****************************************************************************/
+
+/* Aligned 16 bit accesses are single instructions on the Cortex-M0+, so    */
+/* these only add the compiler (and, where needed, hardware) ordering.      */
+#define LOAD_RELAXED(p)         __atomic_load_n((p), __ATOMIC_RELAXED)
+#define LOAD_ACQUIRE(p)         __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define STORE_RELEASE(p, v)     __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+
+/*****************************************************************************
+ * Private Functions                                                         *
+ *****************************************************************************/
+
+/**
+ * @brief Splits nbytes starting at free-running index pos into contiguous
+ * spans.
+ */
+static void rbuffer_spsc_split (const rbuffer_spsc_t * rb, uint16_t pos, uint16_t nbytes,
+                                rbuffer_span_t span[RBUFFER_MAX_SPANS])
+{
+    uint16_t idx = pos & rb->mask;
+    uint16_t size_to_end = rb->size - idx;
+
+    span[0].ptr = rb->buf + idx;
+    if (size_to_end < nbytes)
+    {
+        span[0].len = size_to_end;
+        span[1].ptr = rb->buf;
+        span[1].len = nbytes - size_to_end;
+    }
+    else
+    {
+        span[0].len = nbytes;
+        span[1].ptr = rb->buf;
+        span[1].len = 0;
+    }
+}
+
+/*****************************************************************************
+ * Public Functions                                                          *
+ *****************************************************************************/
+
+/**
+ * @brief Initializes rbuffer_spsc struct.
+ */
+int rbuffer_spsc_init (rbuffer_spsc_t * rb, uint8_t * buffer, uint16_t buf_size)
+{
+    int err = ERR_OK;
+
+    if ((rb == NULL) || (buffer == NULL))
+    {
+        err = ERR_RBUFFER_NULL_POINTER;
+    }
+    else if ((buf_size == 0) || ((buf_size & (buf_size - 1)) != 0) ||
+             (buf_size > RBUFFER_SPSC_MAX_SIZE))
+    {
+        err = ERR_RBUFFER_INVALID_SIZE;
+    }
+    else
+    {
+        rb->buf = buffer;
+        rb->size = buf_size;
+        rb->mask = buf_size - 1;
+        STORE_RELEASE(&rb->tail, 0);
+        STORE_RELEASE(&rb->head, 0);
+    }
+
+    return err;
+}
+
+/**
+ * @brief Adds one byte to rbuffer_spsc.
+ */
+int rbuffer_spsc_add_byte (rbuffer_spsc_t * rb, uint8_t byte)
+{
+    int err = ERR_OK;
+
+    if (rb == NULL)
+    {
+        err = ERR_RBUFFER_NULL_POINTER;
+    }
+    else
+    {
+        uint16_t head = LOAD_RELAXED(&rb->head);
+        uint16_t tail = LOAD_ACQUIRE(&rb->tail);
+
+        if ((uint16_t)(head - tail) == rb->size)
+        {
+            err = ERR_RBUFFER_FULL;
+        }
+        else
+        {
+            rb->buf[head & rb->mask] = byte;
+            STORE_RELEASE(&rb->head, (uint16_t)(head + 1));
+        }
+    }
+
+    return err;
+}
+
+/**
+ * @brief Adds several bytes to rbuffer_spsc.
+ */
+int rbuffer_spsc_add_bytes (rbuffer_spsc_t * rb, const uint8_t * data, uint16_t nbytes)
+{
+    int err = ERR_OK;
+
+    if ((rb == NULL) || (data == NULL))
+    {
+        err = ERR_RBUFFER_NULL_POINTER;
+    }
+    else if (nbytes == 0)
+    {
+        err = ERR_RBUFFER_INVALID_SIZE;
+    }
+    else
+    {
+        uint16_t head = LOAD_RELAXED(&rb->head);
+        uint16_t tail = LOAD_ACQUIRE(&rb->tail);
+        uint16_t used = head - tail;
+
+        if (used == rb->size)
+        {
+            err = ERR_RBUFFER_FULL;
+        }
+        else if (nbytes > (rb->size - used))
+        {
+            err = ERR_RBUFFER_NOT_ENOUGH_SPACE;
+        }
+        else
+        {
+            uint16_t idx = head & rb->mask;
+            uint16_t size_to_end = rb->size - idx;
+            if (size_to_end < nbytes)
+            {
+                memcpy(rb->buf + idx, data, size_to_end);
+                memcpy(rb->buf, data + size_to_end, nbytes - size_to_end);
+            }
+            else
+            {
+                memcpy(rb->buf + idx, data, nbytes);
+            }
+            STORE_RELEASE(&rb->head, (uint16_t)(head + nbytes));
+        }
+    }
+
+    return err;
+}
+
+/**
+ * @brief Gets one byte from rbuffer_spsc.
+ */
+int rbuffer_spsc_get_byte (rbuffer_spsc_t * rb, uint8_t * byte)
+{
+    int err = ERR_OK;
+
+    if ((rb == NULL) || (byte == NULL))
+    {
+        err = ERR_RBUFFER_NULL_POINTER;
+    }
+    else
+    {
+        uint16_t tail = LOAD_RELAXED(&rb->tail);
+        uint16_t head = LOAD_ACQUIRE(&rb->head);
+
+        if (head == tail)
+        {
+            err = ERR_RBUFFER_EMPTY;
+        }
+        else
+        {
+            *byte = rb->buf[tail & rb->mask];
+            STORE_RELEASE(&rb->tail, (uint16_t)(tail + 1));
+        }
+    }
+
+    return err;
+}
+
+/**
+ * @brief Gets several bytes from rbuffer_spsc.
+ */
+int rbuffer_spsc_get_bytes (rbuffer_spsc_t * rb, uint8_t * data, uint16_t nbytes)
+{
+    int err = ERR_OK;
+
+    if ((rb == NULL) || (data == NULL))
+    {
+        err = ERR_RBUFFER_NULL_POINTER;
+    }
+    else if (nbytes == 0)
+    {
+        err = ERR_RBUFFER_INVALID_SIZE;
+    }
+    else
+    {
+        uint16_t tail = LOAD_RELAXED(&rb->tail);
+        uint16_t head = LOAD_ACQUIRE(&rb->head);
+        uint16_t used = head - tail;
+
+        if (used == 0)
+        {
+            err = ERR_RBUFFER_EMPTY;
+        }
+        else if (nbytes > used)
+        {
+            err = ERR_RBUFFER_NOT_ENOUGH_DATA;
+        }
+        else
+        {
+            uint16_t idx = tail & rb->mask;
+            uint16_t size_to_end = rb->size - idx;
+            if (size_to_end < nbytes)
+            {
+                memcpy(data, rb->buf + idx, size_to_end);
+                memcpy(data + size_to_end, rb->buf, nbytes - size_to_end);
+            }
+            else
+            {
+                memcpy(data, rb->buf + idx, nbytes);
+            }
+            STORE_RELEASE(&rb->tail, (uint16_t)(tail + nbytes));
+        }
+    }
+
+    return err;
+}
+
+/**
+ * @brief Reserves nbytes of free space for in-place writing.
+ */
+int rbuffer_spsc_reserve (rbuffer_spsc_t * rb, uint16_t nbytes, rbuffer_span_t span[RBUFFER_MAX_SPANS])
+{
+    int err = ERR_OK;
+
+    if ((rb == NULL) || (span == NULL))
+    {
+        err = ERR_RBUFFER_NULL_POINTER;
+    }
+    else if (nbytes == 0)
+    {
+        err = ERR_RBUFFER_INVALID_SIZE;
+    }
+    else
+    {
+        uint16_t head = LOAD_RELAXED(&rb->head);
+        uint16_t tail = LOAD_ACQUIRE(&rb->tail);
+        uint16_t used = head - tail;
+
+        if (used == rb->size)
+        {
+            err = ERR_RBUFFER_FULL;
+        }
+        else if (nbytes > (rb->size - used))
+        {
+            err = ERR_RBUFFER_NOT_ENOUGH_SPACE;
+        }
+        else
+        {
+            rbuffer_spsc_split(rb, head, nbytes, span);
+        }
+    }
+
+    return err;
+}
+
+/**
+ * @brief Publishes nbytes previously written through rbuffer_spsc_reserve.
+ */
+int rbuffer_spsc_commit (rbuffer_spsc_t * rb, uint16_t nbytes)
+{
+    int err = ERR_OK;
+
+    if (rb == NULL)
+    {
+        err = ERR_RBUFFER_NULL_POINTER;
+    }
+    else if (nbytes == 0)
+    {
+        err = ERR_RBUFFER_INVALID_SIZE;
+    }
+    else
+    {
+        uint16_t head = LOAD_RELAXED(&rb->head);
+        uint16_t tail = LOAD_ACQUIRE(&rb->tail);
+
+        if (nbytes > (uint16_t)(rb->size - (uint16_t)(head - tail)))
+        {
+            err = ERR_RBUFFER_NOT_ENOUGH_SPACE;
+        }
+        else
+        {
+            STORE_RELEASE(&rb->head, (uint16_t)(head + nbytes));
+        }
+    }
+
+    return err;
+}
+
+/**
+ * @brief Exposes all readable data in place without removing it.
+ */
+int rbuffer_spsc_peek (const rbuffer_spsc_t * rb, rbuffer_span_t span[RBUFFER_MAX_SPANS])
+{
+    int err = ERR_OK;
+
+    if ((rb == NULL) || (span == NULL))
+    {
+        err = ERR_RBUFFER_NULL_POINTER;
+    }
+    else
+    {
+        uint16_t tail = LOAD_RELAXED(&rb->tail);
+        uint16_t head = LOAD_ACQUIRE(&rb->head);
+
+        if (head == tail)
+        {
+            err = ERR_RBUFFER_EMPTY;
+        }
+        else
+        {
+            rbuffer_spsc_split(rb, tail, (uint16_t)(head - tail), span);
+        }
+    }
+
+    return err;
+}
+
+/**
+ * @brief Removes nbytes of data, typically after rbuffer_spsc_peek.
+ */
+int rbuffer_spsc_consume (rbuffer_spsc_t * rb, uint16_t nbytes)
+{
+    int err = ERR_OK;
+
+    if (rb == NULL)
+    {
+        err = ERR_RBUFFER_NULL_POINTER;
+    }
+    else if (nbytes == 0)
+    {
+        err = ERR_RBUFFER_INVALID_SIZE;
+    }
+    else
+    {
+        uint16_t tail = LOAD_RELAXED(&rb->tail);
+        uint16_t head = LOAD_ACQUIRE(&rb->head);
+        uint16_t used = head - tail;
+
+        if (used == 0)
+        {
+            err = ERR_RBUFFER_EMPTY;
+        }
+        else if (nbytes > used)
+        {
+            err = ERR_RBUFFER_NOT_ENOUGH_DATA;
+        }
+        else
+        {
+            STORE_RELEASE(&rb->tail, (uint16_t)(tail + nbytes));
+        }
+    }
+
+    return err;
+}
+
+/**
+ * @brief Check if rbuffer_spsc is empty.
+ */
+bool rbuffer_spsc_empty (const rbuffer_spsc_t * rb)
+{
+    return (rb == NULL) ? false : (rbuffer_spsc_used(rb) == 0);
+}
+
+/**
+ * @brief Checks if rbuffer_spsc is full.
+ */
+bool rbuffer_spsc_full (const rbuffer_spsc_t * rb)
+{
+    return (rb == NULL) ? false : (rbuffer_spsc_used(rb) == rb->size);
+}
+
+/**
+ * @brief Returns rbuffer_spsc free space.
+ */
+uint16_t rbuffer_spsc_free (const rbuffer_spsc_t * rb)
+{
+    return (rb == NULL) ? 0 : (rb->size - rbuffer_spsc_used(rb));
+}
+
+/**
+ * @brief Returns rbuffer_spsc used space.
+ */
+uint16_t rbuffer_spsc_used (const rbuffer_spsc_t * rb)
+{
+    return (rb == NULL) ? 0 :
+        (uint16_t)(LOAD_ACQUIRE(&rb->head) - LOAD_ACQUIRE(&rb->tail));
+}
+
+/**
+ * @brief Discards all pending data.
+ */
+int rbuffer_spsc_clear (rbuffer_spsc_t * rb)
+{
+    int err = ERR_OK;
+
+    if (rb == NULL)
+    {
+        err = ERR_RBUFFER_NULL_POINTER;
+    }
+    else
+    {
+        STORE_RELEASE(&rb->tail, LOAD_ACQUIRE(&rb->head));
+    }
+
+    return err;
+}
+
+/* end of file */
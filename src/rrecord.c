@@ -0,0 +1,303 @@
+/*****************************************************************************
+ *                                                                           *
+ * \file rrecord.c                                                           *
+ *                                                                           *
+ * \brief Variable-length record framing on top of rbuffer.                  *
+ *                                                                           *
+ * \author blackchacal <ribeiro.tonet@gmail.com>                             *
+ * \date Oct 17, 2026                                                        *
+ *                                                                           *
+ * \version 1.0 | \author blackchacal                                        *
+ * File creation.                                                            *
+ *                                                                           *
+ *****************************************************************************/
+
+/*****************************************************************************
+ * Includes                                                                  *
+ *****************************************************************************/
+
+/* --- Standard libraries -------------------- */
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+/* --- Custom modules -------------------- */
+#include "rbuffer.h"
+#include "rrecord.h"
+
+/*****************************************************************************
+ * Private Functions                                                         *
+ *****************************************************************************/
+
+static uint16_t rrecord_get_hdr (const uint8_t * p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static void rrecord_set_hdr (uint8_t * p, uint16_t value)
+{
+    p[0] = (uint8_t)(value & 0xFF);
+    p[1] = (uint8_t)(value >> 8);
+}
+
+/**
+ * @brief Locates the record that starts off bytes after storage index
+ * start, given used readable bytes from start. nbytes includes any skipped
+ * bytes in front of the record.
+ */
+static int rrecord_locate (const rbuffer_t * rb, uint16_t start, uint16_t used, uint16_t off,
+                           rrecord_t * rec, uint16_t * nbytes)
+{
+    int err = ERR_OK;
+    uint16_t idx = (start + off) & (rb->size - 1);
+    uint16_t to_end = rb->size - idx;
+    uint16_t skip = 0;
+    uint16_t len = 0;
+
+    if (off >= used)
+    {
+        err = ERR_RBUFFER_EMPTY;
+    }
+    else
+    {
+        if ((to_end < RRECORD_HDR_SIZE) || (rrecord_get_hdr(rb->buf + idx) == RRECORD_SKIP))
+        {
+            skip = to_end;
+            idx = 0;
+        }
+
+        if ((used - off) < (skip + RRECORD_HDR_SIZE))
+        {
+            err = ERR_RRECORD_CORRUPT;
+        }
+        else
+        {
+            len = rrecord_get_hdr(rb->buf + idx);
+            if ((len == 0) || (len > (used - off - skip - RRECORD_HDR_SIZE)))
+            {
+                err = ERR_RRECORD_CORRUPT;
+            }
+            else
+            {
+                rec->data = rb->buf + idx + RRECORD_HDR_SIZE;
+                rec->len = len;
+                *nbytes = skip + RRECORD_HDR_SIZE + len;
+            }
+        }
+    }
+
+    return err;
+}
+
+/**
+ * @brief Writes one record contiguously into the free space, skipping the
+ * tail end of the storage if needed, and commits it in one step.
+ */
+static int rrecord_place (rbuffer_t * rb, const uint8_t * data, uint16_t len)
+{
+    rbuffer_span_t span[RBUFFER_MAX_SPANS];
+    uint16_t need = RRECORD_HDR_SIZE + len;
+    uint16_t avail = rbuffer_free(rb);
+    uint8_t * dst = NULL;
+    uint16_t total = 0;
+    int err = (avail == 0) ? ERR_RBUFFER_FULL : rbuffer_reserve(rb, avail, span);
+
+    if (err == ERR_OK)
+    {
+        if (span[0].len >= need)
+        {
+            dst = span[0].ptr;
+            total = need;
+        }
+        else if (span[1].len >= need)
+        {
+            /* span[0] runs to the end of the storage. */
+            if (span[0].len >= RRECORD_HDR_SIZE)
+            {
+                rrecord_set_hdr(span[0].ptr, RRECORD_SKIP);
+            }
+            dst = span[1].ptr;
+            total = span[0].len + need;
+        }
+        else
+        {
+            err = ERR_RBUFFER_NOT_ENOUGH_SPACE;
+        }
+    }
+
+    if (err == ERR_OK)
+    {
+        rrecord_set_hdr(dst, len);
+        memcpy(dst + RRECORD_HDR_SIZE, data, len);
+        err = rbuffer_commit(rb, total);
+    }
+
+    return err;
+}
+
+/**
+ * @brief Producer-side drop of the oldest whole record. A corrupt ring is
+ * dropped entirely so framing restarts from a clean state.
+ */
+static int rrecord_drop_oldest (rbuffer_t * rb)
+{
+    rrecord_t rec;
+    uint16_t nbytes = 0;
+    uint16_t used = rbuffer_used(rb);
+    int err = rrecord_locate(rb, rb->tail, used, 0, &rec, &nbytes);
+
+    if (err == ERR_OK)
+    {
+        err = rbuffer_drop(rb, nbytes);
+    }
+    else if (err == ERR_RRECORD_CORRUPT)
+    {
+        err = rbuffer_drop(rb, used);
+    }
+
+    return err;
+}
+
+/*****************************************************************************
+ * Public Functions                                                          *
+ *****************************************************************************/
+
+/**
+ * @brief Pushes one record.
+ */
+int rrecord_push (rbuffer_t * rb, const uint8_t * data, uint16_t len)
+{
+    int err = ERR_OK;
+
+    if ((rb == NULL) || (data == NULL))
+    {
+        err = ERR_RBUFFER_NULL_POINTER;
+    }
+    else if (len == 0)
+    {
+        err = ERR_RBUFFER_INVALID_SIZE;
+    }
+    else if (len > RRECORD_MAX_LEN(rb->size))
+    {
+        err = ERR_RRECORD_TOO_LARGE;
+    }
+    else
+    {
+        err = rrecord_place(rb, data, len);
+        while (((err == ERR_RBUFFER_FULL) || (err == ERR_RBUFFER_NOT_ENOUGH_SPACE)) &&
+               (rb->policy == RBUFFER_POLICY_OVERWRITE) && !rbuffer_empty(rb))
+        {
+            err = rrecord_drop_oldest(rb);
+            if (err == ERR_OK)
+            {
+                err = rrecord_place(rb, data, len);
+            }
+        }
+    }
+
+    return err;
+}
+
+/**
+ * @brief Pops the oldest record into data.
+ */
+int rrecord_pop (rbuffer_t * rb, uint8_t * data, uint16_t max_len, uint16_t * len)
+{
+    int err = ERR_OK;
+    rbuffer_span_t span[RBUFFER_MAX_SPANS];
+    rrecord_t rec;
+    uint16_t nbytes = 0;
+
+    if ((rb == NULL) || (data == NULL) || (len == NULL))
+    {
+        err = ERR_RBUFFER_NULL_POINTER;
+    }
+    else
+    {
+        do
+        {
+            err = rbuffer_peek(rb, span);
+            if (err == ERR_OK)
+            {
+                err = rrecord_locate(rb, (uint16_t)(span[0].ptr - rb->buf),
+                                     span[0].len + span[1].len, 0, &rec, &nbytes);
+            }
+            if (err == ERR_OK)
+            {
+                *len = rec.len;
+                if (rec.len > max_len)
+                {
+                    err = ERR_RRECORD_BUFFER_TOO_SMALL;
+                }
+                else
+                {
+                    memcpy(data, rec.data, rec.len);
+                    err = rbuffer_consume(rb, nbytes);
+                }
+            }
+        } while (err == ERR_RBUFFER_OVERRUN);
+    }
+
+    return err;
+}
+
+/**
+ * @brief Exposes up to max_recs of the oldest records in place.
+ */
+int rrecord_peek_batch (rbuffer_t * rb, rrecord_t * recs, uint16_t max_recs,
+                        uint16_t * count, uint16_t * nbytes)
+{
+    int err = ERR_OK;
+    rbuffer_span_t span[RBUFFER_MAX_SPANS];
+
+    if ((rb == NULL) || (recs == NULL) || (count == NULL) || (nbytes == NULL))
+    {
+        err = ERR_RBUFFER_NULL_POINTER;
+    }
+    else if (max_recs == 0)
+    {
+        err = ERR_RBUFFER_INVALID_SIZE;
+    }
+    else
+    {
+        *count = 0;
+        *nbytes = 0;
+
+        err = rbuffer_peek(rb, span);
+        if (err == ERR_OK)
+        {
+            uint16_t start = (uint16_t)(span[0].ptr - rb->buf);
+            uint16_t used = span[0].len + span[1].len;
+            uint16_t n = 0;
+
+            while ((err == ERR_OK) && (*count < max_recs) && (*nbytes < used))
+            {
+                err = rrecord_locate(rb, start, used, *nbytes, &recs[*count], &n);
+                if (err == ERR_OK)
+                {
+                    (*count)++;
+                    *nbytes += n;
+                }
+            }
+
+            /* Hand out the good records; a corrupt one surfaces next call. */
+            if (*count > 0)
+            {
+                err = ERR_OK;
+            }
+        }
+    }
+
+    return err;
+}
+
+/**
+ * @brief Releases the records returned by rrecord_peek_batch.
+ */
+int rrecord_consume (rbuffer_t * rb, uint16_t nbytes)
+{
+    return rbuffer_consume(rb, nbytes);
+}
+
+/* end of file */
@@ -0,0 +1,431 @@
+/*****************************************************************************
+ *                                                                           *
+ * \file sampler.c                                                           *
+ *                                                                           *
+ * \brief Timer-interrupt-driven sensor sampling into a record rbuffer.      *
+ *                                                                           *
+ * \author blackchacal <ribeiro.tonet@gmail.com>                             *
+ * \date Oct 17, 2026                                                        *
+ *                                                                           *
+ * \version 1.0 | \author blackchacal                                        *
+ * File creation.                                                            *
+ *                                                                           *
+ *****************************************************************************/
+
+/*****************************************************************************
+ * Includes                                                                  *
+ *****************************************************************************/
+
+/* --- Standard libraries -------------------- */
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+/* --- Arduino libraries -------------------- */
+#include <Arduino.h>
+
+/* --- Custom modules -------------------- */
+#include "sampler.h"
+#include "rbuffer.h"
+#include "rrecord.h"
+
+/*****************************************************************************
+ * Macros                                                                    *
+ *****************************************************************************/
+
+#define SAMPLER_RATE_MAX    10000UL
+
+/*****************************************************************************
+ * Static Variables                                                          *
+ *****************************************************************************/
+
+static rbuffer_t * sampler_rb = NULL;
+static sampler_read_t sampler_read = NULL;
+static bool sampler_running = false;
+
+/* Written by the ISR. */
+static volatile uint16_t sampler_seq = 0;
+static volatile uint32_t sampler_ticks = 0;
+static volatile uint32_t sampler_pushed = 0;
+static volatile uint32_t sampler_failed = 0;
+
+/* Main context only. */
+static sampler_sample_t sampler_batch[SAMPLER_BATCH];
+static uint32_t sampler_consumed = 0;
+static uint32_t sampler_lost = 0;
+static uint32_t sampler_resyncs = 0;
+static uint16_t sampler_next_seq = 0;
+static bool sampler_synced = false;
+
+/*****************************************************************************
+ * Private Functions                                                         *
+ *****************************************************************************/
+
+static uint16_t sampler_encode (uint8_t * rec, uint32_t ts, uint16_t seq, uint8_t src,
+                                const int32_t * values, uint8_t count)
+{
+    memcpy(rec, &ts, 4);
+    memcpy(rec + 4, &seq, 2);
+    rec[6] = src;
+    rec[7] = count;
+    memcpy(rec + SAMPLER_REC_HDR_SIZE, values, 4U * count);
+
+    return (uint16_t)(SAMPLER_REC_HDR_SIZE + 4U * count);
+}
+
+/**
+ * @brief Timer tick: reads the sensor and pushes one record.
+ */
+static void sampler_isr (void)
+{
+    uint8_t rec[SAMPLER_REC_MAX_SIZE];
+    int32_t values[SAMPLER_MAX_VALUES];
+    uint32_t ts = micros();
+    uint16_t seq = sampler_seq;
+    uint16_t len = 0;
+    uint8_t count = 0;
+
+    sampler_seq = (uint16_t)(seq + 1);
+    sampler_ticks++;
+
+    count = sampler_read(values, SAMPLER_MAX_VALUES);
+    if ((count == 0) || (count > SAMPLER_MAX_VALUES))
+    {
+        sampler_failed++;
+        return;
+    }
+
+    len = sampler_encode(rec, ts, seq, SAMPLER_SRC_TIMER, values, count);
+    if (rrecord_push(sampler_rb, rec, len) == ERR_OK)
+    {
+        sampler_pushed++;
+    }
+    else
+    {
+        sampler_failed++;
+    }
+}
+
+/**
+ * @brief Decodes one record, false if it is not a sample record.
+ */
+static bool sampler_decode (const rrecord_t * rec, sampler_sample_t * sample)
+{
+    uint8_t count = 0;
+
+    if (rec->len < SAMPLER_REC_HDR_SIZE)
+    {
+        return false;
+    }
+
+    count = rec->data[7];
+    if ((count == 0) || (count > SAMPLER_MAX_VALUES) ||
+        (rec->len != SAMPLER_REC_HDR_SIZE + 4U * count))
+    {
+        return false;
+    }
+
+    memcpy(&sample->ts_us, rec->data, 4);
+    memcpy(&sample->seq, rec->data + 4, 2);
+    sample->src = rec->data[6];
+    sample->count = count;
+    memcpy(sample->value, rec->data + SAMPLER_REC_HDR_SIZE, 4U * count);
+
+    return true;
+}
+
+#if defined(ARDUINO_ARCH_SAMD)
+
+static void sampler_tc_sync (void)
+{
+    while (TC3->COUNT16.STATUS.bit.SYNCBUSY)
+    {
+    }
+}
+
+/**
+ * @brief Runs TC3 from GCLK0 in match-frequency mode, with the smallest
+ * prescaler that fits the period in 16 bits.
+ */
+static int sampler_timer_start (uint32_t rate_hz)
+{
+    static const uint16_t prescaler[] = {1, 2, 4, 8, 16, 64, 256, 1024};
+    uint32_t top = 0;
+    uint8_t i = 0;
+
+    for (i = 0; i < sizeof(prescaler) / sizeof(prescaler[0]); i++)
+    {
+        top = SystemCoreClock / prescaler[i] / rate_hz;
+        if (top <= 0x10000UL)
+        {
+            break;
+        }
+    }
+    if ((i == sizeof(prescaler) / sizeof(prescaler[0])) || (top < 2))
+    {
+        return ERR_SAMPLER_INVALID_RATE;
+    }
+
+    GCLK->CLKCTRL.reg = (uint16_t)(GCLK_CLKCTRL_CLKEN | GCLK_CLKCTRL_GEN_GCLK0 |
+                                   GCLK_CLKCTRL_ID_TCC2_TC3);
+    while (GCLK->STATUS.bit.SYNCBUSY)
+    {
+    }
+
+    TC3->COUNT16.CTRLA.reg = TC_CTRLA_SWRST;
+    while (TC3->COUNT16.CTRLA.bit.SWRST)
+    {
+    }
+
+    TC3->COUNT16.CTRLA.reg = (uint16_t)(TC_CTRLA_MODE_COUNT16 | TC_CTRLA_WAVEGEN_MFRQ |
+                                        TC_CTRLA_PRESCALER(i));
+    sampler_tc_sync();
+    TC3->COUNT16.CC[0].reg = (uint16_t)(top - 1);
+    sampler_tc_sync();
+    TC3->COUNT16.INTFLAG.reg = TC_INTFLAG_MC0;
+    TC3->COUNT16.INTENSET.reg = TC_INTENSET_MC0;
+
+    /* Below USB, so the serial port keeps working under a fast sampler. */
+    NVIC_ClearPendingIRQ(TC3_IRQn);
+    NVIC_SetPriority(TC3_IRQn, 1);
+    NVIC_EnableIRQ(TC3_IRQn);
+
+    TC3->COUNT16.CTRLA.reg |= TC_CTRLA_ENABLE;
+    sampler_tc_sync();
+
+    return ERR_OK;
+}
+
+static void sampler_timer_stop (void)
+{
+    TC3->COUNT16.CTRLA.reg &= (uint16_t)~TC_CTRLA_ENABLE;
+    sampler_tc_sync();
+    NVIC_DisableIRQ(TC3_IRQn);
+}
+
+#elif defined(SURICATA_NATIVE)
+
+static int sampler_timer_start (uint32_t rate_hz)
+{
+    return native_timer_start(1000000UL / rate_hz, sampler_isr) ? ERR_OK : ERR_SAMPLER_TIMER;
+}
+
+static void sampler_timer_stop (void)
+{
+    native_timer_stop();
+}
+
+#else
+
+static int sampler_timer_start (uint32_t rate_hz)
+{
+    (void)rate_hz;
+    (void)sampler_isr;
+    return ERR_SAMPLER_TIMER;
+}
+
+static void sampler_timer_stop (void)
+{
+}
+
+#endif
+
+/*****************************************************************************
+ * Public Functions                                                          *
+ *****************************************************************************/
+
+#if defined(ARDUINO_ARCH_SAMD)
+void TC3_Handler (void)
+{
+    TC3->COUNT16.INTFLAG.reg = TC_INTFLAG_MC0;
+    sampler_isr();
+}
+#endif
+
+int sampler_init (rbuffer_t * rb, sampler_read_t read)
+{
+    if ((rb == NULL) || (read == NULL))
+    {
+        return ERR_SAMPLER_NULL_POINTER;
+    }
+
+    sampler_stop();
+    sampler_rb = rb;
+    sampler_read = read;
+    sampler_seq = 0;
+    sampler_ticks = 0;
+    sampler_pushed = 0;
+    sampler_failed = 0;
+    sampler_consumed = 0;
+    sampler_lost = 0;
+    sampler_resyncs = 0;
+    sampler_synced = false;
+
+    return ERR_OK;
+}
+
+int sampler_start (uint32_t rate_hz)
+{
+    int err = ERR_OK;
+
+    if (sampler_rb == NULL)
+    {
+        return ERR_SAMPLER_NOT_INIT;
+    }
+    if ((rate_hz == 0) || (rate_hz > SAMPLER_RATE_MAX))
+    {
+        return ERR_SAMPLER_INVALID_RATE;
+    }
+
+    sampler_stop();
+    err = sampler_timer_start(rate_hz);
+    sampler_running = (err == ERR_OK);
+
+    return err;
+}
+
+void sampler_stop (void)
+{
+    /* TC3 registers stall on sync until its clock is set up, by start. */
+    if (sampler_running)
+    {
+        sampler_timer_stop();
+        sampler_running = false;
+    }
+}
+
+int sampler_push (uint8_t src, const int32_t * values, uint8_t count)
+{
+    uint8_t rec[SAMPLER_REC_MAX_SIZE];
+    uint32_t ts = micros();
+    uint16_t len = 0;
+    int err = ERR_OK;
+
+    if (sampler_rb == NULL)
+    {
+        return ERR_SAMPLER_NOT_INIT;
+    }
+    if (values == NULL)
+    {
+        return ERR_SAMPLER_NULL_POINTER;
+    }
+    if ((count == 0) || (count > SAMPLER_MAX_VALUES))
+    {
+        return ERR_SAMPLER_INVALID_COUNT;
+    }
+
+    noInterrupts();
+    len = sampler_encode(rec, ts, sampler_seq, src, values, count);
+    sampler_seq = (uint16_t)(sampler_seq + 1);
+    err = rrecord_push(sampler_rb, rec, len);
+    if (err == ERR_OK)
+    {
+        sampler_pushed++;
+    }
+    else
+    {
+        sampler_failed++;
+    }
+    interrupts();
+
+    return err;
+}
+
+uint16_t sampler_consume (sampler_batch_t fn, uint16_t max)
+{
+    rrecord_t recs[SAMPLER_BATCH];
+    uint16_t done = 0;
+
+    if ((sampler_rb == NULL) || (fn == NULL))
+    {
+        return 0;
+    }
+
+    while (done < max)
+    {
+        uint16_t want = ((max - done) < SAMPLER_BATCH) ? (uint16_t)(max - done) : SAMPLER_BATCH;
+        uint16_t count = 0;
+        uint16_t nbytes = 0;
+        uint16_t n = 0;
+        uint32_t overruns = rbuffer_overruns(sampler_rb);
+        int err = rrecord_peek_batch(sampler_rb, recs, want, &count, &nbytes);
+
+        if ((err == ERR_RRECORD_CORRUPT) && (rbuffer_overruns(sampler_rb) != overruns))
+        {
+            /* The ISR overwrote the record being parsed, not a framing error. */
+            continue;
+        }
+        if (err == ERR_RRECORD_CORRUPT)
+        {
+            /* Framing is lost, restart from an empty rbuffer. */
+            rbuffer_span_t span[RBUFFER_MAX_SPANS];
+
+            if (rbuffer_peek(sampler_rb, span) == ERR_OK)
+            {
+                rbuffer_consume(sampler_rb, span[0].len + span[1].len);
+            }
+            sampler_resyncs++;
+            break;
+        }
+        if (err != ERR_OK)
+        {
+            break;
+        }
+
+        for (uint16_t i = 0; i < count; i++)
+        {
+            if (sampler_decode(&recs[i], &sampler_batch[n]))
+            {
+                n++;
+            }
+        }
+
+        /* The copies are only trusted if the ISR did not overwrite them. */
+        err = rrecord_consume(sampler_rb, nbytes);
+        if (err == ERR_RBUFFER_OVERRUN)
+        {
+            continue;
+        }
+        if (err != ERR_OK)
+        {
+            break;
+        }
+
+        for (uint16_t i = 0; i < n; i++)
+        {
+            if (sampler_synced && (sampler_batch[i].seq != sampler_next_seq))
+            {
+                sampler_lost += (uint16_t)(sampler_batch[i].seq - sampler_next_seq);
+            }
+            sampler_next_seq = (uint16_t)(sampler_batch[i].seq + 1);
+            sampler_synced = true;
+        }
+
+        if (n > 0)
+        {
+            fn(sampler_batch, n);
+            sampler_consumed += n;
+        }
+        done = (uint16_t)(done + count);
+    }
+
+    return done;
+}
+
+void sampler_stats (sampler_stats_t * stats)
+{
+    if (stats == NULL)
+    {
+        return;
+    }
+
+    stats->ticks = sampler_ticks;
+    stats->pushed = sampler_pushed;
+    stats->failed = sampler_failed;
+    stats->consumed = sampler_consumed;
+    stats->lost = sampler_lost;
+    stats->resyncs = sampler_resyncs;
+}
+
+/* end of file */
@@ -0,0 +1,330 @@
+/*****************************************************************************
+ *                                                                           *
+ * \file sched.c                                                             *
+ *                                                                           *
+ * \brief Cooperative deadline scheduler driven from loop().                 *
+ *                                                                           *
+ * \author blackchacal <ribeiro.tonet@gmail.com>                             *
+ * \date Oct 17, 2026                                                        *
+ *                                                                           *
+ * \version 1.0 | \author blackchacal                                        *
+ * File creation.                                                            *
+ *                                                                           *
+ *****************************************************************************/
+
+/*****************************************************************************
+ * Includes                                                                  *
+ *****************************************************************************/
+
+/* --- Standard libraries -------------------- */
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+/* --- Arduino libraries -------------------- */
+#include <Arduino.h>
+
+/* --- Custom modules -------------------- */
+#include "sched.h"
+#include "logger.h"
+
+/*****************************************************************************
+ * Macros                                                                    *
+ *****************************************************************************/
+
+#define SCHED_NONE          (0xFF)
+
+/* Deadline order that survives the micros() wrap around. */
+#define SCHED_BEFORE(a, b)  ((int32_t)((uint32_t)(a) - (uint32_t)(b)) < 0)
+
+/*****************************************************************************
+ * Datatypes                                                                 *
+ *****************************************************************************/
+
+typedef struct
+{
+    const char * name;
+    sched_fn_t fn;
+    void * arg;
+    uint32_t period;
+    uint32_t deadline;
+    uint8_t pos;                /* Index in sched_heap, SCHED_NONE if unused. */
+    sched_stats_t stats;
+} sched_task_t;
+
+/*****************************************************************************
+ * Static Variables                                                          *
+ *****************************************************************************/
+
+static sched_task_t sched_tasks[SCHED_MAX_TASKS];
+static uint8_t sched_heap[SCHED_MAX_TASKS];
+static uint8_t sched_len = 0;
+
+/* Task being run. Its slot is not handed out again until its stats are
+ * written, even if it was a one-shot or cancelled itself. */
+static uint8_t sched_running = SCHED_NONE;
+
+/*****************************************************************************
+ * Private Functions                                                         *
+ *****************************************************************************/
+
+static bool sched_less (uint8_t i, uint8_t j)
+{
+    return SCHED_BEFORE(sched_tasks[sched_heap[i]].deadline, sched_tasks[sched_heap[j]].deadline);
+}
+
+static void sched_swap (uint8_t i, uint8_t j)
+{
+    uint8_t id = sched_heap[i];
+
+    sched_heap[i] = sched_heap[j];
+    sched_heap[j] = id;
+    sched_tasks[sched_heap[i]].pos = i;
+    sched_tasks[sched_heap[j]].pos = j;
+}
+
+static void sched_up (uint8_t i)
+{
+    while ((i > 0) && sched_less(i, (uint8_t)((i - 1) / 2)))
+    {
+        sched_swap(i, (uint8_t)((i - 1) / 2));
+        i = (uint8_t)((i - 1) / 2);
+    }
+}
+
+static void sched_down (uint8_t i)
+{
+    for (;;)
+    {
+        uint8_t l = (uint8_t)(2 * i + 1);
+        uint8_t r = (uint8_t)(2 * i + 2);
+        uint8_t m = i;
+
+        if ((l < sched_len) && sched_less(l, m))
+        {
+            m = l;
+        }
+        if ((r < sched_len) && sched_less(r, m))
+        {
+            m = r;
+        }
+        if (m == i)
+        {
+            break;
+        }
+        sched_swap(i, m);
+        i = m;
+    }
+}
+
+static void sched_push (uint8_t id)
+{
+    sched_heap[sched_len] = id;
+    sched_tasks[id].pos = sched_len;
+    sched_len++;
+    sched_up(sched_tasks[id].pos);
+}
+
+static void sched_remove (uint8_t id)
+{
+    uint8_t pos = sched_tasks[id].pos;
+
+    sched_len--;
+    if (pos != sched_len)
+    {
+        sched_heap[pos] = sched_heap[sched_len];
+        sched_tasks[sched_heap[pos]].pos = pos;
+        sched_up(pos);
+        sched_down(sched_tasks[sched_heap[pos]].pos);
+    }
+    sched_tasks[id].pos = SCHED_NONE;
+}
+
+/*****************************************************************************
+ * Public Functions                                                          *
+ *****************************************************************************/
+
+void sched_init (void)
+{
+    memset(sched_tasks, 0, sizeof(sched_tasks));
+    for (uint8_t i = 0; i < SCHED_MAX_TASKS; i++)
+    {
+        sched_tasks[i].pos = SCHED_NONE;
+    }
+    sched_len = 0;
+}
+
+int sched_add (const char * name, sched_fn_t fn, void * arg, uint32_t period_us,
+               uint32_t delay_us, uint8_t * id)
+{
+    int err = ERR_SCHED_FULL;
+
+    if (fn == NULL)
+    {
+        return ERR_SCHED_NULL_POINTER;
+    }
+
+    for (uint8_t i = 0; i < SCHED_MAX_TASKS; i++)
+    {
+        sched_task_t * task = &sched_tasks[i];
+
+        if ((task->pos == SCHED_NONE) && (i != sched_running))
+        {
+            memset(task, 0, sizeof(*task));
+            task->name = (name != NULL) ? name : "?";
+            task->fn = fn;
+            task->arg = arg;
+            task->period = period_us;
+            task->deadline = micros() + delay_us;
+            sched_push(i);
+            if (id != NULL)
+            {
+                *id = i;
+            }
+            err = ERR_OK;
+            break;
+        }
+    }
+
+    return err;
+}
+
+int sched_cancel (uint8_t id)
+{
+    if ((id >= SCHED_MAX_TASKS) || (sched_tasks[id].pos == SCHED_NONE))
+    {
+        return ERR_SCHED_INVALID_TASK;
+    }
+
+    sched_remove(id);
+
+    return ERR_OK;
+}
+
+int sched_set_period (uint8_t id, uint32_t period_us)
+{
+    if ((id >= SCHED_MAX_TASKS) || (sched_tasks[id].pos == SCHED_NONE))
+    {
+        return ERR_SCHED_INVALID_TASK;
+    }
+
+    sched_tasks[id].period = period_us;
+
+    return ERR_OK;
+}
+
+uint8_t sched_run (void)
+{
+    uint8_t ran = 0;
+
+    /* Bounded, so a task that is always late cannot starve loop(). */
+    while ((sched_len > 0) && (ran < SCHED_MAX_TASKS))
+    {
+        uint8_t id = sched_heap[0];
+        sched_task_t * task = &sched_tasks[id];
+        uint32_t now = micros();
+        uint32_t late;
+        uint32_t elapsed;
+
+        if (SCHED_BEFORE(now, task->deadline))
+        {
+            break;
+        }
+
+        late = now - task->deadline;
+
+        /* Reschedule before running, so the task may cancel or re-add. */
+        if (task->period == 0)
+        {
+            sched_remove(id);
+        }
+        else
+        {
+            uint32_t missed = late / task->period;
+
+            task->stats.overruns += missed;
+            task->deadline += (missed + 1) * task->period;
+            sched_down(0);
+        }
+
+        sched_running = id;
+        task->fn(task->arg);
+        elapsed = micros() - now;
+
+        task->stats.runs++;
+        task->stats.run_last = elapsed;
+        task->stats.run_total += elapsed;
+        if (elapsed > task->stats.run_max)
+        {
+            task->stats.run_max = elapsed;
+        }
+        if (late > task->stats.late_max)
+        {
+            task->stats.late_max = late;
+        }
+        sched_running = SCHED_NONE;
+        ran++;
+    }
+
+    return ran;
+}
+
+uint32_t sched_idle_us (void)
+{
+    uint32_t now = micros();
+    uint32_t deadline;
+
+    if (sched_len == 0)
+    {
+        return UINT32_MAX;
+    }
+
+    deadline = sched_tasks[sched_heap[0]].deadline;
+
+    return SCHED_BEFORE(now, deadline) ? (deadline - now) : 0;
+}
+
+int sched_stats (uint8_t id, sched_stats_t * stats)
+{
+    if (stats == NULL)
+    {
+        return ERR_SCHED_NULL_POINTER;
+    }
+    if (id >= SCHED_MAX_TASKS)
+    {
+        return ERR_SCHED_INVALID_TASK;
+    }
+
+    *stats = sched_tasks[id].stats;
+
+    return ERR_OK;
+}
+
+void sched_report (void)
+{
+    for (uint8_t i = 0; i < SCHED_MAX_TASKS; i++)
+    {
+        sched_task_t * task = &sched_tasks[i];
+
+        if (task->pos == SCHED_NONE)
+        {
+            continue;
+        }
+
+        /* The average is worked out in the arguments, so nothing is left
+         * unused when LOG_INFO compiles to nothing. */
+        LOG_INFO("SCHED", "%s: runs %lu avg %lu us max %lu us late %lu us overruns %lu",
+                 task->name,
+                 (unsigned long)task->stats.runs,
+                 (unsigned long)((task->stats.runs > 0) ?
+                                 (task->stats.run_total / task->stats.runs) : 0),
+                 (unsigned long)task->stats.run_max,
+                 (unsigned long)task->stats.late_max,
+                 (unsigned long)task->stats.overruns);
+        task->stats.run_max = 0;
+        task->stats.late_max = 0;
+    }
+}
+
+/* end of file */
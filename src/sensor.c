@@ -0,0 +1,174 @@
+/*****************************************************************************
+ *                                                                           *
+ * \file sensor.c                                                            *
+ *                                                                           *
+ * \brief Asynchronous sensor drivers as state machines.                     *
+ *                                                                           *
+ * \author blackchacal <ribeiro.tonet@gmail.com>                             *
+ * \date Oct 17, 2026                                                        *
+ *                                                                           *
+ * \version 1.0 | \author blackchacal                                        *
+ * File creation.                                                            *
+ *                                                                           *
+ *****************************************************************************/
+
+/*****************************************************************************
+ * Includes                                                                  *
+ *****************************************************************************/
+
+/* --- Standard libraries -------------------- */
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+/* --- Arduino libraries -------------------- */
+#include <Arduino.h>
+
+/* --- Custom modules -------------------- */
+#include "sensor.h"
+#include "i2c_bus.h"
+#include "sampler.h"
+#include "logger.h"
+#include "prof.h"
+
+/*****************************************************************************
+ * Macros                                                                    *
+ *****************************************************************************/
+
+#define SENSOR_DUE(now, t)  ((int32_t)((uint32_t)(now) - (uint32_t)(t)) >= 0)
+
+/*****************************************************************************
+ * Static Variables                                                          *
+ *****************************************************************************/
+
+static sensor_t * sensor_list = NULL;
+
+/*****************************************************************************
+ * Public Functions                                                          *
+ *****************************************************************************/
+
+int sensor_add (sensor_t * sensor, const sensor_driver_t * drv, uint8_t addr, uint8_t src,
+                uint32_t period_us)
+{
+    if ((sensor == NULL) || (drv == NULL) || (drv->step == NULL))
+    {
+        return ERR_SENSOR_NULL_POINTER;
+    }
+
+    memset(sensor, 0, sizeof(*sensor));
+    sensor->drv = drv;
+    sensor->addr = addr;
+    sensor->src = src;
+    sensor->period_us = period_us;
+    sensor->wake = micros();
+    sensor->start = sensor->wake;
+    sensor->next = sensor_list;
+    sensor_list = sensor;
+
+    return ERR_OK;
+}
+
+void sensor_poll (void)
+{
+    i2c_bus_poll();
+
+    for (sensor_t * sensor = sensor_list; sensor != NULL; sensor = sensor->next)
+    {
+        if (sensor->waiting)
+        {
+            if (sensor->xfer.result == I2C_XFER_PENDING)
+            {
+                continue;
+            }
+            sensor->waiting = false;
+        }
+        else if (!SENSOR_DUE(micros(), sensor->wake))
+        {
+            continue;
+        }
+
+        PROF_BEGIN(sensor_step);
+        sensor->drv->step(sensor);
+        PROF_END(sensor_step);
+    }
+}
+
+void sensor_report (void)
+{
+    for (sensor_t * sensor = sensor_list; sensor != NULL; sensor = sensor->next)
+    {
+        LOG_INFO("SENSOR", "%s@0x%02x: reads %lu errors %lu (last %d) value %ld %ld",
+                 sensor->drv->name, sensor->addr,
+                 (unsigned long)sensor->reads, (unsigned long)sensor->errors, sensor->last_err,
+                 (long)sensor->value[0], (long)sensor->value[1]);
+    }
+}
+
+/* --- For drivers ----------------------------------------------------------*/
+
+int sensor_xfer (sensor_t * sensor, uint8_t tx_len, uint8_t rx_len)
+{
+    int err = ERR_OK;
+
+    if ((tx_len > SENSOR_BUF_SIZE) || (rx_len > SENSOR_BUF_SIZE))
+    {
+        return ERR_SENSOR_INVALID_SIZE;
+    }
+
+    sensor->xfer.addr = sensor->addr;
+    sensor->xfer.tx = sensor->tx;
+    sensor->xfer.tx_len = tx_len;
+    sensor->xfer.rx = sensor->rx;
+    sensor->xfer.rx_len = rx_len;
+
+    err = i2c_submit(&sensor->xfer);
+    if (err == ERR_OK)
+    {
+        sensor->waiting = true;
+    }
+
+    return err;
+}
+
+void sensor_sleep (sensor_t * sensor, uint32_t us)
+{
+    sensor->waiting = false;
+    sensor->wake = micros() + us;
+}
+
+void sensor_sleep_period (sensor_t * sensor)
+{
+    uint32_t now = micros();
+
+    /* From the previous start, so readings keep their cadence. */
+    sensor->start += sensor->period_us;
+    if (SENSOR_DUE(now, sensor->start))
+    {
+        sensor->start = now;
+    }
+    sensor->waiting = false;
+    sensor->wake = sensor->start;
+}
+
+int sensor_publish (sensor_t * sensor, const int32_t * values, uint8_t count)
+{
+    if (count > SAMPLER_MAX_VALUES)
+    {
+        count = SAMPLER_MAX_VALUES;
+    }
+
+    memcpy(sensor->value, values, 4U * count);
+    sensor->count = count;
+    sensor->reads++;
+
+    return sampler_push(sensor->src, values, count);
+}
+
+void sensor_fail (sensor_t * sensor, int err)
+{
+    sensor->errors++;
+    sensor->last_err = err;
+}
+
+/* end of file */
@@ -0,0 +1,130 @@
+/*****************************************************************************
+ *                                                                           *
+ * \file sensor_sht3x.c                                                      *
+ *                                                                           *
+ * \brief Sensirion SHT3x temperature and humidity driver.                   *
+ *                                                                           *
+ * \author blackchacal <ribeiro.tonet@gmail.com>                             *
+ * \date Oct 17, 2026                                                        *
+ *                                                                           *
+ * \version 1.0 | \author blackchacal                                        *
+ * File creation.                                                            *
+ *                                                                           *
+ *****************************************************************************/
+
+/*****************************************************************************
+ * Includes                                                                  *
+ *****************************************************************************/
+
+/* --- Standard libraries -------------------- */
+#include <stdint.h>
+#include <stdbool.h>
+
+/* --- Custom modules -------------------- */
+#include "sensor.h"
+#include "sensor_sht3x.h"
+
+/*****************************************************************************
+ * Datatypes                                                                 *
+ *****************************************************************************/
+
+typedef enum
+{
+    SHT3X_STATE_START,          /* Send the measure command. */
+    SHT3X_STATE_SENT,           /* Command done, conversion running. */
+    SHT3X_STATE_READ,           /* Conversion over, read the result. */
+    SHT3X_STATE_DONE,           /* Result read, check and publish it. */
+} sht3x_state_t;
+
+/*****************************************************************************
+ * Private Functions                                                         *
+ *****************************************************************************/
+
+/**
+ * @brief CRC-8, polynomial 0x31, init 0xFF, over one 16 bit word.
+ */
+static uint8_t sht3x_crc (const uint8_t * data)
+{
+    uint8_t crc = 0xFF;
+
+    for (uint8_t i = 0; i < 2; i++)
+    {
+        crc ^= data[i];
+        for (uint8_t bit = 0; bit < 8; bit++)
+        {
+            crc = (uint8_t)((crc & 0x80) ? ((crc << 1) ^ 0x31) : (crc << 1));
+        }
+    }
+
+    return crc;
+}
+
+static void sht3x_fail (sensor_t * sensor, int err)
+{
+    sensor_fail(sensor, err);
+    sensor->state = SHT3X_STATE_START;
+    sensor_sleep_period(sensor);
+}
+
+static void sht3x_step (sensor_t * sensor)
+{
+    int err = ERR_OK;
+
+    switch (sensor->state)
+    {
+        case SHT3X_STATE_START:
+            sensor->tx[0] = 0x24;
+            sensor->tx[1] = 0x00;
+            err = sensor_xfer(sensor, 2, 0);
+            sensor->state = SHT3X_STATE_SENT;
+            break;
+
+        case SHT3X_STATE_SENT:
+            err = sensor->xfer.result;
+            sensor->state = SHT3X_STATE_READ;
+            sensor_sleep(sensor, SHT3X_CONVERSION_US);
+            break;
+
+        case SHT3X_STATE_READ:
+            err = sensor_xfer(sensor, 0, 6);
+            sensor->state = SHT3X_STATE_DONE;
+            break;
+
+        case SHT3X_STATE_DONE:
+        default:
+            err = sensor->xfer.result;
+            if ((err == ERR_OK) &&
+                ((sht3x_crc(&sensor->rx[0]) != sensor->rx[2]) ||
+                 (sht3x_crc(&sensor->rx[3]) != sensor->rx[5])))
+            {
+                err = ERR_SENSOR_CRC;
+            }
+            if (err == ERR_OK)
+            {
+                uint32_t t_raw = ((uint32_t)sensor->rx[0] << 8) | sensor->rx[1];
+                uint32_t rh_raw = ((uint32_t)sensor->rx[3] << 8) | sensor->rx[4];
+                int32_t values[2];
+
+                /* T = -45 + 175 * raw / 65535, RH = 100 * raw / 65535. */
+                values[0] = (int32_t)((17500UL * t_raw) / 65535UL) - 4500;
+                values[1] = (int32_t)((10000UL * rh_raw) / 65535UL);
+                sensor_publish(sensor, values, 2);
+                sensor->state = SHT3X_STATE_START;
+                sensor_sleep_period(sensor);
+            }
+            break;
+    }
+
+    if (err != ERR_OK)
+    {
+        sht3x_fail(sensor, err);
+    }
+}
+
+/*****************************************************************************
+ * Public Variables                                                          *
+ *****************************************************************************/
+
+const sensor_driver_t sensor_sht3x = {"SHT3x", sht3x_step};
+
+/* end of file */
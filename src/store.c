@@ -0,0 +1,731 @@
+/*****************************************************************************
+ *                                                                           *
+ * \file store.c                                                             *
+ *                                                                           *
+ * \brief Log-structured record store in flash, backing a record rbuffer.    *
+ *                                                                           *
+ * \author blackchacal <ribeiro.tonet@gmail.com>                             *
+ * \date Oct 17, 2026                                                        *
+ *                                                                           *
+ * \version 1.0 | \author blackchacal                                        *
+ * File creation.                                                            *
+ *                                                                           *
+ *****************************************************************************/
+
+/*****************************************************************************
+ * Includes                                                                  *
+ *****************************************************************************/
+
+/* --- Standard libraries -------------------- */
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+/* --- Custom modules -------------------- */
+#include "store.h"
+#include "flash.h"
+#include "rbuffer.h"
+#include "rrecord.h"
+#include "meminfo.h"
+
+/*****************************************************************************
+ * Macros                                                                    *
+ *****************************************************************************/
+
+#define STORE_MAGIC         (0x54535553UL)      /* "SUST" */
+#define STORE_PAD           (0xFFFF)
+
+/* rbuffer fill that starts moving records to flash, and under which they
+ * are moved back. */
+#define STORE_SPILL_FILL(size)  ((uint16_t)((size) / 4 * 3))
+#define STORE_DRAIN_FILL(size)  ((uint16_t)((size) / 4))
+
+#define STORE_PAGE_UP(pos)  ((uint16_t)(((pos) + FLASH_WRITE_SIZE - 1) & ~(FLASH_WRITE_SIZE - 1)))
+
+/*****************************************************************************
+ * Datatypes                                                                 *
+ *****************************************************************************/
+
+typedef struct
+{
+    uint32_t seq;
+    uint32_t erases;
+    bool live;                  /* Holds a valid header, unread records. */
+} store_sector_t;
+
+/*****************************************************************************
+ * Static Variables                                                          *
+ *****************************************************************************/
+
+static rbuffer_t * store_rb = NULL;
+static bool store_ready = false;
+static bool store_spilling = false;
+static store_sector_t store_sectors[STORE_SECTORS];
+static uint32_t store_seq = 0;
+
+/* Appends go to head at wpos; bytes from the start of wpos's page are
+ * still in store_page. wpos == STORE_SECTOR_SIZE closes the sector. */
+static uint16_t store_head = 0;
+static uint16_t store_wpos = 0;
+static uint8_t store_page[FLASH_WRITE_SIZE];
+
+/* Reads come from tail at rpos. */
+static uint16_t store_tail = 0;
+static uint16_t store_rpos = 0;
+
+static uint8_t store_entry[STORE_ENTRY_MAX];
+static store_stats_t store_counters;
+
+/*****************************************************************************
+ * Private Functions                                                         *
+ *****************************************************************************/
+
+/**
+ * @brief CRC-16/CCITT-FALSE, continued from crc (0xFFFF to start).
+ */
+static uint16_t store_crc16 (uint16_t crc, const uint8_t * data, uint16_t len)
+{
+    for (uint16_t i = 0; i < len; i++)
+    {
+        crc ^= (uint16_t)(data[i] << 8);
+        for (uint8_t bit = 0; bit < 8; bit++)
+        {
+            crc = (uint16_t)((crc & 0x8000) ? ((crc << 1) ^ 0x1021) : (crc << 1));
+        }
+    }
+
+    return crc;
+}
+
+static uint16_t store_entry_crc (const uint8_t * hdr, const uint8_t * data, uint16_t len)
+{
+    return store_crc16(store_crc16(0xFFFF, hdr, 2), data, len);
+}
+
+static uint16_t store_get16 (const uint8_t * p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t store_get32 (const uint8_t * p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void store_put16 (uint8_t * p, uint16_t value)
+{
+    p[0] = (uint8_t)value;
+    p[1] = (uint8_t)(value >> 8);
+}
+
+static void store_put32 (uint8_t * p, uint32_t value)
+{
+    store_put16(p, (uint16_t)value);
+    store_put16(&p[2], (uint16_t)(value >> 16));
+}
+
+static uint32_t store_addr (uint16_t sector, uint16_t pos)
+{
+    return (uint32_t)sector * STORE_SECTOR_SIZE + pos;
+}
+
+static void store_fail (void)
+{
+    store_counters.failed++;
+    store_ready = false;
+    store_spilling = false;
+}
+
+/* --- Sectors --------------------------------------------------------------*/
+
+static int store_erase (uint16_t sector)
+{
+    int err = ERR_OK;
+
+    for (uint16_t row = 0; (row < STORE_SECTOR_SIZE) && (err == ERR_OK); row += FLASH_ERASE_SIZE)
+    {
+        err = flash_erase(store_addr(sector, row));
+    }
+    store_sectors[sector].live = false;
+    store_sectors[sector].erases++;
+
+    return err;
+}
+
+static int store_erased (uint16_t sector, bool * erased)
+{
+    uint8_t page[FLASH_WRITE_SIZE];
+    int err = ERR_OK;
+
+    *erased = true;
+    for (uint16_t pos = 0; (pos < STORE_SECTOR_SIZE) && *erased && (err == ERR_OK);
+         pos += FLASH_WRITE_SIZE)
+    {
+        err = flash_read(store_addr(sector, pos), page, FLASH_WRITE_SIZE);
+        for (uint8_t i = 0; i < FLASH_WRITE_SIZE; i++)
+        {
+            *erased = *erased && (page[i] == 0xFF);
+        }
+    }
+
+    return err;
+}
+
+/**
+ * @brief Adds bytes to the head sector, writing each page as it fills.
+ */
+static int store_put (const uint8_t * data, uint16_t len)
+{
+    int err = ERR_OK;
+
+    while ((len > 0) && (err == ERR_OK))
+    {
+        uint16_t off = store_wpos % FLASH_WRITE_SIZE;
+        uint16_t n = (uint16_t)(FLASH_WRITE_SIZE - off);
+
+        if (n > len)
+        {
+            n = len;
+        }
+        memcpy(&store_page[off], data, n);
+        store_wpos = (uint16_t)(store_wpos + n);
+        data += n;
+        len = (uint16_t)(len - n);
+
+        if ((store_wpos % FLASH_WRITE_SIZE) == 0)
+        {
+            err = flash_write(store_addr(store_head, (uint16_t)(store_wpos - FLASH_WRITE_SIZE)), store_page);
+            memset(store_page, 0xFF, sizeof(store_page));
+        }
+    }
+
+    return err;
+}
+
+/**
+ * @brief Ends the head sector, writing its last page padded.
+ */
+static int store_close (void)
+{
+    int err = ERR_OK;
+
+    if ((store_wpos % FLASH_WRITE_SIZE) != 0)
+    {
+        err = flash_write(store_addr(store_head, (uint16_t)(store_wpos - store_wpos % FLASH_WRITE_SIZE)),
+                          store_page);
+        memset(store_page, 0xFF, sizeof(store_page));
+    }
+    store_wpos = STORE_SECTOR_SIZE;
+
+    return err;
+}
+
+/**
+ * @brief Erases the tail sector, now read, and moves to the next one
+ * holding records.
+ */
+static int store_next_tail (void)
+{
+    int err = ERR_OK;
+
+    if (store_sectors[store_tail].live)
+    {
+        err = store_erase(store_tail);
+    }
+    do
+    {
+        store_tail = (uint16_t)((store_tail + 1) % STORE_SECTORS);
+    } while (!store_sectors[store_tail].live && (store_tail != store_head));
+    store_rpos = STORE_HDR_SIZE;
+
+    return err;
+}
+
+/**
+ * @brief Starts a new head sector after the current one, dropping the
+ * oldest sector if the log has come round to it.
+ */
+static int store_open (void)
+{
+    uint16_t next = (uint16_t)((store_head + 1) % STORE_SECTORS);
+    uint8_t hdr[STORE_HDR_SIZE];
+    bool erased = false;
+    int err = ERR_OK;
+
+    if (store_sectors[next].live)
+    {
+        store_counters.dropped++;
+        if (store_tail == next)
+        {
+            err = store_next_tail();
+        }
+        else
+        {
+            err = store_erase(next);
+        }
+    }
+    else
+    {
+        err = store_erased(next, &erased);
+        if ((err == ERR_OK) && !erased)
+        {
+            err = store_erase(next);
+        }
+    }
+    if (err != ERR_OK)
+    {
+        return err;
+    }
+
+    store_seq++;
+    store_put32(&hdr[0], STORE_MAGIC);
+    store_put32(&hdr[4], store_seq);
+    store_put32(&hdr[8], store_sectors[next].erases);
+    store_put16(&hdr[12], store_crc16(0xFFFF, hdr, 12));
+    store_put16(&hdr[14], STORE_PAD);
+
+    store_head = next;
+    store_wpos = 0;
+    store_sectors[next].seq = store_seq;
+    store_sectors[next].live = true;
+
+    /* The header reaches flash with the first full page: a sector cut off
+     * before that reads as erased. */
+    return store_put(hdr, STORE_HDR_SIZE);
+}
+
+/**
+ * @brief Reads from the tail sector, taking the part of the head sector
+ * not yet written from store_page.
+ */
+static int store_fetch (uint16_t pos, uint8_t * data, uint16_t len)
+{
+    uint16_t cached = STORE_SECTOR_SIZE;
+    uint16_t n = len;
+    int err = ERR_OK;
+
+    if (store_tail == store_head)
+    {
+        cached = (uint16_t)(store_wpos - store_wpos % FLASH_WRITE_SIZE);
+    }
+    if (pos < cached)
+    {
+        if (n > cached - pos)
+        {
+            n = (uint16_t)(cached - pos);
+        }
+        err = flash_read(store_addr(store_tail, pos), data, n);
+    }
+    else
+    {
+        n = 0;
+    }
+    if ((err == ERR_OK) && (n < len))
+    {
+        memcpy(&data[n], &store_page[pos + n - cached], len - n);
+    }
+
+    return err;
+}
+
+/**
+ * @brief Finds where appends resume in the head sector after a reset. A
+ * torn entry closes the sector, the ones before it stay readable.
+ */
+static int store_scan_head (void)
+{
+    uint8_t hdr[STORE_ENTRY_HDR_SIZE];
+    uint16_t pos = STORE_HDR_SIZE;
+    uint16_t end = STORE_HDR_SIZE;
+    int err = ERR_OK;
+
+    while ((pos + STORE_ENTRY_HDR_SIZE) <= STORE_SECTOR_SIZE)
+    {
+        uint16_t len = 0;
+
+        err = flash_read(store_addr(store_head, pos), hdr, sizeof(hdr));
+        if (err != ERR_OK)
+        {
+            return err;
+        }
+        len = store_get16(hdr);
+        if (len == STORE_PAD)
+        {
+            pos = STORE_PAGE_UP(pos + 1);
+            continue;
+        }
+        if ((len == 0) || (len > STORE_ENTRY_MAX) ||
+            ((pos + STORE_ENTRY_HDR_SIZE + len) > STORE_SECTOR_SIZE))
+        {
+            store_wpos = STORE_SECTOR_SIZE;
+            return ERR_OK;
+        }
+        err = flash_read(store_addr(store_head, (uint16_t)(pos + STORE_ENTRY_HDR_SIZE)), store_entry, len);
+        if (err != ERR_OK)
+        {
+            return err;
+        }
+        if (store_entry_crc(hdr, store_entry, len) != store_get16(&hdr[2]))
+        {
+            store_wpos = STORE_SECTOR_SIZE;
+            return ERR_OK;
+        }
+        pos = (uint16_t)(pos + STORE_ENTRY_HDR_SIZE + len);
+        end = pos;
+    }
+
+    /* The rest of end's page was padding, or the reset lost it. */
+    store_wpos = STORE_PAGE_UP(end);
+
+    return ERR_OK;
+}
+
+/**
+ * @brief Rebuilds the log state from the sector headers.
+ */
+static int store_mount (void)
+{
+    uint8_t hdr[STORE_HDR_SIZE];
+    uint32_t wear = 0;
+    bool found = false;
+    int err = ERR_OK;
+
+    memset(store_sectors, 0, sizeof(store_sectors));
+    memset(store_page, 0xFF, sizeof(store_page));
+
+    for (uint16_t i = 0; i < STORE_SECTORS; i++)
+    {
+        store_sector_t * sector = &store_sectors[i];
+
+        err = flash_read(store_addr(i, 0), hdr, sizeof(hdr));
+        if (err != ERR_OK)
+        {
+            return err;
+        }
+        if ((store_get32(&hdr[0]) != STORE_MAGIC) ||
+            (store_crc16(0xFFFF, hdr, 12) != store_get16(&hdr[12])))
+        {
+            continue;
+        }
+
+        sector->live = true;
+        sector->seq = store_get32(&hdr[4]);
+        sector->erases = store_get32(&hdr[8]);
+        if (sector->erases > wear)
+        {
+            wear = sector->erases;
+        }
+        if (!found || ((int32_t)(sector->seq - store_sectors[store_head].seq) > 0))
+        {
+            store_head = i;
+        }
+        if (!found || ((int32_t)(sector->seq - store_sectors[store_tail].seq) < 0))
+        {
+            store_tail = i;
+        }
+        found = true;
+    }
+
+    /* The erase count of a free sector went with its header; assume the
+     * worst. */
+    for (uint16_t i = 0; i < STORE_SECTORS; i++)
+    {
+        if (!store_sectors[i].live)
+        {
+            store_sectors[i].erases = wear;
+        }
+    }
+
+    if (!found)
+    {
+        /* Empty: the first append opens sector 0. */
+        store_head = STORE_SECTORS - 1;
+        store_tail = store_head;
+        store_wpos = STORE_SECTOR_SIZE;
+        store_rpos = STORE_SECTOR_SIZE;
+        store_seq = 0;
+        return ERR_OK;
+    }
+
+    store_seq = store_sectors[store_head].seq;
+    store_rpos = STORE_HDR_SIZE;
+
+    return store_scan_head();
+}
+
+/* --- rbuffer --------------------------------------------------------------*/
+
+/**
+ * @brief Moves the oldest records of the rbuffer to flash, until it is
+ * empty or the budget is spent.
+ */
+static void store_spill (uint16_t budget)
+{
+    rrecord_t rec;
+    uint16_t count = 0;
+    uint16_t nbytes = 0;
+    int err = ERR_OK;
+
+    while (budget > 0)
+    {
+        err = rrecord_peek_batch(store_rb, &rec, 1, &count, &nbytes);
+        if ((err != ERR_OK) || (count == 0))
+        {
+            store_spilling = false;
+            break;
+        }
+
+        /* A record too large for an entry fits no uplink frame either: it
+         * is let go. */
+        err = store_append(rec.data, rec.len);
+        if ((err != ERR_OK) && (err != ERR_STORE_TOO_LARGE))
+        {
+            break;
+        }
+        if (err == ERR_OK)
+        {
+            store_counters.spilled++;
+        }
+
+        rrecord_consume(store_rb, nbytes);
+        budget = (nbytes < budget) ? (uint16_t)(budget - nbytes) : 0;
+    }
+}
+
+/**
+ * @brief Moves records from flash back to the rbuffer, until it is 1/4
+ * full or the budget is spent.
+ */
+static void store_drain (uint16_t budget)
+{
+    uint16_t len = 0;
+
+    while ((budget > 0) && store_pending() &&
+           (rbuffer_used(store_rb) < STORE_DRAIN_FILL(store_rb->size)))
+    {
+        if (store_read(store_entry, sizeof(store_entry), &len) != ERR_OK)
+        {
+            break;
+        }
+        rrecord_push(store_rb, store_entry, len);
+        store_counters.drained++;
+        budget = (len < budget) ? (uint16_t)(budget - len) : 0;
+    }
+}
+
+/*****************************************************************************
+ * Public Functions                                                          *
+ *****************************************************************************/
+
+int store_init (rbuffer_t * rb)
+{
+    int err = ERR_OK;
+
+    if (rb == NULL)
+    {
+        return ERR_STORE_NULL_POINTER;
+    }
+
+    store_rb = rb;
+    store_spilling = false;
+    memset(&store_counters, 0, sizeof(store_counters));
+    MEMINFO_REGISTER(store_page);
+    MEMINFO_REGISTER(store_entry);
+
+    err = flash_init();
+    if (err == ERR_OK)
+    {
+        err = store_mount();
+    }
+    store_ready = (err == ERR_OK);
+
+    return err;
+}
+
+int store_push (const uint8_t * data, uint16_t len)
+{
+    if (store_rb == NULL)
+    {
+        return ERR_STORE_NOT_INIT;
+    }
+
+    /* Behind a backlog in flash, so that records leave in order. During a
+     * spill the backlog is still partly in the rbuffer: queue there. */
+    if (store_ready && !store_spilling && store_pending() &&
+        (store_append(data, len) == ERR_OK))
+    {
+        store_counters.spilled++;
+        return ERR_OK;
+    }
+
+    return rrecord_push(store_rb, data, len);
+}
+
+void store_poll (void)
+{
+    if (!store_ready)
+    {
+        return;
+    }
+
+    if (rbuffer_used(store_rb) >= STORE_SPILL_FILL(store_rb->size))
+    {
+        store_spilling = true;
+    }
+
+    if (store_spilling)
+    {
+        store_spill(STORE_BURST);
+    }
+    else
+    {
+        store_drain(STORE_BURST);
+    }
+}
+
+int store_append (const uint8_t * data, uint16_t len)
+{
+    uint8_t hdr[STORE_ENTRY_HDR_SIZE];
+    int err = ERR_OK;
+
+    if (data == NULL)
+    {
+        return ERR_STORE_NULL_POINTER;
+    }
+    if (!store_ready)
+    {
+        return ERR_STORE_NOT_INIT;
+    }
+    if ((len == 0) || (len > STORE_ENTRY_MAX))
+    {
+        return ERR_STORE_TOO_LARGE;
+    }
+
+    if ((store_wpos + STORE_ENTRY_HDR_SIZE + len) > STORE_SECTOR_SIZE)
+    {
+        err = store_close();
+        if (err == ERR_OK)
+        {
+            err = store_open();
+        }
+    }
+
+    if (err == ERR_OK)
+    {
+        store_put16(&hdr[0], len);
+        store_put16(&hdr[2], store_entry_crc(hdr, data, len));
+        err = store_put(hdr, sizeof(hdr));
+    }
+    if (err == ERR_OK)
+    {
+        err = store_put(data, len);
+    }
+    if (err != ERR_OK)
+    {
+        store_fail();
+    }
+
+    return err;
+}
+
+int store_read (uint8_t * data, uint16_t max_len, uint16_t * len)
+{
+    uint8_t hdr[STORE_ENTRY_HDR_SIZE];
+    int err = ERR_OK;
+
+    if ((data == NULL) || (len == NULL))
+    {
+        return ERR_STORE_NULL_POINTER;
+    }
+    if (!store_ready)
+    {
+        return ERR_STORE_NOT_INIT;
+    }
+
+    while (err == ERR_OK)
+    {
+        uint16_t end = (store_tail == store_head) ? store_wpos : STORE_SECTOR_SIZE;
+        uint16_t n = 0;
+
+        if ((store_rpos + STORE_ENTRY_HDR_SIZE) > end)
+        {
+            if (store_tail == store_head)
+            {
+                return ERR_STORE_EMPTY;
+            }
+            err = store_next_tail();
+            continue;
+        }
+
+        err = store_fetch(store_rpos, hdr, sizeof(hdr));
+        if (err != ERR_OK)
+        {
+            break;
+        }
+        n = store_get16(hdr);
+        if (n == STORE_PAD)
+        {
+            store_rpos = STORE_PAGE_UP(store_rpos + 1);
+            continue;
+        }
+        if ((n == 0) || (n > STORE_ENTRY_MAX) || ((store_rpos + STORE_ENTRY_HDR_SIZE + n) > end))
+        {
+            store_counters.corrupt++;
+            store_rpos = end;
+            continue;
+        }
+        if (n > max_len)
+        {
+            return ERR_STORE_TOO_LARGE;
+        }
+
+        err = store_fetch((uint16_t)(store_rpos + STORE_ENTRY_HDR_SIZE), data, n);
+        if (err != ERR_OK)
+        {
+            break;
+        }
+        if (store_entry_crc(hdr, data, n) != store_get16(&hdr[2]))
+        {
+            store_counters.corrupt++;
+            store_rpos = end;
+            continue;
+        }
+
+        store_rpos = (uint16_t)(store_rpos + STORE_ENTRY_HDR_SIZE + n);
+        *len = n;
+        return ERR_OK;
+    }
+
+    store_fail();
+
+    return err;
+}
+
+bool store_pending (void)
+{
+    return (store_tail != store_head) || (store_rpos < store_wpos);
+}
+
+void store_stats (store_stats_t * stats)
+{
+    if (stats == NULL)
+    {
+        return;
+    }
+
+    *stats = store_counters;
+    stats->used = 0;
+    stats->wear_min = UINT32_MAX;
+    stats->wear_max = 0;
+    for (uint16_t i = 0; i < STORE_SECTORS; i++)
+    {
+        const store_sector_t * sector = &store_sectors[i];
+
+        stats->used = (uint16_t)(stats->used + (sector->live ? 1 : 0));
+        stats->wear_min = (sector->erases < stats->wear_min) ? sector->erases : stats->wear_min;
+        stats->wear_max = (sector->erases > stats->wear_max) ? sector->erases : stats->wear_max;
+    }
+}
+
+/* end of file */
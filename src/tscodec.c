@@ -0,0 +1,305 @@
+/*****************************************************************************
+ *                                                                           *
+ * \file tscodec.c                                                           *
+ *                                                                           *
+ * \brief Delta / zig-zag varint compression of sample streams.              *
+ *                                                                           *
+ * \author blackchacal <ribeiro.tonet@gmail.com>                             *
+ * \date Oct 17, 2026                                                        *
+ *                                                                           *
+ * \version 1.0 | \author blackchacal                                        *
+ * File creation.                                                            *
+ *                                                                           *
+ *****************************************************************************/
+
+/*****************************************************************************
+ * Includes                                                                  *
+ *****************************************************************************/
+
+/* --- Standard libraries -------------------- */
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+/* --- Custom modules -------------------- */
+#include "tscodec.h"
+
+/*****************************************************************************
+ * Macros                                                                    *
+ *****************************************************************************/
+
+#define TSC_HEAD_SRC_MASK   (0x07)
+#define TSC_HEAD_CNT_SHIFT  (3)
+#define TSC_HEAD_CNT_MASK   (0x03)
+#define TSC_HEAD_GAP        (0x20)
+
+/*****************************************************************************
+ * Private Functions                                                         *
+ *****************************************************************************/
+
+/* Differences are taken modulo 2^32, so any int32 step round-trips. */
+static uint32_t tsc_zigzag (uint32_t d)
+{
+    return (d << 1) ^ (0U - (d >> 31));
+}
+
+static uint32_t tsc_unzigzag (uint32_t z)
+{
+    return (z >> 1) ^ (0U - (z & 1U));
+}
+
+static uint8_t tsc_put_varint (uint8_t * p, uint32_t value)
+{
+    uint8_t n = 0;
+
+    while (value >= 0x80)
+    {
+        p[n++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    p[n++] = (uint8_t)value;
+
+    return n;
+}
+
+static bool tsc_get_varint (tsc_dec_t * dec, uint32_t * value)
+{
+    uint32_t result = 0;
+
+    for (uint8_t shift = 0; shift < 35; shift = (uint8_t)(shift + 7))
+    {
+        uint8_t b = 0;
+
+        if (dec->pos >= dec->len)
+        {
+            return false;
+        }
+        b = dec->buf[dec->pos++];
+        result |= (uint32_t)(b & 0x7F) << shift;
+        if ((b & 0x80) == 0)
+        {
+            *value = result;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static uint32_t tsc_get32 (const uint8_t * p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void tsc_put32 (uint8_t * p, uint32_t value)
+{
+    p[0] = (uint8_t)value;
+    p[1] = (uint8_t)(value >> 8);
+    p[2] = (uint8_t)(value >> 16);
+    p[3] = (uint8_t)(value >> 24);
+}
+
+/*****************************************************************************
+ * Public Functions                                                          *
+ *****************************************************************************/
+
+int tsc_enc_init (tsc_enc_t * enc, uint8_t * buf, uint16_t size)
+{
+    if ((enc == NULL) || (buf == NULL))
+    {
+        return ERR_TSC_NULL_POINTER;
+    }
+    if (size < TSC_HDR_SIZE + TSC_SAMPLE_MAX)
+    {
+        return ERR_TSC_FULL;
+    }
+
+    enc->buf = buf;
+    enc->size = size;
+    tsc_enc_reset(enc);
+
+    return ERR_OK;
+}
+
+int tsc_enc_add (tsc_enc_t * enc, const sampler_sample_t * sample)
+{
+    uint8_t tmp[TSC_SAMPLE_MAX];
+    tsc_source_t * src = NULL;
+    uint32_t ts_code = 0;
+    int32_t interval = 0;
+    uint16_t gap = 0;
+    uint8_t n = 1;
+
+    if ((enc == NULL) || (sample == NULL))
+    {
+        return ERR_TSC_NULL_POINTER;
+    }
+    if ((sample->src >= TSC_SOURCES) || (sample->count == 0) ||
+        (sample->count > SAMPLER_MAX_VALUES))
+    {
+        return ERR_TSC_INVALID_SAMPLE;
+    }
+
+    if (enc->len == 0)
+    {
+        enc->buf[0] = TSC_BLOCK_TYPE;
+        enc->buf[1] = 0;
+        tsc_put32(&enc->buf[2], sample->ts_us);
+        enc->buf[6] = (uint8_t)sample->seq;
+        enc->buf[7] = (uint8_t)(sample->seq >> 8);
+        enc->len = TSC_HDR_SIZE;
+        enc->next_seq = sample->seq;
+    }
+
+    /* Encode into tmp first, so a sample that does not fit changes nothing. */
+    src = &enc->src[sample->src];
+    gap = (uint16_t)(sample->seq - enc->next_seq);
+    tmp[0] = (uint8_t)(sample->src | ((sample->count - 1) << TSC_HEAD_CNT_SHIFT) |
+                       ((gap != 0) ? TSC_HEAD_GAP : 0));
+    if (gap != 0)
+    {
+        n = (uint8_t)(n + tsc_put_varint(&tmp[n], gap));
+    }
+
+    if (!src->seen)
+    {
+        ts_code = sample->ts_us - tsc_get32(&enc->buf[2]);
+    }
+    else
+    {
+        interval = (int32_t)(sample->ts_us - src->ts);
+        ts_code = (uint32_t)interval - (uint32_t)src->interval;
+    }
+    n = (uint8_t)(n + tsc_put_varint(&tmp[n], tsc_zigzag(ts_code)));
+
+    for (uint8_t i = 0; i < sample->count; i++)
+    {
+        uint32_t d = (uint32_t)sample->value[i] - (uint32_t)src->value[i];
+
+        n = (uint8_t)(n + tsc_put_varint(&tmp[n], tsc_zigzag(d)));
+    }
+
+    /* The count field is one byte. */
+    if (((uint16_t)(enc->len + n) > enc->size) || (enc->buf[1] == 0xFF))
+    {
+        return ERR_TSC_FULL;
+    }
+
+    memcpy(&enc->buf[enc->len], tmp, n);
+    enc->len = (uint16_t)(enc->len + n);
+    enc->buf[1]++;
+    enc->next_seq = (uint16_t)(sample->seq + 1);
+    src->interval = src->seen ? interval : 0;
+    src->seen = true;
+    src->ts = sample->ts_us;
+    memcpy(src->value, sample->value, sizeof(int32_t) * sample->count);
+
+    return ERR_OK;
+}
+
+uint16_t tsc_enc_len (const tsc_enc_t * enc)
+{
+    return (enc->len > TSC_HDR_SIZE) ? enc->len : 0;
+}
+
+void tsc_enc_reset (tsc_enc_t * enc)
+{
+    enc->len = 0;
+    memset(enc->src, 0, sizeof(enc->src));
+}
+
+int tsc_dec_init (tsc_dec_t * dec, const uint8_t * block, uint16_t len)
+{
+    if ((dec == NULL) || (block == NULL))
+    {
+        return ERR_TSC_NULL_POINTER;
+    }
+    if ((len < TSC_HDR_SIZE) || (block[0] != TSC_BLOCK_TYPE))
+    {
+        return ERR_TSC_CORRUPT;
+    }
+
+    memset(dec, 0, sizeof(*dec));
+    dec->buf = block;
+    dec->len = len;
+    dec->pos = TSC_HDR_SIZE;
+    dec->left = block[1];
+    dec->base_ts = tsc_get32(&block[2]);
+    dec->next_seq = (uint16_t)(block[6] | (block[7] << 8));
+
+    return ERR_OK;
+}
+
+int tsc_dec_next (tsc_dec_t * dec, sampler_sample_t * sample)
+{
+    tsc_source_t * src = NULL;
+    uint32_t code = 0;
+    uint8_t head = 0;
+
+    if ((dec == NULL) || (sample == NULL))
+    {
+        return ERR_TSC_NULL_POINTER;
+    }
+    if (dec->left == 0)
+    {
+        return (dec->pos == dec->len) ? ERR_TSC_END : ERR_TSC_CORRUPT;
+    }
+    if (dec->pos >= dec->len)
+    {
+        return ERR_TSC_CORRUPT;
+    }
+
+    head = dec->buf[dec->pos++];
+    sample->src = head & TSC_HEAD_SRC_MASK;
+    sample->count = (uint8_t)(((head >> TSC_HEAD_CNT_SHIFT) & TSC_HEAD_CNT_MASK) + 1);
+    if ((head & 0xC0) || (sample->count > SAMPLER_MAX_VALUES))
+    {
+        return ERR_TSC_CORRUPT;
+    }
+
+    if (head & TSC_HEAD_GAP)
+    {
+        if (!tsc_get_varint(dec, &code))
+        {
+            return ERR_TSC_CORRUPT;
+        }
+        dec->next_seq = (uint16_t)(dec->next_seq + code);
+    }
+    sample->seq = dec->next_seq;
+
+    src = &dec->src[sample->src];
+    if (!tsc_get_varint(dec, &code))
+    {
+        return ERR_TSC_CORRUPT;
+    }
+    if (!src->seen)
+    {
+        sample->ts_us = dec->base_ts + tsc_unzigzag(code);
+        src->interval = 0;
+    }
+    else
+    {
+        src->interval = (int32_t)((uint32_t)src->interval + tsc_unzigzag(code));
+        sample->ts_us = src->ts + (uint32_t)src->interval;
+    }
+
+    for (uint8_t i = 0; i < sample->count; i++)
+    {
+        if (!tsc_get_varint(dec, &code))
+        {
+            return ERR_TSC_CORRUPT;
+        }
+        src->value[i] = (int32_t)((uint32_t)src->value[i] + tsc_unzigzag(code));
+        sample->value[i] = src->value[i];
+    }
+
+    src->seen = true;
+    src->ts = sample->ts_us;
+    dec->next_seq = (uint16_t)(sample->seq + 1);
+    dec->left--;
+
+    return ERR_OK;
+}
+
+/* end of file */
@@ -0,0 +1,434 @@
+/*****************************************************************************
+ *                                                                           *
+ * \file uplink.cpp                                                          *
+ *                                                                           *
+ * \brief Batched UDP uplink of the records in a rbuffer.                    *
+ *                                                                           *
+ * \author blackchacal <ribeiro.tonet@gmail.com>                             *
+ * \date Oct 17, 2026                                                        *
+ *                                                                           *
+ * \version 1.0 | \author blackchacal                                        *
+ * File creation.                                                            *
+ *                                                                           *
+ *****************************************************************************/
+
+/*****************************************************************************
+ * Includes                                                                  *
+ *****************************************************************************/
+
+/* --- Standard libraries -------------------- */
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#if defined(SURICATA_NATIVE)
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#endif
+
+/* --- Arduino libraries -------------------- */
+#include <Arduino.h>
+#if defined(ARDUINO_ARCH_SAMD)
+#include <WiFiNINA.h>
+#include <WiFiUdp.h>
+#include <utility/wifi_drv.h>
+#endif
+
+/* --- Custom modules -------------------- */
+#include "uplink.h"
+#include "rbuffer.h"
+#include "rrecord.h"
+#include "prof.h"
+#include "meminfo.h"
+
+/*****************************************************************************
+ * Macros                                                                    *
+ *****************************************************************************/
+
+/* Records per frame, bounded by the one byte count field. */
+#define UPLINK_MAX_RECORDS  64
+
+/* Frames sent per poll at most, so a backlog does not hog loop(). */
+#define UPLINK_BURST        4
+
+/* Frame fill that makes a frame worth sending before its deadline. */
+#define UPLINK_FILL         (UPLINK_FRAME_SIZE * 3 / 4)
+
+/*****************************************************************************
+ * Static Variables                                                          *
+ *****************************************************************************/
+
+static rbuffer_t * uplink_rb = NULL;
+static uint8_t uplink_frame[UPLINK_FRAME_SIZE];
+static rrecord_t uplink_recs[UPLINK_MAX_RECORDS];
+static uint32_t uplink_seq = 0;
+static uint32_t uplink_since = 0;       /* When data was first seen queued. */
+static bool uplink_queued = false;
+static uplink_stats_t uplink_counters;
+
+#if defined(ARDUINO_ARCH_SAMD)
+static WiFiUDP uplink_udp;
+static IPAddress uplink_ip;
+static bool uplink_udp_open = false;
+static uint32_t uplink_join_at = 0;
+#elif defined(SURICATA_NATIVE)
+static int uplink_sock = -1;
+static struct sockaddr_in uplink_addr;
+#endif
+
+/*****************************************************************************
+ * Private Functions                                                         *
+ *****************************************************************************/
+
+static void uplink_put32 (uint8_t * p, uint32_t value)
+{
+    p[0] = (uint8_t)value;
+    p[1] = (uint8_t)(value >> 8);
+    p[2] = (uint8_t)(value >> 16);
+    p[3] = (uint8_t)(value >> 24);
+}
+
+/* --- Link -----------------------------------------------------------------*/
+
+#if defined(ARDUINO_ARCH_SAMD)
+
+/**
+ * @brief Asks the radio to join the network. WiFi.begin() would wait for
+ * the association; the driver call only sends the request.
+ */
+static void uplink_join (void)
+{
+    WiFiDrv::wifiSetPassphrase(UPLINK_WIFI_SSID, strlen(UPLINK_WIFI_SSID),
+                               UPLINK_WIFI_PASS, strlen(UPLINK_WIFI_PASS));
+    uplink_join_at = micros();
+}
+
+static int uplink_link_open (void)
+{
+    if ((UPLINK_WIFI_SSID[0] == '\0') || !uplink_ip.fromString(UPLINK_HOST))
+    {
+        return ERR_UPLINK_LINK_DOWN;
+    }
+
+    WiFiDrv::wifiDriverInit();
+    uplink_join();
+
+    return ERR_OK;
+}
+
+static bool uplink_link_up (void)
+{
+    if (UPLINK_WIFI_SSID[0] == '\0')
+    {
+        return false;
+    }
+
+    if (WiFi.status() != WL_CONNECTED)
+    {
+        uplink_udp_open = false;
+        if ((uint32_t)(micros() - uplink_join_at) >= UPLINK_RETRY_US)
+        {
+            uplink_join();
+        }
+        return false;
+    }
+
+    if (!uplink_udp_open)
+    {
+        uplink_udp_open = (uplink_udp.begin(UPLINK_PORT) == 1);
+    }
+
+    return uplink_udp_open;
+}
+
+static bool uplink_link_send (const uint8_t * data, uint16_t len)
+{
+    return (uplink_udp.beginPacket(uplink_ip, UPLINK_PORT) == 1) &&
+           (uplink_udp.write(data, len) == len) &&
+           (uplink_udp.endPacket() == 1);
+}
+
+#elif defined(SURICATA_NATIVE)
+
+static int uplink_link_open (void)
+{
+    memset(&uplink_addr, 0, sizeof(uplink_addr));
+    uplink_addr.sin_family = AF_INET;
+    uplink_addr.sin_port = htons(UPLINK_PORT);
+    if (inet_pton(AF_INET, UPLINK_HOST, &uplink_addr.sin_addr) != 1)
+    {
+        return ERR_UPLINK_LINK_DOWN;
+    }
+
+    if (uplink_sock < 0)
+    {
+        uplink_sock = socket(AF_INET, SOCK_DGRAM, 0);
+    }
+    if ((uplink_sock < 0) || (fcntl(uplink_sock, F_SETFL, O_NONBLOCK) != 0))
+    {
+        return ERR_UPLINK_LINK_DOWN;
+    }
+
+    return ERR_OK;
+}
+
+static bool uplink_link_up (void)
+{
+    return uplink_sock >= 0;
+}
+
+/**
+ * @brief Non-blocking: a full socket buffer refuses the frame, as a slow
+ * radio would.
+ */
+static bool uplink_link_send (const uint8_t * data, uint16_t len)
+{
+    ssize_t n = sendto(uplink_sock, data, len, 0, (const struct sockaddr *)&uplink_addr,
+                       sizeof(uplink_addr));
+
+    return n == (ssize_t)len;
+}
+
+#else
+
+static int uplink_link_open (void)
+{
+    return ERR_UPLINK_LINK_DOWN;
+}
+
+static bool uplink_link_up (void)
+{
+    return false;
+}
+
+static bool uplink_link_send (const uint8_t * data, uint16_t len)
+{
+    (void)data;
+    (void)len;
+
+    return false;
+}
+
+#endif
+
+/* --- Frames ---------------------------------------------------------------*/
+
+/**
+ * @brief Packs the oldest records into uplink_frame without taking them
+ * from the rbuffer. Its only writer is store_push, from the store task,
+ * which overwrites the oldest records when it is full. Tasks do not run
+ * inside each other, so the copy is only checked against the overrun
+ * counter, in case the link ever yields to them.
+ *
+ * @param len Frame length, 0 if there was nothing to pack.
+ * @param count Records packed.
+ * @param nbytes rbuffer bytes spanned by the packed records.
+ * @param mark Overrun counter the copy is valid against.
+ */
+static int uplink_pack (uint16_t * len, uint8_t * count, uint16_t * nbytes, uint32_t * mark)
+{
+    int err = ERR_OK;
+
+    do
+    {
+        uint16_t recs = 0;
+        uint16_t pos = UPLINK_HDR_SIZE;
+        uint16_t i = 0;
+
+        *mark = rbuffer_overruns(uplink_rb);
+        err = rrecord_peek_batch(uplink_rb, uplink_recs, UPLINK_MAX_RECORDS, &recs, nbytes);
+        if (err != ERR_OK)
+        {
+            break;
+        }
+
+        for (i = 0; i < recs; i++)
+        {
+            uint16_t rec_len = uplink_recs[i].len;
+
+            if ((rec_len > 0xFF) ||
+                ((pos + 1U + rec_len + UPLINK_CRC_SIZE) > UPLINK_FRAME_SIZE))
+            {
+                break;
+            }
+            uplink_frame[pos] = (uint8_t)rec_len;
+            memcpy(&uplink_frame[pos + 1], uplink_recs[i].data, rec_len);
+            pos = (uint16_t)(pos + 1U + rec_len);
+        }
+
+        if (i < recs)
+        {
+            /* Span of only the records that fit. A first record that fits
+             * no frame is spanned alone, to be dropped rather than stall
+             * the queue. */
+            err = rrecord_peek_batch(uplink_rb, uplink_recs, (i > 0) ? i : 1, &recs, nbytes);
+        }
+
+        *count = (uint8_t)i;
+        *len = (i > 0) ? pos : 0;
+    } while ((err == ERR_OK) && (rbuffer_overruns(uplink_rb) != *mark));
+
+    if ((err == ERR_OK) && (*len > 0))
+    {
+        uint16_t crc = 0;
+
+        uplink_frame[0] = UPLINK_MAGIC_0;
+        uplink_frame[1] = UPLINK_MAGIC_1;
+        uplink_frame[2] = UPLINK_VERSION;
+        uplink_frame[3] = *count;
+        uplink_put32(&uplink_frame[4], uplink_seq);
+        crc = uplink_crc16(uplink_frame, *len);
+        uplink_frame[*len] = (uint8_t)crc;
+        uplink_frame[*len + 1] = (uint8_t)(crc >> 8);
+        *len = (uint16_t)(*len + UPLINK_CRC_SIZE);
+    }
+
+    return err;
+}
+
+/**
+ * @brief Takes nbytes of sent records out of the rbuffer. Whatever of them
+ * store_push overwrote since mark is already gone. No interrupt handler
+ * writes the rbuffer, so interrupts stay enabled.
+ */
+static void uplink_release (uint16_t nbytes, uint32_t mark)
+{
+    rbuffer_span_t span[RBUFFER_MAX_SPANS];
+    uint32_t dropped = rbuffer_overruns(uplink_rb) - mark;
+
+    if ((dropped < nbytes) && (rbuffer_peek(uplink_rb, span) == ERR_OK))
+    {
+        rbuffer_consume(uplink_rb, (uint16_t)(nbytes - dropped));
+    }
+}
+
+/**
+ * @brief True when the queued data fills a frame well or has waited long
+ * enough.
+ */
+static bool uplink_due (void)
+{
+    uint16_t used = rbuffer_used(uplink_rb);
+
+    if (used == 0)
+    {
+        uplink_queued = false;
+        return false;
+    }
+    if (!uplink_queued)
+    {
+        uplink_queued = true;
+        uplink_since = micros();
+    }
+
+    return (used >= UPLINK_FILL) || ((uint32_t)(micros() - uplink_since) >= UPLINK_MAX_DELAY_US);
+}
+
+/*****************************************************************************
+ * Public Functions                                                          *
+ *****************************************************************************/
+
+int uplink_init (rbuffer_t * rb)
+{
+    if (rb == NULL)
+    {
+        return ERR_UPLINK_NULL_POINTER;
+    }
+
+    uplink_rb = rb;
+    uplink_seq = 0;
+    uplink_queued = false;
+    memset(&uplink_counters, 0, sizeof(uplink_counters));
+    MEMINFO_REGISTER(uplink_frame);
+    MEMINFO_REGISTER(uplink_recs);
+
+    return uplink_link_open();
+}
+
+int uplink_poll (void)
+{
+    int err = ERR_OK;
+
+    if (uplink_rb == NULL)
+    {
+        return ERR_UPLINK_NOT_INIT;
+    }
+
+    for (uint8_t burst = 0; (burst < UPLINK_BURST) && uplink_due(); burst++)
+    {
+        uint16_t len = 0;
+        uint16_t nbytes = 0;
+        uint32_t mark = 0;
+        uint8_t count = 0;
+        bool sent = false;
+
+        if (!uplink_link_up())
+        {
+            uplink_counters.deferred++;
+            err = ERR_UPLINK_LINK_DOWN;
+            break;
+        }
+
+        PROF_BEGIN(uplink_pack);
+        err = uplink_pack(&len, &count, &nbytes, &mark);
+        PROF_END(uplink_pack);
+        if (err != ERR_OK)
+        {
+            break;
+        }
+
+        if (len == 0)
+        {
+            uplink_release(nbytes, mark);
+            continue;
+        }
+
+        PROF_BEGIN(uplink_send);
+        sent = uplink_link_send(uplink_frame, len);
+        PROF_END(uplink_send);
+        if (!sent)
+        {
+            /* Keep the records, the same frame is rebuilt next poll. */
+            uplink_counters.failed++;
+            err = ERR_UPLINK_SEND;
+            break;
+        }
+
+        uplink_release(nbytes, mark);
+        uplink_seq++;
+        uplink_counters.frames++;
+        uplink_counters.records += count;
+        uplink_counters.bytes += len;
+        uplink_queued = false;
+    }
+
+    return err;
+}
+
+void uplink_stats (uplink_stats_t * stats)
+{
+    if (stats != NULL)
+    {
+        *stats = uplink_counters;
+    }
+}
+
+uint16_t uplink_crc16 (const uint8_t * data, uint16_t len)
+{
+    uint16_t crc = 0xFFFF;
+
+    for (uint16_t i = 0; i < len; i++)
+    {
+        crc ^= (uint16_t)(data[i] << 8);
+        for (uint8_t bit = 0; bit < 8; bit++)
+        {
+            crc = (uint16_t)((crc & 0x8000) ? ((crc << 1) ^ 0x1021) : (crc << 1));
+        }
+    }
+
+    return crc;
+}
+
+/* end of file */
@@ -0,0 +1,323 @@
+/*****************************************************************************
+ *                                                                           *
+ * \file test_main.c                                                         *
+ *                                                                           *
+ * \brief agg: every aggregate against a brute-force recompute over the raw  *
+ * samples of its window, for tumbling and sliding windows, empty panes,     *
+ * long pauses and windows not yet full.                                     *
+ *                                                                           *
+ *   pio test -e native -f test_agg                                          *
+ *                                                                           *
+ * \author blackchacal <ribeiro.tonet@gmail.com>                             *
+ * \date Oct 17, 2026                                                        *
+ *                                                                           *
+ * \version 1.0 | \author blackchacal                                        *
+ * File creation.                                                            *
+ *                                                                           *
+ *****************************************************************************/
+
+/*****************************************************************************
+ * Includes                                                                  *
+ *****************************************************************************/
+
+/* --- Standard libraries -------------------- */
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+
+/* --- Test framework -------------------- */
+#include <unity.h>
+
+/* --- Custom modules -------------------- */
+#include "sampler.h"
+#include "agg.h"
+
+/*****************************************************************************
+ * Macros                                                                    *
+ *****************************************************************************/
+
+#define SRC_IN              (1)
+#define SRC_OUT             (9)
+
+#define HOP_US              (10000UL)
+#define START_US            (1000000UL)
+
+#define MAX_SAMPLES         (20000)
+#define MAX_EMITS           (4096)
+
+/*****************************************************************************
+ * Static Variables                                                          *
+ *****************************************************************************/
+
+static agg_t agg;
+static uint8_t panes = 1;
+
+/* What the channel emitted, and how many of those were checked. */
+static sampler_sample_t emitted[MAX_EMITS];
+static uint32_t emitted_n = 0;
+static uint32_t checked = 0;
+
+/* Every sample fed, for the brute-force recompute. */
+static uint32_t ref_ts[MAX_SAMPLES];
+static int32_t ref_value[MAX_SAMPLES];
+static uint32_t ref_n = 0;
+static uint32_t ref_first = 0;      /* Oldest sample that may be in a window. */
+static uint32_t ref_next = 0;       /* End of the pane being filled. */
+
+static uint32_t rng = 1;
+static uint32_t now = START_US;
+
+/*****************************************************************************
+ * Private Functions                                                         *
+ *****************************************************************************/
+
+static uint32_t rnd (void)
+{
+    rng = rng * 1103515245UL + 12345UL;
+
+    return rng >> 8;
+}
+
+static void collect (const sampler_sample_t * sample)
+{
+    TEST_ASSERT_LESS_THAN(MAX_EMITS, emitted_n);
+    emitted[emitted_n++] = *sample;
+}
+
+static void setup_channel (uint8_t window_panes, uint32_t seed)
+{
+    panes = window_panes;
+    rng = seed;
+    now = START_US + rnd() % HOP_US;
+    emitted_n = 0;
+    checked = 0;
+    ref_n = 0;
+    ref_first = 0;
+
+    agg_init(collect);
+    TEST_ASSERT_EQUAL_INT(ERR_OK, agg_add(&agg, SRC_IN, 0, SRC_OUT, panes * HOP_US, HOP_US, false));
+}
+
+/**
+ * @brief Recomputes the window ending at end from the raw samples and
+ * checks it against the next aggregate emitted. An empty window emits
+ * nothing.
+ */
+static void check_window (uint32_t end)
+{
+    uint32_t start = end - panes * HOP_US;
+    double sum = 0.0;
+    double sq = 0.0;
+    double mean = 0.0;
+    double stddev = 0.0;
+    int32_t min = 0;
+    int32_t max = 0;
+    uint32_t n = 0;
+    const sampler_sample_t * got = NULL;
+
+    while ((ref_first < ref_n) && (ref_ts[ref_first] < start))
+    {
+        ref_first++;
+    }
+    for (uint32_t i = ref_first; (i < ref_n) && (ref_ts[i] < end); i++)
+    {
+        if ((n == 0) || (ref_value[i] < min))
+        {
+            min = ref_value[i];
+        }
+        if ((n == 0) || (ref_value[i] > max))
+        {
+            max = ref_value[i];
+        }
+        sum += ref_value[i];
+        n++;
+    }
+    if (n == 0)
+    {
+        return;
+    }
+
+    mean = sum / n;
+    for (uint32_t i = ref_first; (i < ref_n) && (ref_ts[i] < end); i++)
+    {
+        sq += (ref_value[i] - mean) * (ref_value[i] - mean);
+    }
+    if (n > 1)
+    {
+        stddev = sqrt(sq / (n - 1));
+    }
+
+    TEST_ASSERT_LESS_THAN_MESSAGE(emitted_n, checked, "window not emitted");
+    got = &emitted[checked++];
+    TEST_ASSERT_EQUAL_UINT32(end, got->ts_us);
+    TEST_ASSERT_EQUAL_UINT8(SRC_OUT, got->src);
+    TEST_ASSERT_EQUAL_UINT8(AGG_VALUES, got->count);
+    TEST_ASSERT_EQUAL_INT32(min, got->value[AGG_VALUE_MIN]);
+    TEST_ASSERT_EQUAL_INT32(max, got->value[AGG_VALUE_MAX]);
+    /* The channel works in float: allow the last digit to round apart. */
+    TEST_ASSERT_INT32_WITHIN(1, lround(mean), got->value[AGG_VALUE_MEAN]);
+    TEST_ASSERT_INT32_WITHIN(1, lround(stddev), got->value[AGG_VALUE_STDDEV]);
+}
+
+/**
+ * @brief Feeds one sample, then checks every window it closed.
+ */
+static void feed (uint32_t ts, int32_t value)
+{
+    sampler_sample_t sample;
+
+    memset(&sample, 0, sizeof(sample));
+    sample.ts_us = ts;
+    sample.src = SRC_IN;
+    sample.count = 1;
+    sample.value[0] = value;
+    TEST_ASSERT_FALSE(agg_feed(&sample));
+
+    if (ref_n == 0)
+    {
+        ref_next = ts - ts % HOP_US + HOP_US;
+    }
+    while (ts >= ref_next)
+    {
+        check_window(ref_next);
+        ref_next += HOP_US;
+    }
+    TEST_ASSERT_EQUAL_UINT32(checked, emitted_n);
+
+    TEST_ASSERT_LESS_THAN(MAX_SAMPLES, ref_n);
+    ref_ts[ref_n] = ts;
+    ref_value[ref_n] = value;
+    ref_n++;
+}
+
+/**
+ * @brief Feeds count samples about a tenth of a hop apart, around base,
+ * with a spike now and then for the min and max to follow.
+ */
+static void feed_run (uint32_t count, int32_t base, int32_t noise)
+{
+    for (uint32_t i = 0; i < count; i++)
+    {
+        int32_t value = base + (int32_t)(rnd() % (2 * noise + 1)) - noise;
+
+        if ((rnd() % 97) == 0)
+        {
+            value += ((rnd() & 1) ? 3 : -3) * noise;
+        }
+        feed(now, value);
+        now += HOP_US / 20 + rnd() % (HOP_US / 10);
+    }
+}
+
+/*****************************************************************************
+ * Tests                                                                     *
+ *****************************************************************************/
+
+void setUp (void)
+{
+}
+
+void tearDown (void)
+{
+}
+
+static void test_tumbling_window (void)
+{
+    setup_channel(1, 19);
+    feed_run(5000, 2500, 400);
+    TEST_ASSERT_GREATER_THAN(400, emitted_n);
+}
+
+static void test_sliding_window (void)
+{
+    setup_channel(AGG_MAX_PANES, 20);
+    feed_run(5000, -1200, 300);
+    TEST_ASSERT_GREATER_THAN(400, emitted_n);
+}
+
+/**
+ * @brief A sliding window emits from its first pane on, before it is
+ * full, over what it has so far.
+ */
+static void test_emits_before_the_first_window_fills (void)
+{
+    uint32_t end = 0;
+
+    setup_channel(AGG_MAX_PANES, 21);
+    end = now - now % HOP_US + HOP_US;
+    while (now < end)
+    {
+        feed_run(1, 100, 10);
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, emitted_n);
+
+    /* The first sample past the pane closes it. */
+    feed_run(1, 100, 10);
+    TEST_ASSERT_EQUAL_UINT32(1, emitted_n);
+    TEST_ASSERT_EQUAL_UINT32(end, emitted[0].ts_us);
+
+    feed_run(2 * AGG_MAX_PANES * 10, 100, 10);
+}
+
+/**
+ * @brief Bursts with gaps of one to panes - 1 hops, so windows hold empty
+ * panes between full ones.
+ */
+static void test_empty_panes (void)
+{
+    setup_channel(4, 22);
+    for (uint16_t burst = 0; burst < 300; burst++)
+    {
+        feed_run(1 + rnd() % 25, 500 + (int32_t)(rnd() % 200), 50);
+        now += HOP_US * (1 + rnd() % 3);
+    }
+}
+
+/**
+ * @brief Pauses around and well past the window length, so the channel
+ * skips panes, then keeps going from the same deques.
+ */
+static void test_long_pause (void)
+{
+    static const uint32_t pauses[] = {3, 4, 5, 6, 40, 1000};
+
+    setup_channel(4, 23);
+    for (uint8_t round = 0; round < 4; round++)
+    {
+        for (uint8_t i = 0; i < sizeof(pauses) / sizeof(pauses[0]); i++)
+        {
+            feed_run(60, 300 * i, 40);
+            now += HOP_US * pauses[i] + rnd() % HOP_US;
+        }
+    }
+    feed_run(60, 0, 40);
+}
+
+/**
+ * @brief A large offset with little spread is where float m2 drifts if
+ * unmerges pile up without the periodic rebuild.
+ */
+static void test_large_offset_keeps_stddev (void)
+{
+    setup_channel(AGG_MAX_PANES, 24);
+    feed_run(MAX_SAMPLES - 1, 1000000, 30);
+}
+
+/*****************************************************************************
+ * Code                                                                      *
+ *****************************************************************************/
+
+int main (void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_tumbling_window);
+    RUN_TEST(test_sliding_window);
+    RUN_TEST(test_emits_before_the_first_window_fills);
+    RUN_TEST(test_empty_panes);
+    RUN_TEST(test_long_pause);
+    RUN_TEST(test_large_offset_keeps_stddev);
+    return UNITY_END();
+}
+
+/* end of file */
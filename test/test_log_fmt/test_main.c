@@ -0,0 +1,212 @@
+/*****************************************************************************
+ *                                                                           *
+ * \file test_main.c                                                         *
+ *                                                                           *
+ * \brief log_fmt: every supported integer, character and string conversion *
+ * against the snprintf it replaces, over a table of flags, widths,          *
+ * precisions and values; %k, which snprintf lacks, against fixed strings.   *
+ *                                                                           *
+ *   pio test -e native -f test_log_fmt                                      *
+ *                                                                           *
+ * \author blackchacal <ribeiro.tonet@gmail.com>                             *
+ * \date Oct 17, 2026                                                        *
+ *                                                                           *
+ * \version 1.0 | \author blackchacal                                        *
+ * File creation.                                                            *
+ *                                                                           *
+ *****************************************************************************/
+
+/*****************************************************************************
+ * Includes                                                                  *
+ *****************************************************************************/
+
+/* --- Standard libraries -------------------- */
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+/* --- Test framework -------------------- */
+#include <unity.h>
+
+/* --- Custom modules -------------------- */
+#include "log_fmt.h"
+
+/*****************************************************************************
+ * Macros                                                                    *
+ *****************************************************************************/
+
+#define OUT_SIZE            (128)
+#define COUNT(a)            (sizeof(a) / sizeof((a)[0]))
+
+/*****************************************************************************
+ * Static Variables                                                          *
+ *****************************************************************************/
+
+static const int values[] = {
+    0, 1, -1, 7, 42, -42, 255, 12345, -98765, 2147483647, -2147483647 - 1
+};
+
+static const long long long_values[] = {
+    0, -5, 4294967296LL, -4294967297LL, 9223372036854775807LL, -9223372036854775807LL - 1
+};
+
+static const char * const int_formats[] = {
+    "%d", "%i", "%5d", "%-5d|", "%05d", "%+d", "%+5d", "%+-6d|", "%+05d",
+    "%.3d", "%+.3d", "%8.3d", "%-8.3d|", "%08.3d", "%.12d",
+    "%.0d", "%+.0d", "%5.0d", "%-3.0d|", "<%d>",
+};
+
+static const char * const uint_formats[] = {
+    "%u", "%+u", "%.3u", "%08.3u", "%.0u",
+    "%x", "%X", "%8x", "%-8X|", "%08x", "%.5x", "%08.3X", "%.0x",
+};
+
+static const char * const long_formats[] = {
+    "%lld", "%+lld", "%.20lld", "%24lld", "%-24lld|", "%llu", "%llx", "%.18llX",
+};
+
+/* %k against what a reader of the value would write by hand. */
+static const struct
+{
+    const char * fmt;
+    int32_t value;
+    const char * text;
+} k_cases[] = {
+    {"%.2k",    2315,   "23.15"},
+    {"%.2k",    -2315,  "-23.15"},
+    {"%+.2k",   2315,   "+23.15"},
+    {"%.2k",    5,      "0.05"},
+    {"%.2k",    -5,     "-0.05"},
+    {"%.1k",    0,      "0.0"},
+    {"%.3k",    1,      "0.001"},
+    {"%06.1k",  -5,     "-000.5"},
+    {"%8.2k|",  2315,   "   23.15|"},
+    {"%-8.2k|", 2315,   "23.15   |"},
+    {"%+07.2k", 125,    "+001.25"},
+    {"%.0k",    7,      "7"},
+    {"%k",      -3,     "-3"},
+    {"%.0k",    0,      "0"},
+};
+
+static char got[OUT_SIZE];
+static char expect[OUT_SIZE];
+
+/*****************************************************************************
+ * Private Functions                                                         *
+ *****************************************************************************/
+
+static void format (const char * fmt, ...)
+{
+    log_fmt_t out;
+    va_list vargs;
+
+    log_fmt_init(&out, got, OUT_SIZE - 1);
+    va_start(vargs, fmt);
+    log_fmt_vprintf(&out, fmt, vargs);
+    va_end(vargs);
+    TEST_ASSERT_FALSE(out.truncated);
+    got[out.len] = '\0';
+}
+
+static void reference (const char * fmt, ...)
+{
+    va_list vargs;
+
+    va_start(vargs, fmt);
+    vsnprintf(expect, OUT_SIZE, fmt, vargs);
+    va_end(vargs);
+}
+
+/*****************************************************************************
+ * Tests                                                                     *
+ *****************************************************************************/
+
+void setUp (void)
+{
+}
+
+void tearDown (void)
+{
+}
+
+static void test_signed_match_snprintf (void)
+{
+    for (uint8_t f = 0; f < COUNT(int_formats); f++)
+    {
+        for (uint8_t v = 0; v < COUNT(values); v++)
+        {
+            format(int_formats[f], values[v]);
+            reference(int_formats[f], values[v]);
+            TEST_ASSERT_EQUAL_STRING_MESSAGE(expect, got, int_formats[f]);
+        }
+    }
+}
+
+static void test_unsigned_match_snprintf (void)
+{
+    for (uint8_t f = 0; f < COUNT(uint_formats); f++)
+    {
+        for (uint8_t v = 0; v < COUNT(values); v++)
+        {
+            format(uint_formats[f], (unsigned int)values[v]);
+            reference(uint_formats[f], (unsigned int)values[v]);
+            TEST_ASSERT_EQUAL_STRING_MESSAGE(expect, got, uint_formats[f]);
+        }
+    }
+}
+
+static void test_long_long_match_snprintf (void)
+{
+    for (uint8_t f = 0; f < COUNT(long_formats); f++)
+    {
+        for (uint8_t v = 0; v < COUNT(long_values); v++)
+        {
+            format(long_formats[f], long_values[v]);
+            reference(long_formats[f], long_values[v]);
+            TEST_ASSERT_EQUAL_STRING_MESSAGE(expect, got, long_formats[f]);
+        }
+    }
+}
+
+static void test_chars_and_strings_match_snprintf (void)
+{
+    static const char * const formats[] = {
+        "%c|%3c|%-3c|", "%s|%8s|%-8s|%.2s|%.0s|%%",
+    };
+
+    format(formats[0], 'a', 'b', 'c');
+    reference(formats[0], 'a', 'b', 'c');
+    TEST_ASSERT_EQUAL_STRING(expect, got);
+
+    format(formats[1], "abc", "abc", "abc", "abc", "abc");
+    reference(formats[1], "abc", "abc", "abc", "abc", "abc");
+    TEST_ASSERT_EQUAL_STRING(expect, got);
+}
+
+static void test_fixed_point (void)
+{
+    for (uint8_t i = 0; i < COUNT(k_cases); i++)
+    {
+        format(k_cases[i].fmt, k_cases[i].value);
+        TEST_ASSERT_EQUAL_STRING_MESSAGE(k_cases[i].text, got, k_cases[i].fmt);
+    }
+}
+
+/*****************************************************************************
+ * Code                                                                      *
+ *****************************************************************************/
+
+int main (void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_signed_match_snprintf);
+    RUN_TEST(test_unsigned_match_snprintf);
+    RUN_TEST(test_long_long_match_snprintf);
+    RUN_TEST(test_chars_and_strings_match_snprintf);
+    RUN_TEST(test_fixed_point);
+    return UNITY_END();
+}
+
+/* end of file */
@@ -0,0 +1,372 @@
+/*****************************************************************************
+ *                                                                           *
+ * \file test_main.c                                                         *
+ *                                                                           *
+ * \brief log_isr: slot exhaustion, drop count and line order under          *
+ * simulated interrupts and concurrent host writers.                         *
+ *                                                                           *
+ *   pio test -e native -f test_log_isr                                      *
+ *                                                                           *
+ * \author blackchacal <ribeiro.tonet@gmail.com>                             *
+ * \date Oct 17, 2026                                                        *
+ *                                                                           *
+ * \version 1.0 | \author blackchacal                                        *
+ * File creation.                                                            *
+ *                                                                           *
+ *****************************************************************************/
+
+/*****************************************************************************
+ * Includes                                                                  *
+ *****************************************************************************/
+
+/* --- Standard libraries -------------------- */
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdarg.h>
+#include <pthread.h>
+#include <unistd.h>
+
+/* --- Arduino libraries -------------------- */
+#include <Arduino.h>
+
+/* --- Test framework -------------------- */
+#include <unity.h>
+
+/* --- Custom modules -------------------- */
+#include "log_isr.h"
+
+/*****************************************************************************
+ * Macros                                                                    *
+ *****************************************************************************/
+
+/* Slot types the test uses to tell the writers apart. */
+#define TYPE_THREAD         (0)
+#define TYPE_ISR            (1)
+
+#define INJECT_PERIOD_US    (20)
+#define INJECT_LINES        (200000UL)
+#define INJECT_DRAIN_EVERY  (4)
+
+#define THREAD_LINES        (50000UL)
+#define THREAD_WAIT_US      (10)
+
+/*****************************************************************************
+ * Static Variables                                                          *
+ *****************************************************************************/
+
+/* Injector state: the line the thread is writing when the interrupt hits,
+ * and one past the last line it wrote successfully before that. */
+static volatile uint32_t thread_at = 0;
+static volatile uint32_t thread_done = 0;
+static volatile uint32_t isr_count = 0;
+static volatile uint32_t isr_lost = 0;
+static volatile bool isr_saw_active = true;
+
+/* Drain results. */
+static uint32_t got_thread = 0;
+static uint32_t got_isr = 0;
+static uint32_t last_thread = 0;
+static uint32_t last_isr = 0;
+static bool any_thread = false;
+static bool any_isr = false;
+static uint32_t next_seq = 0;
+static bool any_seq = false;
+
+/*****************************************************************************
+ * Private Functions                                                         *
+ *****************************************************************************/
+
+static bool capture (uint8_t type, const char * fmt, ...)
+{
+    va_list vargs;
+    bool ok;
+
+    va_start(vargs, fmt);
+    ok = log_isr_vcapture(type, "TST", fmt, vargs);
+    va_end(vargs);
+
+    return ok;
+}
+
+static void drain (void)
+{
+    log_isr_slot_t * slot;
+
+    while ((slot = log_isr_next()) != NULL)
+    {
+        log_isr_release(slot);
+    }
+}
+
+/**
+ * @brief Lines come out numbered without gaps, drops included.
+ */
+static void check_seq (const log_isr_slot_t * slot)
+{
+    TEST_ASSERT_TRUE(!any_seq || (slot->seq == next_seq));
+    next_seq = slot->seq + 1;
+    any_seq = true;
+}
+
+/**
+ * @brief Simulated interrupt: logs its own count and where the thread was.
+ */
+static void inject_isr (void)
+{
+    if (!log_isr_active())
+    {
+        isr_saw_active = false;
+    }
+    if (!capture(TYPE_ISR, "%u %u %u", (unsigned)isr_count, (unsigned)thread_at,
+                 (unsigned)thread_done))
+    {
+        isr_lost++;
+    }
+    isr_count++;
+}
+
+/**
+ * @brief Takes every ready line and checks it against all seen so far.
+ */
+static void drain_checked (void)
+{
+    log_isr_slot_t * slot;
+
+    while ((slot = log_isr_next()) != NULL)
+    {
+        uint32_t n = slot->u.text.argv[0];
+
+        check_seq(slot);
+        if (slot->type == TYPE_THREAD)
+        {
+            TEST_ASSERT_EQUAL_UINT8(1, slot->len);
+            TEST_ASSERT_TRUE(!any_thread || (n > last_thread));
+            last_thread = n;
+            any_thread = true;
+            got_thread++;
+        }
+        else
+        {
+            uint32_t at = slot->u.text.argv[1];
+            uint32_t done = slot->u.text.argv[2];
+
+            TEST_ASSERT_EQUAL_UINT8(3, slot->len);
+            TEST_ASSERT_TRUE(!any_isr || (n > last_isr));
+            /* It came while the thread wrote line at: after the last line
+             * written before, and before any later one. */
+            if (done > 0)
+            {
+                TEST_ASSERT_TRUE(any_thread && (last_thread >= done - 1));
+            }
+            TEST_ASSERT_TRUE(!any_thread || (last_thread <= at));
+            last_isr = n;
+            any_isr = true;
+            got_isr++;
+        }
+        log_isr_release(slot);
+    }
+}
+
+/**
+ * @brief Host writer thread: logs its numbered lines as fast as it can.
+ */
+static void * writer (void * arg)
+{
+    uint8_t type = (uint8_t)(uintptr_t)arg;
+
+    for (uint32_t i = 0; i < THREAD_LINES; i++)
+    {
+        while (!capture(type, "%u", (unsigned)i))
+        {
+            /* Full: let the reader catch up. */
+            usleep(THREAD_WAIT_US);
+        }
+    }
+
+    return NULL;
+}
+
+/*****************************************************************************
+ * Tests                                                                     *
+ *****************************************************************************/
+
+void setUp (void)
+{
+    drain();
+    any_seq = false;
+}
+
+void tearDown (void)
+{
+    native_timer_stop();
+}
+
+static void test_capture_keeps_arguments (void)
+{
+    log_isr_slot_t * slot;
+
+    TEST_ASSERT_TRUE(capture(TYPE_THREAD, "%d %lu", -5, 70000UL));
+
+    slot = log_isr_next();
+    TEST_ASSERT_NOT_NULL(slot);
+    TEST_ASSERT_EQUAL_UINT8(TYPE_THREAD, slot->type);
+    TEST_ASSERT_EQUAL_STRING("TST", slot->u.text.tag);
+    TEST_ASSERT_EQUAL_UINT8(2, slot->len);
+    TEST_ASSERT_EQUAL_INT32(-5, (int32_t)slot->u.text.argv[0]);
+    TEST_ASSERT_EQUAL_UINT32(70000UL, slot->u.text.argv[1]);
+    log_isr_release(slot);
+
+    TEST_ASSERT_NULL(log_isr_next());
+}
+
+static void test_full_pool_drops_and_counts (void)
+{
+    uint32_t dropped = log_isr_dropped();
+    log_isr_slot_t * slot;
+
+    for (unsigned i = 0; i < LOG_ISR_SLOTS; i++)
+    {
+        TEST_ASSERT_TRUE(capture(TYPE_THREAD, "%u", i));
+    }
+    TEST_ASSERT_FALSE(capture(TYPE_THREAD, "%u", 100u));
+    TEST_ASSERT_FALSE(capture(TYPE_THREAD, "%u", 101u));
+    TEST_ASSERT_EQUAL_UINT32(dropped + 2, log_isr_dropped());
+
+    /* One slot back: the next line takes it and comes out last. */
+    slot = log_isr_next();
+    TEST_ASSERT_NOT_NULL(slot);
+    TEST_ASSERT_EQUAL_UINT32(0, slot->u.text.argv[0]);
+    log_isr_release(slot);
+    TEST_ASSERT_TRUE(capture(TYPE_THREAD, "%u", 102u));
+    TEST_ASSERT_FALSE(capture(TYPE_THREAD, "%u", 103u));
+    TEST_ASSERT_EQUAL_UINT32(dropped + 3, log_isr_dropped());
+
+    for (unsigned i = 1; i < LOG_ISR_SLOTS; i++)
+    {
+        slot = log_isr_next();
+        TEST_ASSERT_NOT_NULL(slot);
+        TEST_ASSERT_EQUAL_UINT32(i, slot->u.text.argv[0]);
+        log_isr_release(slot);
+    }
+    slot = log_isr_next();
+    TEST_ASSERT_NOT_NULL(slot);
+    TEST_ASSERT_EQUAL_UINT32(102u, slot->u.text.argv[0]);
+    log_isr_release(slot);
+    TEST_ASSERT_NULL(log_isr_next());
+}
+
+static void test_oversized_frame_is_dropped (void)
+{
+    uint8_t frame[LOG_ISR_FRAME_SIZE + 1] = { 0 };
+    uint32_t dropped = log_isr_dropped();
+    log_isr_slot_t * slot;
+
+    TEST_ASSERT_FALSE(log_isr_frame(frame, sizeof(frame)));
+    TEST_ASSERT_EQUAL_UINT32(dropped + 1, log_isr_dropped());
+
+    frame[0] = 0xA5;
+    TEST_ASSERT_TRUE(log_isr_frame(frame, LOG_ISR_FRAME_SIZE));
+    slot = log_isr_next();
+    TEST_ASSERT_NOT_NULL(slot);
+    TEST_ASSERT_EQUAL_UINT8(LOG_ISR_FRAME, slot->type);
+    TEST_ASSERT_EQUAL_UINT8(LOG_ISR_FRAME_SIZE, slot->len);
+    TEST_ASSERT_EQUAL_HEX8(0xA5, slot->u.frame[0]);
+    log_isr_release(slot);
+}
+
+/**
+ * @brief The thread writes numbered lines while the timer injects
+ * interrupts that write their own, landing anywhere inside a capture.
+ * Every line comes out once, in the order it was written, and whatever is
+ * missing was counted as dropped.
+ */
+static void test_injected_interrupts_keep_order (void)
+{
+    uint32_t dropped = log_isr_dropped();
+    uint32_t thread_lost = 0;
+
+    got_thread = got_isr = 0;
+    any_thread = any_isr = false;
+    isr_count = isr_lost = 0;
+    isr_saw_active = true;
+    thread_done = 0;
+
+    TEST_ASSERT_TRUE(native_timer_start(INJECT_PERIOD_US, inject_isr));
+    for (uint32_t i = 0; i < INJECT_LINES; i++)
+    {
+        thread_at = i;
+        if (capture(TYPE_THREAD, "%u", (unsigned)i))
+        {
+            thread_done = i + 1;
+        }
+        else
+        {
+            thread_lost++;
+        }
+        if ((i % INJECT_DRAIN_EVERY) == 0)
+        {
+            drain_checked();
+        }
+    }
+    native_timer_stop();
+    drain_checked();
+
+    TEST_ASSERT_TRUE(isr_saw_active);
+    TEST_ASSERT_GREATER_THAN(0, isr_count);
+    TEST_ASSERT_EQUAL_UINT32(INJECT_LINES - thread_lost, got_thread);
+    TEST_ASSERT_EQUAL_UINT32(isr_count - isr_lost, got_isr);
+    TEST_ASSERT_EQUAL_UINT32(dropped + thread_lost + isr_lost, log_isr_dropped());
+}
+
+/**
+ * @brief Two host threads write at once, preempted anywhere or running on
+ * other cores, so a writer can be caught between claiming a slot and
+ * numbering it.
+ * Each thread's lines still come out complete and in order.
+ */
+static void test_concurrent_writers_keep_order (void)
+{
+    pthread_t w[2];
+    uint32_t next[2] = { 0, 0 };
+    uint32_t got = 0;
+
+    TEST_ASSERT_EQUAL_INT(0, pthread_create(&w[0], NULL, writer, (void *)(uintptr_t)0));
+    TEST_ASSERT_EQUAL_INT(0, pthread_create(&w[1], NULL, writer, (void *)(uintptr_t)1));
+
+    while (got < 2 * THREAD_LINES)
+    {
+        log_isr_slot_t * slot = log_isr_next();
+
+        if (slot == NULL)
+        {
+            usleep(THREAD_WAIT_US);
+            continue;
+        }
+        check_seq(slot);
+        TEST_ASSERT_EQUAL_UINT32(next[slot->type], slot->u.text.argv[0]);
+        next[slot->type]++;
+        got++;
+        log_isr_release(slot);
+    }
+
+    pthread_join(w[0], NULL);
+    pthread_join(w[1], NULL);
+    TEST_ASSERT_NULL(log_isr_next());
+}
+
+/*****************************************************************************
+ * Code                                                                      *
+ *****************************************************************************/
+
+int main (void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_capture_keeps_arguments);
+    RUN_TEST(test_full_pool_drops_and_counts);
+    RUN_TEST(test_oversized_frame_is_dropped);
+    RUN_TEST(test_injected_interrupts_keep_order);
+    RUN_TEST(test_concurrent_writers_keep_order);
+    return UNITY_END();
+}
+
+/* end of file */
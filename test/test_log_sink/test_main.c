@@ -0,0 +1,164 @@
+/*****************************************************************************
+ *                                                                           *
+ * \file test_main.c                                                         *
+ *                                                                           *
+ * \brief Serial sink: lines longer than one USB CDC packet reach the port   *
+ * whole, written as they come or drained from a queue.                      *
+ *                                                                           *
+ *   pio test -e native -f test_log_sink                                     *
+ *                                                                           *
+ * \author blackchacal <ribeiro.tonet@gmail.com>                             *
+ * \date Oct 17, 2026                                                        *
+ *                                                                           *
+ * \version 1.0 | \author blackchacal                                        *
+ * File creation.                                                            *
+ *                                                                           *
+ *****************************************************************************/
+
+/*****************************************************************************
+ * Includes                                                                  *
+ *****************************************************************************/
+
+/* --- Standard libraries -------------------- */
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+/* --- Arduino libraries -------------------- */
+#include <Arduino.h>
+
+/* --- Test framework -------------------- */
+#include <unity.h>
+
+/* --- Custom modules -------------------- */
+#include "rbuffer.h"
+#include "logger.h"
+#include "log_sink.h"
+
+/*****************************************************************************
+ * Macros                                                                    *
+ *****************************************************************************/
+
+#define SERIAL_OUT          "test_log_sink.out"
+
+/* Well past NATIVE_SERIAL_TX_SIZE, as on the board's 63 byte endpoint. */
+#define LONG_LEN            (200)
+
+#define QUEUE_SIZE          (1024)
+
+/*****************************************************************************
+ * Static Variables                                                          *
+ *****************************************************************************/
+
+static char long_text[LONG_LEN + 1];
+static char expect[2 * MAX_LOG_MSG_SIZE];
+static char got[2 * MAX_LOG_MSG_SIZE];
+
+#if LOG_DEFERRED_EN == 1
+static uint8_t queue_buf[QUEUE_SIZE];
+#endif
+
+/*****************************************************************************
+ * Private Functions                                                         *
+ *****************************************************************************/
+
+/**
+ * @brief Reads back what the port got since setUp. Returns its length.
+ */
+static size_t serial_read (void)
+{
+    FILE * f = fopen(SERIAL_OUT, "rb");
+    size_t n = 0;
+
+    TEST_ASSERT_NOT_NULL(f);
+    n = fread(got, 1, sizeof(got) - 1, f);
+    got[n] = '\0';
+    fclose(f);
+
+    return n;
+}
+
+/*****************************************************************************
+ * Tests                                                                     *
+ *****************************************************************************/
+
+void setUp (void)
+{
+    TEST_ASSERT_TRUE(native_serial_open(SERIAL_OUT));
+    memset(got, 0, sizeof(got));
+}
+
+void tearDown (void)
+{
+}
+
+/**
+ * @brief A queued sink drains everything the port takes in one write, not
+ * one packet of it.
+ */
+static void test_queued_drain_is_not_cut_at_one_packet (void)
+{
+    log_sink_t sink;
+    rbuffer_span_t span[RBUFFER_MAX_SPANS];
+
+    memset(&sink, 0, sizeof(sink));
+    memset(span, 0, sizeof(span));
+#if LOG_DEFERRED_EN == 1
+    TEST_ASSERT_EQUAL_INT(ERR_OK, rbuffer_init(&sink.queue, queue_buf, QUEUE_SIZE,
+                                               RBUFFER_POLICY_REJECT));
+#endif
+    span[0].ptr = (uint8_t *)long_text;
+    span[0].len = 120;
+    span[1].ptr = (uint8_t *)&long_text[120];
+    span[1].len = LONG_LEN - 120;
+
+    TEST_ASSERT_EQUAL_UINT16(LONG_LEN, log_sink_serial.write(&sink, span, RBUFFER_MAX_SPANS));
+    log_sink_serial.flush(&sink);
+
+    TEST_ASSERT_EQUAL_INT(LONG_LEN, serial_read());
+    TEST_ASSERT_EQUAL_STRING(long_text, got);
+}
+
+/**
+ * @brief A sink without a queue has nowhere to keep a rest: every line,
+ * however long, arrives whole with its line ending, and the next line
+ * starts on its own.
+ */
+static void test_queueless_sink_gets_long_lines_whole (void)
+{
+    static log_sink_t direct;
+
+    TEST_ASSERT_EQUAL_INT(ERR_OK, log_sink_add(&direct, &log_sink_serial, NULL,
+                                               LOG_LEVEL_DEBUG, NULL, 0));
+
+    LOG_INFO("TEST", "%s", long_text);
+    LOG_INFO("TEST", "next line");
+    LOG_FLUSH();
+
+    snprintf(expect, sizeof(expect), "INFO - TEST | %s\r\nINFO - TEST | next line\r\n", long_text);
+    TEST_ASSERT_EQUAL_INT(strlen(expect), serial_read());
+    TEST_ASSERT_EQUAL_STRING(expect, got);
+    TEST_ASSERT_EQUAL_UINT32(strlen(expect), direct.bytes);
+    TEST_ASSERT_EQUAL_UINT32(0, direct.dropped);
+}
+
+/*****************************************************************************
+ * Code                                                                      *
+ *****************************************************************************/
+
+int main (void)
+{
+    for (uint16_t i = 0; i < LONG_LEN; i++)
+    {
+        long_text[i] = (char)('a' + i % 26);
+    }
+    long_text[LONG_LEN] = '\0';
+
+    UNITY_BEGIN();
+    RUN_TEST(test_queued_drain_is_not_cut_at_one_packet);
+    RUN_TEST(test_queueless_sink_gets_long_lines_whole);
+    return UNITY_END();
+}
+
+/* end of file */
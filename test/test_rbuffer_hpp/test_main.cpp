@@ -0,0 +1,286 @@
+/*****************************************************************************
+ *                                                                           *
+ * \file test_main.cpp                                                       *
+ *                                                                           *
+ * \brief RingBuffer<T, N> with a struct element: FIFO order across the      *
+ * index wrap, split spans, exact full/empty and the overwrite policy.      *
+ * Every member is instantiated, so template errors fail the build.         *
+ *                                                                           *
+ *   pio test -e native -f test_rbuffer_hpp                                  *
+ *                                                                           *
+ * \author blackchacal <ribeiro.tonet@gmail.com>                             *
+ * \date Oct 17, 2026                                                        *
+ *                                                                           *
+ * \version 1.0 | \author blackchacal                                        *
+ * File creation.                                                            *
+ *                                                                           *
+ *****************************************************************************/
+
+/*****************************************************************************
+ * Includes                                                                  *
+ *****************************************************************************/
+
+/* --- Standard libraries -------------------- */
+#include <stdint.h>
+#include <string.h>
+
+/* --- Test framework -------------------- */
+#include <unity.h>
+
+/* --- Custom modules -------------------- */
+#include "rbuffer.hpp"
+
+/*****************************************************************************
+ * Macros                                                                    *
+ *****************************************************************************/
+
+#define RING_SIZE           (8)
+
+/*****************************************************************************
+ * Datatypes                                                                 *
+ *****************************************************************************/
+
+/**
+ * \struct sample_t
+ * A non-byte element, larger than the indexes that count it.
+ */
+typedef struct
+{
+    uint32_t ts;
+    int16_t value[3];
+} sample_t;
+
+typedef RingBuffer<sample_t, RING_SIZE> ring_t;
+
+/* Every member function, not only the ones the tests call. */
+template class RingBuffer<sample_t, RING_SIZE>;
+
+static_assert(ring_t::SIZE == RING_SIZE, "size");
+static_assert(ring_t::MASK == RING_SIZE - 1, "mask");
+
+/*****************************************************************************
+ * Private Functions                                                         *
+ *****************************************************************************/
+
+static sample_t make (uint32_t n)
+{
+    sample_t s;
+
+    s.ts = n;
+    s.value[0] = (int16_t)n;
+    s.value[1] = (int16_t)(-(int32_t)n);
+    s.value[2] = (int16_t)(n * 3U);
+
+    return s;
+}
+
+static void check (uint32_t n, const sample_t & s)
+{
+    TEST_ASSERT_EQUAL_UINT32(n, s.ts);
+    TEST_ASSERT_EQUAL_INT16((int16_t)n, s.value[0]);
+    TEST_ASSERT_EQUAL_INT16((int16_t)(-(int32_t)n), s.value[1]);
+    TEST_ASSERT_EQUAL_INT16((int16_t)(n * 3U), s.value[2]);
+}
+
+/**
+ * @brief Moves head and tail to index at, leaving the ring empty.
+ */
+static void move_to (ring_t & ring, uint16_t at)
+{
+    sample_t s;
+
+    for (uint16_t i = 0; i < at; i++)
+    {
+        TEST_ASSERT_EQUAL_INT(ERR_OK, ring.add(make(0)));
+        TEST_ASSERT_EQUAL_INT(ERR_OK, ring.get(s));
+    }
+    TEST_ASSERT_TRUE(ring.empty());
+}
+
+/*****************************************************************************
+ * Tests                                                                     *
+ *****************************************************************************/
+
+void setUp (void)
+{
+}
+
+void tearDown (void)
+{
+}
+
+static void test_single_elements_keep_order_across_wrap (void)
+{
+    ring_t ring;
+    uint32_t in = 0;
+    uint32_t out = 0;
+    sample_t s;
+
+    /* Three in, two out: the fill level climbs while the indexes wrap
+     * many times over. */
+    for (uint16_t round = 0; round < 200; round++)
+    {
+        for (uint8_t i = 0; (i < 3) && !ring.full(); i++)
+        {
+            TEST_ASSERT_EQUAL_INT(ERR_OK, ring.add(make(in++)));
+        }
+        for (uint8_t i = 0; i < 2; i++)
+        {
+            TEST_ASSERT_EQUAL_INT(ERR_OK, ring.get(s));
+            check(out++, s);
+        }
+        TEST_ASSERT_EQUAL_UINT16(in - out, ring.used());
+    }
+    while (ring.get(s) == ERR_OK)
+    {
+        check(out++, s);
+    }
+    TEST_ASSERT_EQUAL_UINT32(in, out);
+}
+
+static void test_exact_full_and_empty (void)
+{
+    ring_t ring;
+    sample_t items[RING_SIZE + 1];
+    sample_t s;
+
+    for (uint16_t i = 0; i <= RING_SIZE; i++)
+    {
+        items[i] = make(i);
+    }
+
+    TEST_ASSERT_EQUAL_INT(ERR_RBUFFER_EMPTY, ring.get(s));
+    TEST_ASSERT_EQUAL_INT(ERR_RBUFFER_NOT_ENOUGH_SPACE, ring.add(items, RING_SIZE + 1));
+    TEST_ASSERT_EQUAL_INT(ERR_OK, ring.add(items, RING_SIZE));
+    TEST_ASSERT_TRUE(ring.full());
+    TEST_ASSERT_EQUAL_UINT16(0, ring.free());
+    TEST_ASSERT_EQUAL_INT(ERR_RBUFFER_FULL, ring.add(items[RING_SIZE]));
+    TEST_ASSERT_EQUAL_UINT32(0, ring.overruns());
+
+    TEST_ASSERT_EQUAL_INT(ERR_RBUFFER_NOT_ENOUGH_DATA, ring.get(items, RING_SIZE + 1));
+    TEST_ASSERT_EQUAL_INT(ERR_OK, ring.get(items, RING_SIZE));
+    TEST_ASSERT_TRUE(ring.empty());
+    for (uint16_t i = 0; i < RING_SIZE; i++)
+    {
+        check(i, items[i]);
+    }
+}
+
+/**
+ * @brief Bulk add, peek and reserve starting near the end of the storage
+ * split into two spans; the elements still come out whole and in order.
+ */
+static void test_bulk_and_spans_across_wrap (void)
+{
+    ring_t ring;
+    ring_t::span_type span[RBUFFER_MAX_SPANS];
+    sample_t items[5];
+    sample_t all[RING_SIZE];
+
+    move_to(ring, RING_SIZE - 2);
+    for (uint16_t i = 0; i < 5; i++)
+    {
+        items[i] = make(100 + i);
+    }
+    TEST_ASSERT_EQUAL_INT(ERR_OK, ring.add(items, 5));
+
+    TEST_ASSERT_EQUAL_INT(ERR_OK, ring.peek(span));
+    TEST_ASSERT_EQUAL_UINT16(2, span[0].len);
+    TEST_ASSERT_EQUAL_UINT16(3, span[1].len);
+    check(100, span[0].ptr[0]);
+    check(101, span[0].ptr[1]);
+    check(102, span[1].ptr[0]);
+    TEST_ASSERT_EQUAL_INT(ERR_OK, ring.consume(3));
+    TEST_ASSERT_EQUAL_UINT16(2, ring.used());
+
+    /* Head is at 3: a reservation of the rest runs to the end and wraps. */
+    TEST_ASSERT_EQUAL_INT(ERR_OK, ring.reserve(6, span));
+    TEST_ASSERT_EQUAL_UINT16(5, span[0].len);
+    TEST_ASSERT_EQUAL_UINT16(1, span[1].len);
+    for (uint16_t i = 0; i < span[0].len; i++)
+    {
+        span[0].ptr[i] = make(105 + i);
+    }
+    span[1].ptr[0] = make(110);
+    TEST_ASSERT_EQUAL_INT(ERR_OK, ring.commit(6));
+    TEST_ASSERT_TRUE(ring.full());
+
+    TEST_ASSERT_EQUAL_INT(ERR_OK, ring.get(all, RING_SIZE));
+    for (uint16_t i = 0; i < RING_SIZE; i++)
+    {
+        check(103 + i, all[i]);
+    }
+}
+
+static void test_overwrite_drops_the_oldest (void)
+{
+    ring_t ring(RBUFFER_POLICY_OVERWRITE);
+    ring_t::span_type span[RBUFFER_MAX_SPANS];
+    sample_t items[RING_SIZE];
+    sample_t s;
+
+    for (uint32_t i = 0; i < RING_SIZE + 3; i++)
+    {
+        TEST_ASSERT_EQUAL_INT(ERR_OK, ring.add(make(i)));
+    }
+    TEST_ASSERT_TRUE(ring.full());
+    TEST_ASSERT_EQUAL_UINT32(3, ring.overruns());
+    TEST_ASSERT_EQUAL_INT(ERR_OK, ring.get(s));
+    check(3, s);
+
+    /* A bulk add of N replaces everything. */
+    for (uint16_t i = 0; i < RING_SIZE; i++)
+    {
+        items[i] = make(200 + i);
+    }
+    TEST_ASSERT_EQUAL_INT(ERR_OK, ring.add(items, RING_SIZE));
+    TEST_ASSERT_EQUAL_UINT32(3 + RING_SIZE - 1, ring.overruns());
+
+    /* What was peeked is overwritten before the consume: it is refused. */
+    TEST_ASSERT_EQUAL_INT(ERR_OK, ring.peek(span));
+    TEST_ASSERT_EQUAL_INT(ERR_OK, ring.add(make(300)));
+    TEST_ASSERT_EQUAL_INT(ERR_RBUFFER_OVERRUN, ring.consume(2));
+    TEST_ASSERT_EQUAL_INT(ERR_OK, ring.get(s));
+    check(201, s);
+}
+
+static void test_drop_and_clear (void)
+{
+    ring_t ring;
+    sample_t s;
+
+    move_to(ring, 5);
+    for (uint32_t i = 0; i < 6; i++)
+    {
+        TEST_ASSERT_EQUAL_INT(ERR_OK, ring.add(make(i)));
+    }
+    TEST_ASSERT_EQUAL_INT(ERR_RBUFFER_NOT_ENOUGH_DATA, ring.drop(7));
+    TEST_ASSERT_EQUAL_INT(ERR_OK, ring.drop(4));
+    TEST_ASSERT_EQUAL_UINT32(4, ring.overruns());
+    TEST_ASSERT_EQUAL_INT(ERR_OK, ring.get(s));
+    check(4, s);
+
+    ring.clear();
+    TEST_ASSERT_TRUE(ring.empty());
+    TEST_ASSERT_EQUAL_UINT16(RING_SIZE, ring.free());
+    TEST_ASSERT_EQUAL_INT(ERR_OK, ring.add(make(7)));
+    TEST_ASSERT_EQUAL_INT(ERR_OK, ring.get(s));
+    check(7, s);
+}
+
+/*****************************************************************************
+ * Code                                                                      *
+ *****************************************************************************/
+
+int main (void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_single_elements_keep_order_across_wrap);
+    RUN_TEST(test_exact_full_and_empty);
+    RUN_TEST(test_bulk_and_spans_across_wrap);
+    RUN_TEST(test_overwrite_drops_the_oldest);
+    RUN_TEST(test_drop_and_clear);
+    return UNITY_END();
+}
+
+/* end of file */
@@ -0,0 +1,323 @@
+/*****************************************************************************
+ *                                                                           *
+ * \file test_main.c                                                         *
+ *                                                                           *
+ * \brief rbuffer_spsc: index wrap-around, full and empty at exactly the     *
+ * size, and a producer/consumer stress run on two host threads.             *
+ *                                                                           *
+ *   pio test -e native -f test_rbuffer_spsc                                 *
+ *                                                                           *
+ * \author blackchacal <ribeiro.tonet@gmail.com>                             *
+ * \date Oct 17, 2026                                                        *
+ *                                                                           *
+ * \version 1.0 | \author blackchacal                                        *
+ * File creation.                                                            *
+ *                                                                           *
+ *****************************************************************************/
+
+/*****************************************************************************
+ * Includes                                                                  *
+ *****************************************************************************/
+
+/* --- Standard libraries -------------------- */
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+
+/* --- Test framework -------------------- */
+#include <unity.h>
+
+/* --- Custom modules -------------------- */
+#include "rbuffer_spsc.h"
+
+/*****************************************************************************
+ * Macros                                                                    *
+ *****************************************************************************/
+
+#define SMALL_SIZE          (16)
+
+/* Free-running index a few bytes short of wrapping to 0. */
+#define NEAR_WRAP           (0xFFFCU)
+
+#define STRESS_SIZE         (256)
+#define STRESS_BYTES        (1000000UL)
+#define STRESS_WAIT_US      (1)
+
+/*****************************************************************************
+ * Static Variables                                                          *
+ *****************************************************************************/
+
+static uint8_t small_buf[SMALL_SIZE];
+static uint8_t max_buf[RBUFFER_SPSC_MAX_SIZE];
+static uint8_t stress_buf[STRESS_SIZE];
+
+static rbuffer_spsc_t rb;
+
+/*****************************************************************************
+ * Private Functions                                                         *
+ *****************************************************************************/
+
+/**
+ * @brief Moves both indexes to pos, as if that many bytes had passed.
+ */
+static void skip_to (rbuffer_spsc_t * r, uint16_t pos)
+{
+    r->head = pos;
+    r->tail = pos;
+}
+
+/**
+ * @brief Fills the buffer to exactly its size and checks every limit on
+ * the way, then empties it again checking the bytes.
+ */
+static void fill_and_empty (rbuffer_spsc_t * r)
+{
+    uint8_t byte = 0;
+
+    TEST_ASSERT_TRUE(rbuffer_spsc_empty(r));
+    TEST_ASSERT_EQUAL_UINT16(r->size, rbuffer_spsc_free(r));
+    TEST_ASSERT_EQUAL_INT(ERR_RBUFFER_EMPTY, rbuffer_spsc_get_byte(r, &byte));
+
+    for (uint32_t i = 0; i < r->size; i++)
+    {
+        TEST_ASSERT_FALSE(rbuffer_spsc_full(r));
+        TEST_ASSERT_EQUAL_INT(ERR_OK, rbuffer_spsc_add_byte(r, (uint8_t)i));
+    }
+    TEST_ASSERT_TRUE(rbuffer_spsc_full(r));
+    TEST_ASSERT_FALSE(rbuffer_spsc_empty(r));
+    TEST_ASSERT_EQUAL_UINT16(r->size, rbuffer_spsc_used(r));
+    TEST_ASSERT_EQUAL_UINT16(0, rbuffer_spsc_free(r));
+    TEST_ASSERT_EQUAL_INT(ERR_RBUFFER_FULL, rbuffer_spsc_add_byte(r, 0xEE));
+
+    for (uint32_t i = 0; i < r->size; i++)
+    {
+        TEST_ASSERT_EQUAL_INT(ERR_OK, rbuffer_spsc_get_byte(r, &byte));
+        TEST_ASSERT_EQUAL_UINT8((uint8_t)i, byte);
+    }
+    TEST_ASSERT_TRUE(rbuffer_spsc_empty(r));
+    TEST_ASSERT_EQUAL_INT(ERR_RBUFFER_EMPTY, rbuffer_spsc_get_byte(r, &byte));
+}
+
+/**
+ * @brief Stress producer: writes a counting byte stream in varying sizes,
+ * alternating copy-in and in-place writes.
+ */
+static void * producer (void * arg)
+{
+    uint32_t sent = 0;
+    uint8_t chunk[STRESS_SIZE];
+    uint16_t n = 1;
+
+    (void)arg;
+    while (sent < STRESS_BYTES)
+    {
+        rbuffer_span_t span[RBUFFER_MAX_SPANS];
+        int err;
+
+        n = (uint16_t)((n * 7 + 3) % 61) + 1;
+        if (n > STRESS_BYTES - sent)
+        {
+            n = (uint16_t)(STRESS_BYTES - sent);
+        }
+
+        if (n & 1)
+        {
+            for (uint16_t i = 0; i < n; i++)
+            {
+                chunk[i] = (uint8_t)(sent + i);
+            }
+            err = rbuffer_spsc_add_bytes(&rb, chunk, n);
+        }
+        else
+        {
+            err = rbuffer_spsc_reserve(&rb, n, span);
+            if (err == ERR_OK)
+            {
+                uint32_t v = sent;
+
+                for (uint8_t s = 0; s < RBUFFER_MAX_SPANS; s++)
+                {
+                    for (uint16_t i = 0; i < span[s].len; i++)
+                    {
+                        span[s].ptr[i] = (uint8_t)v++;
+                    }
+                }
+                err = rbuffer_spsc_commit(&rb, n);
+            }
+        }
+
+        if (err == ERR_OK)
+        {
+            sent += n;
+        }
+        else
+        {
+            usleep(STRESS_WAIT_US);
+        }
+    }
+
+    return NULL;
+}
+
+/*****************************************************************************
+ * Tests                                                                     *
+ *****************************************************************************/
+
+void setUp (void)
+{
+}
+
+void tearDown (void)
+{
+}
+
+static void test_init_rejects_bad_sizes (void)
+{
+    TEST_ASSERT_EQUAL_INT(ERR_RBUFFER_INVALID_SIZE, rbuffer_spsc_init(&rb, small_buf, 0));
+    TEST_ASSERT_EQUAL_INT(ERR_RBUFFER_INVALID_SIZE, rbuffer_spsc_init(&rb, small_buf, 12));
+    TEST_ASSERT_EQUAL_INT(ERR_RBUFFER_NULL_POINTER, rbuffer_spsc_init(&rb, NULL, SMALL_SIZE));
+    TEST_ASSERT_EQUAL_INT(ERR_OK, rbuffer_spsc_init(&rb, small_buf, SMALL_SIZE));
+}
+
+static void test_full_and_empty_at_size (void)
+{
+    TEST_ASSERT_EQUAL_INT(ERR_OK, rbuffer_spsc_init(&rb, small_buf, SMALL_SIZE));
+    fill_and_empty(&rb);
+
+    /* The largest size is where full (used == size) and empty (used == 0)
+     * are furthest apart in 16 bits: head - tail reaches 0x8000. */
+    TEST_ASSERT_EQUAL_INT(ERR_OK, rbuffer_spsc_init(&rb, max_buf, RBUFFER_SPSC_MAX_SIZE));
+    fill_and_empty(&rb);
+}
+
+static void test_full_and_empty_across_index_wrap (void)
+{
+    TEST_ASSERT_EQUAL_INT(ERR_OK, rbuffer_spsc_init(&rb, small_buf, SMALL_SIZE));
+    skip_to(&rb, NEAR_WRAP);
+    fill_and_empty(&rb);
+    TEST_ASSERT_EQUAL_UINT16((uint16_t)(NEAR_WRAP + SMALL_SIZE), rb.head);
+
+    TEST_ASSERT_EQUAL_INT(ERR_OK, rbuffer_spsc_init(&rb, max_buf, RBUFFER_SPSC_MAX_SIZE));
+    skip_to(&rb, NEAR_WRAP);
+    fill_and_empty(&rb);
+}
+
+static void test_bulk_calls_across_index_wrap (void)
+{
+    uint8_t in[SMALL_SIZE];
+    uint8_t out[SMALL_SIZE];
+    rbuffer_span_t span[RBUFFER_MAX_SPANS];
+
+    for (uint8_t i = 0; i < SMALL_SIZE; i++)
+    {
+        in[i] = (uint8_t)(0x40 + i);
+    }
+
+    /* Head wraps to 0 in the middle of the copy, and the storage wraps. */
+    TEST_ASSERT_EQUAL_INT(ERR_OK, rbuffer_spsc_init(&rb, small_buf, SMALL_SIZE));
+    skip_to(&rb, (uint16_t)(0x10000UL - 6));
+    TEST_ASSERT_EQUAL_INT(ERR_OK, rbuffer_spsc_add_bytes(&rb, in, 10));
+    TEST_ASSERT_EQUAL_UINT16(10, rbuffer_spsc_used(&rb));
+    TEST_ASSERT_EQUAL_INT(ERR_RBUFFER_NOT_ENOUGH_SPACE, rbuffer_spsc_add_bytes(&rb, in, 7));
+    TEST_ASSERT_EQUAL_INT(ERR_OK, rbuffer_spsc_add_bytes(&rb, in + 10, 6));
+    TEST_ASSERT_TRUE(rbuffer_spsc_full(&rb));
+
+    TEST_ASSERT_EQUAL_INT(ERR_OK, rbuffer_spsc_peek(&rb, span));
+    TEST_ASSERT_EQUAL_UINT16(SMALL_SIZE, span[0].len + span[1].len);
+    TEST_ASSERT_EQUAL_UINT16(6, span[0].len);
+    TEST_ASSERT_EQUAL_MEMORY(in, span[0].ptr, span[0].len);
+    TEST_ASSERT_EQUAL_MEMORY(in + 6, span[1].ptr, span[1].len);
+
+    TEST_ASSERT_EQUAL_INT(ERR_RBUFFER_NOT_ENOUGH_DATA,
+                          rbuffer_spsc_get_bytes(&rb, out, SMALL_SIZE + 1));
+    TEST_ASSERT_EQUAL_INT(ERR_OK, rbuffer_spsc_get_bytes(&rb, out, SMALL_SIZE));
+    TEST_ASSERT_EQUAL_MEMORY(in, out, SMALL_SIZE);
+    TEST_ASSERT_TRUE(rbuffer_spsc_empty(&rb));
+
+    /* In-place write across the wrap. */
+    skip_to(&rb, (uint16_t)(0x10000UL - 3));
+    TEST_ASSERT_EQUAL_INT(ERR_OK, rbuffer_spsc_reserve(&rb, SMALL_SIZE, span));
+    memcpy(span[0].ptr, in, span[0].len);
+    memcpy(span[1].ptr, in + span[0].len, span[1].len);
+    TEST_ASSERT_EQUAL_INT(ERR_OK, rbuffer_spsc_commit(&rb, SMALL_SIZE));
+    TEST_ASSERT_EQUAL_INT(ERR_RBUFFER_FULL, rbuffer_spsc_reserve(&rb, 1, span));
+    TEST_ASSERT_EQUAL_INT(ERR_OK, rbuffer_spsc_consume(&rb, 5));
+    TEST_ASSERT_EQUAL_INT(ERR_OK, rbuffer_spsc_get_bytes(&rb, out, SMALL_SIZE - 5));
+    TEST_ASSERT_EQUAL_MEMORY(in + 5, out, SMALL_SIZE - 5);
+    TEST_ASSERT_EQUAL_UINT16((uint16_t)(SMALL_SIZE - 3), rb.tail);
+}
+
+/**
+ * @brief One host thread produces while this one consumes, each preempted
+ * anywhere. The 16 bit indexes wrap many times over the run; every byte
+ * must come out once, in order.
+ */
+static void test_two_thread_stress (void)
+{
+    pthread_t prod;
+    uint32_t got = 0;
+
+    TEST_ASSERT_EQUAL_INT(ERR_OK, rbuffer_spsc_init(&rb, stress_buf, STRESS_SIZE));
+    TEST_ASSERT_EQUAL_INT(0, pthread_create(&prod, NULL, producer, NULL));
+
+    while (got < STRESS_BYTES)
+    {
+        rbuffer_span_t span[RBUFFER_MAX_SPANS];
+        uint8_t out[8];
+        uint16_t used = rbuffer_spsc_used(&rb);
+
+        TEST_ASSERT_LESS_OR_EQUAL(STRESS_SIZE, used);
+        if (used == 0)
+        {
+            usleep(STRESS_WAIT_US);
+        }
+        else if ((got & 1) && (used >= sizeof(out)))
+        {
+            TEST_ASSERT_EQUAL_INT(ERR_OK, rbuffer_spsc_get_bytes(&rb, out, sizeof(out)));
+            for (uint8_t i = 0; i < sizeof(out); i++)
+            {
+                TEST_ASSERT_EQUAL_UINT8((uint8_t)got, out[i]);
+                got++;
+            }
+        }
+        else
+        {
+            uint16_t n = 0;
+
+            TEST_ASSERT_EQUAL_INT(ERR_OK, rbuffer_spsc_peek(&rb, span));
+            for (uint8_t s = 0; s < RBUFFER_MAX_SPANS; s++)
+            {
+                for (uint16_t i = 0; i < span[s].len; i++)
+                {
+                    TEST_ASSERT_EQUAL_UINT8((uint8_t)got, span[s].ptr[i]);
+                    got++;
+                    n++;
+                }
+            }
+            TEST_ASSERT_EQUAL_INT(ERR_OK, rbuffer_spsc_consume(&rb, n));
+        }
+    }
+
+    pthread_join(prod, NULL);
+    TEST_ASSERT_TRUE(rbuffer_spsc_empty(&rb));
+    TEST_ASSERT_EQUAL_UINT16((uint16_t)STRESS_BYTES, rb.head);
+}
+
+/*****************************************************************************
+ * Code                                                                      *
+ *****************************************************************************/
+
+int main (void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_init_rejects_bad_sizes);
+    RUN_TEST(test_full_and_empty_at_size);
+    RUN_TEST(test_full_and_empty_across_index_wrap);
+    RUN_TEST(test_bulk_calls_across_index_wrap);
+    RUN_TEST(test_two_thread_stress);
+    return UNITY_END();
+}
+
+/* end of file */
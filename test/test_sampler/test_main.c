@@ -0,0 +1,195 @@
+/*****************************************************************************
+ *                                                                           *
+ * \file test_main.c                                                         *
+ *                                                                           *
+ * \brief sampler: a slow consumer against the simulated timer ISR on a      *
+ * small stage rbuffer. The ISR overwrites records while they are parsed;   *
+ * samples come out whole and in order, every one is accounted for, and    *
+ * framing is never taken as lost.                                           *
+ *                                                                           *
+ *   pio test -e native -f test_sampler                                      *
+ *                                                                           *
+ * \author blackchacal <ribeiro.tonet@gmail.com>                             *
+ * \date Oct 17, 2026                                                        *
+ *                                                                           *
+ * \version 1.0 | \author blackchacal                                        *
+ * File creation.                                                            *
+ *                                                                           *
+ *****************************************************************************/
+
+/*****************************************************************************
+ * Includes                                                                  *
+ *****************************************************************************/
+
+/* --- Standard libraries -------------------- */
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+/* --- Arduino libraries -------------------- */
+#include <Arduino.h>
+
+/* --- Test framework -------------------- */
+#include <unity.h>
+
+/* --- Custom modules -------------------- */
+#include "rbuffer.h"
+#include "sampler.h"
+
+/*****************************************************************************
+ * Macros                                                                    *
+ *****************************************************************************/
+
+#define RATE_HZ             (10000UL)
+#define RUN_US              (2000000UL)
+
+/* A few records only, so the ISR keeps overwriting the oldest. */
+#define STAGE_SIZE          (128)
+
+/* The consumer takes a couple of records, then pauses up to that long:
+ * slower on average than the ISR fills the rbuffer. */
+#define CONSUMER_WAIT_US    (400)
+#define CONSUMER_BATCH      (2)
+
+/*****************************************************************************
+ * Static Variables                                                          *
+ *****************************************************************************/
+
+static uint8_t stage_buf[STAGE_SIZE];
+static rbuffer_t stage;
+
+/* Written by the ISR: one past the last reading taken. */
+static volatile uint32_t readings = 0;
+
+static uint32_t got = 0;
+static uint32_t first_seq = 0;
+static uint32_t last_value = 0;
+
+/*****************************************************************************
+ * Private Functions                                                         *
+ *****************************************************************************/
+
+/**
+ * @brief Sensor read, in the ISR: numbers the readings and varies their
+ * size, so records overwritten mid-parse do not line up with new ones. The
+ * other values check the first.
+ */
+static uint8_t numbered_read (int32_t * values, uint8_t max)
+{
+    uint8_t count = (uint8_t)(1 + readings % max);
+
+    values[0] = (int32_t)readings;
+    for (uint8_t i = 1; i < count; i++)
+    {
+        values[i] = (int32_t)(~readings ^ i);
+    }
+    readings++;
+
+    return count;
+}
+
+static void collect (const sampler_sample_t * samples, uint16_t count)
+{
+    for (uint16_t i = 0; i < count; i++)
+    {
+        uint32_t value = (uint32_t)samples[i].value[0];
+
+        TEST_ASSERT_EQUAL_UINT8(SAMPLER_SRC_TIMER, samples[i].src);
+        TEST_ASSERT_EQUAL_UINT8(1 + value % SAMPLER_MAX_VALUES, samples[i].count);
+        for (uint8_t j = 1; j < samples[i].count; j++)
+        {
+            TEST_ASSERT_EQUAL_UINT32(~value ^ j, (uint32_t)samples[i].value[j]);
+        }
+        TEST_ASSERT_EQUAL_UINT16((uint16_t)value, samples[i].seq);
+        if (got == 0)
+        {
+            first_seq = value;
+        }
+        else
+        {
+            TEST_ASSERT_GREATER_THAN(last_value, value);
+        }
+        last_value = value;
+        got++;
+    }
+}
+
+/**
+ * @brief Busy wait: the simulated interrupt then lands anywhere in the
+ * consumer, not only while it sleeps.
+ */
+static void spin (uint32_t us)
+{
+    uint32_t start = micros();
+
+    while ((uint32_t)(micros() - start) < us)
+    {
+    }
+}
+
+/*****************************************************************************
+ * Tests                                                                     *
+ *****************************************************************************/
+
+void setUp (void)
+{
+}
+
+void tearDown (void)
+{
+    sampler_stop();
+}
+
+/**
+ * @brief The consumer pauses at random between batches, so the ISR both
+ * drops records it never saw and overwrites the ones it is parsing.
+ */
+static void test_overruns_lose_whole_samples_only (void)
+{
+    sampler_stats_t stats;
+    uint32_t start = 0;
+
+    srand(14);
+    TEST_ASSERT_EQUAL_INT(ERR_OK, rbuffer_init(&stage, stage_buf, STAGE_SIZE,
+                                               RBUFFER_POLICY_OVERWRITE));
+    TEST_ASSERT_EQUAL_INT(ERR_OK, sampler_init(&stage, numbered_read));
+    TEST_ASSERT_EQUAL_INT(ERR_OK, sampler_start(RATE_HZ));
+
+    start = micros();
+    while ((uint32_t)(micros() - start) < RUN_US)
+    {
+        sampler_consume(collect, CONSUMER_BATCH);
+        spin((uint32_t)rand() % CONSUMER_WAIT_US);
+    }
+    sampler_stop();
+    while (sampler_consume(collect, 0xFFFF) > 0)
+    {
+    }
+
+    sampler_stats(&stats);
+    TEST_ASSERT_GREATER_THAN(0, rbuffer_overruns(&stage));
+    TEST_ASSERT_GREATER_THAN(0, stats.lost);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.resyncs);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.failed);
+    TEST_ASSERT_EQUAL_UINT32(readings, stats.ticks);
+    TEST_ASSERT_EQUAL_UINT32(stats.ticks, stats.pushed);
+    TEST_ASSERT_EQUAL_UINT32(got, stats.consumed);
+
+    /* Every reading was either handed out or counted lost, the last one
+     * included since the rbuffer was drained. */
+    TEST_ASSERT_EQUAL_UINT32(readings - 1, last_value);
+    TEST_ASSERT_EQUAL_UINT32(last_value + 1 - first_seq, got + stats.lost);
+}
+
+/*****************************************************************************
+ * Code                                                                      *
+ *****************************************************************************/
+
+int main (void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_overruns_lose_whole_samples_only);
+    return UNITY_END();
+}
+
+/* end of file */
@@ -0,0 +1,164 @@
+/*****************************************************************************
+ *                                                                           *
+ * \file test_main.c                                                         *
+ *                                                                           *
+ * \brief sched: run-time stats stay with the task that ran, when a one-shot *
+ * re-adds itself or a periodic task cancels itself and adds another.       *
+ *                                                                           *
+ *   pio test -e native -f test_sched                                        *
+ *                                                                           *
+ * \author blackchacal <ribeiro.tonet@gmail.com>                             *
+ * \date Oct 17, 2026                                                        *
+ *                                                                           *
+ * \version 1.0 | \author blackchacal                                        *
+ * File creation.                                                            *
+ *                                                                           *
+ *****************************************************************************/
+
+/*****************************************************************************
+ * Includes                                                                  *
+ *****************************************************************************/
+
+/* --- Standard libraries -------------------- */
+#include <stdint.h>
+#include <stdbool.h>
+
+/* --- Arduino libraries -------------------- */
+#include <Arduino.h>
+
+/* --- Test framework -------------------- */
+#include <unity.h>
+
+/* --- Custom modules -------------------- */
+#include "sched.h"
+
+/*****************************************************************************
+ * Macros                                                                    *
+ *****************************************************************************/
+
+/* Far enough out that the added task does not run in the same sched_run. */
+#define LATER_US            (1000000UL)
+#define PERIOD_US           (1000UL)
+
+/*****************************************************************************
+ * Static Variables                                                          *
+ *****************************************************************************/
+
+static uint8_t self_id = 0;
+static uint8_t added_id = 0;
+static int added_err = ERR_OK;
+static uint32_t calls = 0;
+
+/*****************************************************************************
+ * Private Functions                                                         *
+ *****************************************************************************/
+
+static void noop (void * arg)
+{
+    (void)arg;
+    calls++;
+}
+
+/**
+ * @brief One-shot that schedules its next run, as a retry would.
+ */
+static void readd_self (void * arg)
+{
+    (void)arg;
+    calls++;
+    added_err = sched_add("again", readd_self, NULL, 0, LATER_US, &added_id);
+    delayMicroseconds(50);
+}
+
+/**
+ * @brief Periodic task that hands over to a one-shot and stops.
+ */
+static void hand_over (void * arg)
+{
+    (void)arg;
+    calls++;
+    TEST_ASSERT_EQUAL_INT(ERR_OK, sched_cancel(self_id));
+    added_err = sched_add("next", noop, NULL, 0, LATER_US, &added_id);
+    delayMicroseconds(50);
+}
+
+/*****************************************************************************
+ * Tests                                                                     *
+ *****************************************************************************/
+
+void setUp (void)
+{
+    sched_init();
+    calls = 0;
+    added_err = ERR_OK;
+}
+
+void tearDown (void)
+{
+}
+
+static void test_one_shot_readding_itself_keeps_stats_apart (void)
+{
+    sched_stats_t stats;
+    uint8_t id = 0;
+
+    TEST_ASSERT_EQUAL_INT(ERR_OK, sched_add("once", readd_self, NULL, 0, 0, &self_id));
+    TEST_ASSERT_EQUAL_UINT8(1, sched_run());
+    TEST_ASSERT_EQUAL_UINT32(1, calls);
+
+    /* The new task got its own slot and nothing of the run. */
+    TEST_ASSERT_EQUAL_INT(ERR_OK, added_err);
+    TEST_ASSERT_NOT_EQUAL(self_id, added_id);
+    TEST_ASSERT_EQUAL_INT(ERR_OK, sched_stats(added_id, &stats));
+    TEST_ASSERT_EQUAL_UINT32(0, stats.runs);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.run_max);
+
+    /* Once the run is over its slot is free again, and starts clean. */
+    TEST_ASSERT_EQUAL_INT(ERR_OK, sched_add("other", noop, NULL, PERIOD_US, LATER_US, &id));
+    TEST_ASSERT_EQUAL_UINT8(self_id, id);
+    TEST_ASSERT_EQUAL_INT(ERR_OK, sched_stats(id, &stats));
+    TEST_ASSERT_EQUAL_UINT32(0, stats.runs);
+}
+
+static void test_periodic_cancelling_itself_keeps_stats_apart (void)
+{
+    sched_stats_t stats;
+
+    TEST_ASSERT_EQUAL_INT(ERR_OK, sched_add("periodic", hand_over, NULL, PERIOD_US, 0, &self_id));
+    TEST_ASSERT_EQUAL_UINT8(1, sched_run());
+
+    TEST_ASSERT_EQUAL_INT(ERR_OK, added_err);
+    TEST_ASSERT_NOT_EQUAL(self_id, added_id);
+    TEST_ASSERT_EQUAL_INT(ERR_OK, sched_stats(added_id, &stats));
+    TEST_ASSERT_EQUAL_UINT32(0, stats.runs);
+    TEST_ASSERT_EQUAL_INT(ERR_SCHED_INVALID_TASK, sched_cancel(self_id));
+}
+
+static void test_periodic_stats_count_each_run (void)
+{
+    sched_stats_t stats;
+
+    TEST_ASSERT_EQUAL_INT(ERR_OK, sched_add("periodic", noop, NULL, PERIOD_US, 0, &self_id));
+    while (calls < 3)
+    {
+        sched_run();
+        delayMicroseconds(100);
+    }
+    TEST_ASSERT_EQUAL_INT(ERR_OK, sched_stats(self_id, &stats));
+    TEST_ASSERT_EQUAL_UINT32(3, stats.runs);
+}
+
+/*****************************************************************************
+ * Code                                                                      *
+ *****************************************************************************/
+
+int main (void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_one_shot_readding_itself_keeps_stats_apart);
+    RUN_TEST(test_periodic_cancelling_itself_keeps_stats_apart);
+    RUN_TEST(test_periodic_stats_count_each_run);
+    return UNITY_END();
+}
+
+/* end of file */
@@ -0,0 +1,289 @@
+/*****************************************************************************
+ *                                                                           *
+ * \file test_main.c                                                         *
+ *                                                                           *
+ * \brief SHT3x driver on the native mock bus: two sensors sharing it,       *
+ * overlapping their conversions, and failures kept to one sensor.           *
+ *                                                                           *
+ *   pio test -e native -f test_sensor_sht3x                                 *
+ *                                                                           *
+ * \author blackchacal <ribeiro.tonet@gmail.com>                             *
+ * \date Oct 17, 2026                                                        *
+ *                                                                           *
+ * \version 1.0 | \author blackchacal                                        *
+ * File creation.                                                            *
+ *                                                                           *
+ *****************************************************************************/
+
+/*****************************************************************************
+ * Includes                                                                  *
+ *****************************************************************************/
+
+/* --- Standard libraries -------------------- */
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+/* --- Arduino libraries -------------------- */
+#include <Arduino.h>
+
+/* --- Test framework -------------------- */
+#include <unity.h>
+
+/* --- Custom modules -------------------- */
+#include "rbuffer.h"
+#include "sampler.h"
+#include "i2c_bus.h"
+#include "sensor.h"
+#include "sensor_sht3x.h"
+
+/*****************************************************************************
+ * Macros                                                                    *
+ *****************************************************************************/
+
+#define SRC_A               (1)
+#define SRC_B               (2)
+#define SRC_BAD_CRC         (3)
+#define SRC_ABSENT          (4)
+
+#define ADDR_BAD_CRC        (0x46)
+#define ADDR_ABSENT         (0x47)
+
+#define PERIOD_US           (40000UL)
+#define READS               (3)
+#define RUN_LIMIT_US        (1000000UL)
+
+/* Longest a single sensor_poll may take: it must never wait on the bus. */
+#define POLL_MAX_US         (1000UL)
+
+#define STAGE_SIZE          (1024)
+
+/*****************************************************************************
+ * Static Variables                                                          *
+ *****************************************************************************/
+
+static const uint8_t cmd_measure[] = {0x24, 0x00};
+
+/* Raw readings, CRCs filled in by main. */
+static uint8_t reply_a[6] = {0x66, 0x66, 0, 0x80, 0x00, 0};   /* 25.00 C, 50.00 % */
+static uint8_t reply_b[6] = {0x40, 0x00, 0, 0x20, 0x00, 0};   /* -1.25 C, 12.50 % */
+static uint8_t reply_bad[6] = {0x40, 0x00, 0, 0x20, 0x00, 0};
+
+static const i2c_mock_step_t steps_a[] = {
+    {cmd_measure, sizeof(cmd_measure), NULL, 0},
+    {NULL, 0, reply_a, sizeof(reply_a)},
+};
+static const i2c_mock_step_t steps_b[] = {
+    {cmd_measure, sizeof(cmd_measure), NULL, 0},
+    {NULL, 0, reply_b, sizeof(reply_b)},
+};
+static const i2c_mock_step_t steps_bad[] = {
+    {cmd_measure, sizeof(cmd_measure), NULL, 0},
+    {NULL, 0, reply_bad, sizeof(reply_bad)},
+};
+
+static uint8_t stage_buf[STAGE_SIZE];
+static rbuffer_t stage;
+
+/* Sensors are never removed: A and B keep running in the later tests. */
+static sensor_t sensor_a;
+static sensor_t sensor_b;
+static sensor_t sensor_bad;
+static sensor_t sensor_absent;
+
+/* Samples taken out of the stream, per source. */
+static uint32_t got[8];
+static int32_t got_value[8][2];
+
+/*****************************************************************************
+ * Private Functions                                                         *
+ *****************************************************************************/
+
+static uint8_t crc8 (const uint8_t * data)
+{
+    uint8_t crc = 0xFF;
+
+    for (uint8_t i = 0; i < 2; i++)
+    {
+        crc ^= data[i];
+        for (uint8_t bit = 0; bit < 8; bit++)
+        {
+            crc = (uint8_t)((crc & 0x80) ? ((crc << 1) ^ 0x31) : (crc << 1));
+        }
+    }
+
+    return crc;
+}
+
+static void seal (uint8_t * reply)
+{
+    reply[2] = crc8(&reply[0]);
+    reply[5] = crc8(&reply[3]);
+}
+
+/**
+ * @brief Sensor read for the timer ISR, which these tests never start.
+ */
+static uint8_t no_read (int32_t * values, uint8_t max)
+{
+    (void)values;
+    (void)max;
+
+    return 0;
+}
+
+static void collect (const sampler_sample_t * samples, uint16_t count)
+{
+    for (uint16_t i = 0; i < count; i++)
+    {
+        uint8_t src = samples[i].src & 0x07;
+
+        TEST_ASSERT_EQUAL_UINT8(2, samples[i].count);
+        got[src]++;
+        got_value[src][0] = samples[i].value[0];
+        got_value[src][1] = samples[i].value[1];
+    }
+}
+
+/**
+ * @brief Polls like the sensor task until every sensor given has done
+ * reads readings or the limit passes. Returns the longest poll, in us.
+ */
+static uint32_t run_until (sensor_t * const * sensors, uint8_t n, uint32_t reads)
+{
+    uint32_t start = micros();
+    uint32_t longest = 0;
+    bool done = false;
+
+    while (!done && ((uint32_t)(micros() - start) < RUN_LIMIT_US))
+    {
+        uint32_t t = micros();
+
+        sensor_poll();
+        t = micros() - t;
+        if (t > longest)
+        {
+            longest = t;
+        }
+
+        done = true;
+        for (uint8_t i = 0; i < n; i++)
+        {
+            if ((sensors[i]->reads + sensors[i]->errors) < reads)
+            {
+                done = false;
+            }
+        }
+        delayMicroseconds(100);
+    }
+    sampler_consume(collect, 0xFFFF);
+
+    return longest;
+}
+
+/*****************************************************************************
+ * Tests                                                                     *
+ *****************************************************************************/
+
+void setUp (void)
+{
+    memset(got, 0, sizeof(got));
+    memset(got_value, 0, sizeof(got_value));
+}
+
+void tearDown (void)
+{
+}
+
+/**
+ * @brief Both sensors start together: their commands queue on the bus, the
+ * conversions run side by side and the first readings of both arrive
+ * within one conversion time, not two.
+ */
+static void test_two_sensors_share_the_bus (void)
+{
+    sensor_t * const both[] = {&sensor_a, &sensor_b};
+    uint32_t start = micros();
+
+    TEST_ASSERT_EQUAL_INT(ERR_OK, sensor_add(&sensor_a, &sensor_sht3x, SHT3X_ADDR_A, SRC_A, PERIOD_US));
+    TEST_ASSERT_EQUAL_INT(ERR_OK, sensor_add(&sensor_b, &sensor_sht3x, SHT3X_ADDR_B, SRC_B, PERIOD_US));
+
+    TEST_ASSERT_LESS_THAN(POLL_MAX_US, run_until(both, 2, 1));
+    TEST_ASSERT_EQUAL_UINT32(1, sensor_a.reads);
+    TEST_ASSERT_EQUAL_UINT32(1, sensor_b.reads);
+    TEST_ASSERT_LESS_THAN(2 * SHT3X_CONVERSION_US, micros() - start);
+
+    TEST_ASSERT_LESS_THAN(POLL_MAX_US, run_until(both, 2, READS));
+
+    TEST_ASSERT_EQUAL_UINT32(0, sensor_a.errors);
+    TEST_ASSERT_EQUAL_UINT32(0, sensor_b.errors);
+    TEST_ASSERT_EQUAL_INT32(2500, sensor_a.value[0]);
+    TEST_ASSERT_EQUAL_INT32(5000, sensor_a.value[1]);
+    TEST_ASSERT_EQUAL_INT32(-125, sensor_b.value[0]);
+    TEST_ASSERT_EQUAL_INT32(1250, sensor_b.value[1]);
+
+    /* Every reading reached the sample stream under its own source. */
+    TEST_ASSERT_EQUAL_UINT32(sensor_a.reads, got[SRC_A]);
+    TEST_ASSERT_EQUAL_UINT32(sensor_b.reads, got[SRC_B]);
+    TEST_ASSERT_EQUAL_INT32(-125, got_value[SRC_B][0]);
+    TEST_ASSERT_EQUAL_INT32(5000, got_value[SRC_A][1]);
+}
+
+/**
+ * @brief A sensor with a corrupt reply and one that is not there only
+ * count their own errors; A and B, on the same bus, keep reading.
+ */
+static void test_failures_stay_with_their_sensor (void)
+{
+    sensor_t * const all[] = {&sensor_bad, &sensor_absent, &sensor_a, &sensor_b};
+    uint32_t reads_a = sensor_a.reads;
+    uint32_t reads_b = sensor_b.reads;
+
+    TEST_ASSERT_EQUAL_INT(ERR_OK, sensor_add(&sensor_bad, &sensor_sht3x, ADDR_BAD_CRC,
+                                             SRC_BAD_CRC, PERIOD_US));
+    TEST_ASSERT_EQUAL_INT(ERR_OK, sensor_add(&sensor_absent, &sensor_sht3x, ADDR_ABSENT,
+                                             SRC_ABSENT, PERIOD_US));
+
+    TEST_ASSERT_LESS_THAN(POLL_MAX_US, run_until(all, 2, READS));
+
+    TEST_ASSERT_EQUAL_UINT32(0, sensor_bad.reads);
+    TEST_ASSERT_GREATER_OR_EQUAL(READS, sensor_bad.errors);
+    TEST_ASSERT_EQUAL_INT(ERR_SENSOR_CRC, sensor_bad.last_err);
+    TEST_ASSERT_EQUAL_UINT32(0, sensor_absent.reads);
+    TEST_ASSERT_GREATER_OR_EQUAL(READS, sensor_absent.errors);
+    TEST_ASSERT_EQUAL_INT(ERR_I2C_NACK, sensor_absent.last_err);
+
+    TEST_ASSERT_EQUAL_UINT32(0, sensor_a.errors);
+    TEST_ASSERT_EQUAL_UINT32(0, sensor_b.errors);
+    TEST_ASSERT_GREATER_THAN(reads_a, sensor_a.reads);
+    TEST_ASSERT_GREATER_THAN(reads_b, sensor_b.reads);
+    TEST_ASSERT_EQUAL_UINT32(sensor_a.reads - reads_a, got[SRC_A]);
+    TEST_ASSERT_EQUAL_UINT32(0, got[SRC_BAD_CRC]);
+    TEST_ASSERT_EQUAL_UINT32(0, got[SRC_ABSENT]);
+}
+
+/*****************************************************************************
+ * Code                                                                      *
+ *****************************************************************************/
+
+int main (void)
+{
+    seal(reply_a);
+    seal(reply_b);
+    seal(reply_bad);
+    reply_bad[5] ^= 0x01;
+
+    rbuffer_init(&stage, stage_buf, STAGE_SIZE, RBUFFER_POLICY_OVERWRITE);
+    sampler_init(&stage, no_read);
+    i2c_bus_init(I2C_BUS_CLOCK_HZ);
+    i2c_mock_device(SHT3X_ADDR_A, steps_a, 2);
+    i2c_mock_device(SHT3X_ADDR_B, steps_b, 2);
+    i2c_mock_device(ADDR_BAD_CRC, steps_bad, 2);
+
+    UNITY_BEGIN();
+    RUN_TEST(test_two_sensors_share_the_bus);
+    RUN_TEST(test_failures_stay_with_their_sensor);
+    return UNITY_END();
+}
+
+/* end of file */
@@ -0,0 +1,288 @@
+/*****************************************************************************
+ *                                                                           *
+ * \file test_main.c                                                         *
+ *                                                                           *
+ * \brief tscodec: encode/decode round trips at the edges of the format,     *
+ * INT32 extremes, seq gaps and both ways a block fills up.                  *
+ *                                                                           *
+ *   pio test -e native -f test_tscodec                                      *
+ *                                                                           *
+ * \author blackchacal <ribeiro.tonet@gmail.com>                             *
+ * \date Oct 17, 2026                                                        *
+ *                                                                           *
+ * \version 1.0 | \author blackchacal                                        *
+ * File creation.                                                            *
+ *                                                                           *
+ *****************************************************************************/
+
+/*****************************************************************************
+ * Includes                                                                  *
+ *****************************************************************************/
+
+/* --- Standard libraries -------------------- */
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+/* --- Test framework -------------------- */
+#include <unity.h>
+
+/* --- Custom modules -------------------- */
+#include "tscodec.h"
+
+/*****************************************************************************
+ * Macros                                                                    *
+ *****************************************************************************/
+
+#define MAX_SAMPLES         (300)
+
+/* Big enough that the one byte count, not the space, ends the block. */
+#define BIG_BLOCK           (1024)
+
+/*****************************************************************************
+ * Static Variables                                                          *
+ *****************************************************************************/
+
+static uint8_t block[BIG_BLOCK];
+static tsc_enc_t enc;
+static sampler_sample_t in[MAX_SAMPLES];
+
+/*****************************************************************************
+ * Private Functions                                                         *
+ *****************************************************************************/
+
+static sampler_sample_t sample (uint8_t src, uint16_t seq, uint32_t ts, uint8_t count,
+                                int32_t v0, int32_t v1, int32_t v2, int32_t v3)
+{
+    sampler_sample_t s;
+
+    memset(&s, 0, sizeof(s));
+    s.src = src;
+    s.seq = seq;
+    s.ts_us = ts;
+    s.count = count;
+    s.value[0] = v0;
+    s.value[1] = v1;
+    s.value[2] = v2;
+    s.value[3] = v3;
+
+    return s;
+}
+
+/**
+ * @brief Encodes n samples into one block of size bytes, all of which must
+ * fit.
+ */
+static void encode_all (const sampler_sample_t * s, uint16_t n, uint16_t size)
+{
+    TEST_ASSERT_EQUAL_INT(ERR_OK, tsc_enc_init(&enc, block, size));
+    for (uint16_t i = 0; i < n; i++)
+    {
+        TEST_ASSERT_EQUAL_INT(ERR_OK, tsc_enc_add(&enc, &s[i]));
+    }
+}
+
+/**
+ * @brief Decodes the current block and checks it holds exactly s[0..n).
+ */
+static void check_block (const sampler_sample_t * s, uint16_t n)
+{
+    tsc_dec_t dec;
+    sampler_sample_t out;
+
+    TEST_ASSERT_EQUAL_INT(ERR_OK, tsc_dec_init(&dec, block, tsc_enc_len(&enc)));
+    for (uint16_t i = 0; i < n; i++)
+    {
+        TEST_ASSERT_EQUAL_INT(ERR_OK, tsc_dec_next(&dec, &out));
+        TEST_ASSERT_EQUAL_UINT8(s[i].src, out.src);
+        TEST_ASSERT_EQUAL_UINT16(s[i].seq, out.seq);
+        TEST_ASSERT_EQUAL_UINT32(s[i].ts_us, out.ts_us);
+        TEST_ASSERT_EQUAL_UINT8(s[i].count, out.count);
+        for (uint8_t v = 0; v < s[i].count; v++)
+        {
+            TEST_ASSERT_EQUAL_INT32(s[i].value[v], out.value[v]);
+        }
+    }
+    TEST_ASSERT_EQUAL_INT(ERR_TSC_END, tsc_dec_next(&dec, &out));
+}
+
+/*****************************************************************************
+ * Tests                                                                     *
+ *****************************************************************************/
+
+void setUp (void)
+{
+    memset(block, 0, sizeof(block));
+}
+
+void tearDown (void)
+{
+}
+
+static void test_steady_stream_is_small (void)
+{
+    for (uint16_t i = 0; i < 20; i++)
+    {
+        in[i] = sample(0, (uint16_t)(100 + i), 5000 + 10000UL * i, 2, 2315 + (i & 1), -40, 0, 0);
+    }
+    encode_all(in, 20, TSC_BLOCK_SIZE);
+    check_block(in, 20);
+
+    /* Steady rate, small steps: head, ts and two values, one byte each. */
+    TEST_ASSERT_EQUAL_UINT16(TSC_HDR_SIZE + 5 + 2 + 19 * 4, tsc_enc_len(&enc));
+}
+
+static void test_int32_extremes_round_trip (void)
+{
+    uint16_t n = 0;
+
+    in[n++] = sample(1, 0, 0, 4, INT32_MIN, INT32_MAX, 0, -1);
+    in[n++] = sample(1, 1, 1, 4, INT32_MAX, INT32_MIN, -1, 0);
+    in[n++] = sample(1, 2, 2, 4, INT32_MIN, INT32_MIN, INT32_MAX, INT32_MAX);
+    in[n++] = sample(1, 3, 3, 4, 0, 0, INT32_MIN, 1);
+    in[n++] = sample(1, 4, 4, 4, INT32_MAX, -1, 1, INT32_MIN);
+    /* Another source starts from 0 again, its history is separate. */
+    in[n++] = sample(2, 5, 5, 1, INT32_MIN, 0, 0, 0);
+    in[n++] = sample(1, 6, 6, 4, INT32_MAX, INT32_MAX, INT32_MAX, INT32_MAX);
+
+    encode_all(in, n, TSC_BLOCK_SIZE);
+    check_block(in, n);
+}
+
+static void test_timestamp_extremes_round_trip (void)
+{
+    uint16_t n = 0;
+
+    /* The clock wraps inside the block, and intervals swing by 2^31. */
+    in[n++] = sample(0, 0, 0xFFFFFF00UL, 1, 1, 0, 0, 0);
+    in[n++] = sample(0, 1, 0xFFFFFFFFUL, 1, 2, 0, 0, 0);
+    in[n++] = sample(0, 2, 0x00000010UL, 1, 3, 0, 0, 0);
+    in[n++] = sample(0, 3, 0x80000010UL, 1, 4, 0, 0, 0);
+    in[n++] = sample(0, 4, 0x80000011UL, 1, 5, 0, 0, 0);
+    in[n++] = sample(3, 5, 0x00000000UL, 1, 6, 0, 0, 0);
+    in[n++] = sample(0, 6, 0x7FFFFFFFUL, 1, 7, 0, 0, 0);
+
+    encode_all(in, n, TSC_BLOCK_SIZE);
+    check_block(in, n);
+}
+
+static void test_seq_gaps_round_trip (void)
+{
+    uint16_t n = 0;
+
+    in[n++] = sample(0, 65530, 0, 1, 0, 0, 0, 0);
+    in[n++] = sample(0, 65531, 10, 1, 0, 0, 0, 0);
+    in[n++] = sample(0, 65535, 20, 1, 0, 0, 0, 0);     /* Gap of 3. */
+    in[n++] = sample(0, 0, 30, 1, 0, 0, 0, 0);         /* Wraps, no gap. */
+    in[n++] = sample(0, 2, 40, 1, 0, 0, 0, 0);         /* Gap across nothing. */
+    in[n++] = sample(0, 32770, 50, 1, 0, 0, 0, 0);     /* Largest forward gap. */
+    in[n++] = sample(0, 32769, 60, 1, 0, 0, 0, 0);     /* Goes back: wraps the gap. */
+    in[n++] = sample(0, 32770, 70, 1, 0, 0, 0, 0);
+
+    encode_all(in, n, TSC_BLOCK_SIZE);
+    check_block(in, n);
+}
+
+static void test_full_block_keeps_it_unchanged (void)
+{
+    sampler_sample_t big = sample(4, 0, 0, 4, INT32_MIN, INT32_MAX, INT32_MIN, INT32_MAX);
+    uint16_t n = 0;
+    uint16_t len = 0;
+    int err = ERR_OK;
+
+    TEST_ASSERT_EQUAL_INT(ERR_OK, tsc_enc_init(&enc, block, TSC_BLOCK_SIZE));
+    while (n < MAX_SAMPLES)
+    {
+        big.seq = (uint16_t)(n * 1000);
+        big.ts_us = 0x9E3779B9UL * n;
+        big.value[0] = -big.value[0] - 1;
+        in[n] = big;
+        len = tsc_enc_len(&enc);
+        err = tsc_enc_add(&enc, &big);
+        if (err != ERR_OK)
+        {
+            break;
+        }
+        n++;
+    }
+
+    /* The sample that did not fit left the block as it was. */
+    TEST_ASSERT_EQUAL_INT(ERR_TSC_FULL, err);
+    TEST_ASSERT_GREATER_THAN(0, n);
+    TEST_ASSERT_EQUAL_UINT16(len, tsc_enc_len(&enc));
+    TEST_ASSERT_LESS_OR_EQUAL(TSC_BLOCK_SIZE, len);
+    TEST_ASSERT_GREATER_THAN(TSC_BLOCK_SIZE - TSC_SAMPLE_MAX, len);
+    check_block(in, n);
+
+    /* It starts the next block. */
+    tsc_enc_reset(&enc);
+    TEST_ASSERT_EQUAL_INT(ERR_OK, tsc_enc_add(&enc, &in[n]));
+    check_block(&in[n], 1);
+}
+
+static void test_count_limit_ends_block (void)
+{
+    uint16_t n = 0;
+
+    for (n = 0; n < 255; n++)
+    {
+        in[n] = sample(5, n, 1000UL * n, 1, n, 0, 0, 0);
+    }
+    encode_all(in, 255, BIG_BLOCK);
+    TEST_ASSERT_EQUAL_HEX8(0xFF, block[1]);
+    TEST_ASSERT_LESS_THAN(BIG_BLOCK - TSC_SAMPLE_MAX, tsc_enc_len(&enc));
+
+    /* Room left, but the count byte is at its limit. */
+    in[255] = sample(5, 255, 255000UL, 1, 255, 0, 0, 0);
+    TEST_ASSERT_EQUAL_INT(ERR_TSC_FULL, tsc_enc_add(&enc, &in[255]));
+    check_block(in, 255);
+}
+
+static void test_bad_input_is_refused (void)
+{
+    sampler_sample_t s = sample(TSC_SOURCES, 0, 0, 1, 0, 0, 0, 0);
+    tsc_dec_t dec;
+    sampler_sample_t out;
+
+    TEST_ASSERT_EQUAL_INT(ERR_TSC_FULL, tsc_enc_init(&enc, block, TSC_HDR_SIZE + TSC_SAMPLE_MAX - 1));
+    TEST_ASSERT_EQUAL_INT(ERR_OK, tsc_enc_init(&enc, block, TSC_BLOCK_SIZE));
+    TEST_ASSERT_EQUAL_INT(ERR_TSC_INVALID_SAMPLE, tsc_enc_add(&enc, &s));
+    s.src = 0;
+    s.count = 0;
+    TEST_ASSERT_EQUAL_INT(ERR_TSC_INVALID_SAMPLE, tsc_enc_add(&enc, &s));
+    s.count = SAMPLER_MAX_VALUES + 1;
+    TEST_ASSERT_EQUAL_INT(ERR_TSC_INVALID_SAMPLE, tsc_enc_add(&enc, &s));
+    TEST_ASSERT_EQUAL_UINT16(0, tsc_enc_len(&enc));
+
+    /* A block cut short, or with a sample too many, is corrupt. */
+    s.count = 1;
+    s.value[0] = INT32_MIN;
+    TEST_ASSERT_EQUAL_INT(ERR_OK, tsc_enc_add(&enc, &s));
+    TEST_ASSERT_EQUAL_INT(ERR_OK, tsc_dec_init(&dec, block, (uint16_t)(tsc_enc_len(&enc) - 1)));
+    TEST_ASSERT_EQUAL_INT(ERR_TSC_CORRUPT, tsc_dec_next(&dec, &out));
+    block[1] = 2;
+    TEST_ASSERT_EQUAL_INT(ERR_OK, tsc_dec_init(&dec, block, tsc_enc_len(&enc)));
+    TEST_ASSERT_EQUAL_INT(ERR_OK, tsc_dec_next(&dec, &out));
+    TEST_ASSERT_EQUAL_INT(ERR_TSC_CORRUPT, tsc_dec_next(&dec, &out));
+    block[0] = 0;
+    TEST_ASSERT_EQUAL_INT(ERR_TSC_CORRUPT, tsc_dec_init(&dec, block, tsc_enc_len(&enc)));
+}
+
+/*****************************************************************************
+ * Code                                                                      *
+ *****************************************************************************/
+
+int main (void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_steady_stream_is_small);
+    RUN_TEST(test_int32_extremes_round_trip);
+    RUN_TEST(test_timestamp_extremes_round_trip);
+    RUN_TEST(test_seq_gaps_round_trip);
+    RUN_TEST(test_full_block_keeps_it_unchanged);
+    RUN_TEST(test_count_limit_ends_block);
+    RUN_TEST(test_bad_input_is_refused);
+    return UNITY_END();
+}
+
+/* end of file */
@@ -0,0 +1,290 @@
+/*****************************************************************************
+ *                                                                           *
+ * \file test_main.c                                                         *
+ *                                                                           *
+ * \brief uplink: frames received on a local UDP socket, as                  *
+ * tools/uplink_rx.py receives them. Checks the frame format, CRC and       *
+ * sequence, that records come out whole and in order, and when frames are  *
+ * sent.                                                                     *
+ *                                                                           *
+ *   pio test -e native -f test_uplink                                       *
+ *                                                                           *
+ * \author blackchacal <ribeiro.tonet@gmail.com>                             *
+ * \date Oct 17, 2026                                                        *
+ *                                                                           *
+ * \version 1.0 | \author blackchacal                                        *
+ * File creation.                                                            *
+ *                                                                           *
+ *****************************************************************************/
+
+/*****************************************************************************
+ * Includes                                                                  *
+ *****************************************************************************/
+
+/* --- Standard libraries -------------------- */
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+
+/* --- Arduino libraries -------------------- */
+#include <Arduino.h>
+
+/* --- Test framework -------------------- */
+#include <unity.h>
+
+/* --- Custom modules -------------------- */
+#include "rbuffer.h"
+#include "rrecord.h"
+#include "uplink.h"
+
+/*****************************************************************************
+ * Macros                                                                    *
+ *****************************************************************************/
+
+#define RB_SIZE             (4096)
+#define REC_LEN_MAX         (200)
+
+/* Records of 40 to 199 bytes: about three frames, and within RB_SIZE. */
+#define BULK_RECORDS        (25)
+
+/*****************************************************************************
+ * Static Variables                                                          *
+ *****************************************************************************/
+
+static uint8_t rb_buf[RB_SIZE];
+static rbuffer_t rb;
+static int rx_sock = -1;
+
+/* Receiver state. */
+/* One byte spare, to see a frame over UPLINK_FRAME_SIZE. */
+static uint8_t frame[UPLINK_FRAME_SIZE + 1];
+static uint32_t next_seq = 0;
+static uint32_t next_id = 0;
+
+/*****************************************************************************
+ * Private Functions                                                         *
+ *****************************************************************************/
+
+static uint16_t record_len (uint32_t id)
+{
+    return (uint16_t)(40 + (id * 13U) % (REC_LEN_MAX - 40));
+}
+
+static void record_push (uint32_t id)
+{
+    uint8_t data[REC_LEN_MAX];
+    uint16_t len = record_len(id);
+
+    memcpy(data, &id, 4);
+    for (uint16_t i = 4; i < len; i++)
+    {
+        data[i] = (uint8_t)(id + i);
+    }
+    TEST_ASSERT_EQUAL_INT(ERR_OK, rrecord_push(&rb, data, len));
+}
+
+/**
+ * @brief Bitwise CRC-16/CCITT-FALSE, written apart from uplink_crc16.
+ */
+static uint16_t crc16 (const uint8_t * data, uint16_t len)
+{
+    uint16_t crc = 0xFFFF;
+
+    for (uint16_t i = 0; i < len; i++)
+    {
+        for (uint8_t bit = 0; bit < 8; bit++)
+        {
+            bool top = ((crc >> 15) ^ (data[i] >> (7 - bit))) & 1;
+
+            crc = (uint16_t)(crc << 1);
+            if (top)
+            {
+                crc ^= 0x1021;
+            }
+        }
+    }
+
+    return crc;
+}
+
+/**
+ * @brief Receives one frame if there is one, checks it and every record in
+ * it. Returns the records it carried, -1 if none came.
+ */
+static int receive_frame (void)
+{
+    ssize_t n = recv(rx_sock, frame, sizeof(frame), 0);
+    uint32_t seq = 0;
+    uint16_t pos = UPLINK_HDR_SIZE;
+    uint16_t end = 0;
+    uint8_t count = 0;
+
+    if (n < 0)
+    {
+        return -1;
+    }
+
+    TEST_ASSERT_GREATER_OR_EQUAL(UPLINK_HDR_SIZE + UPLINK_CRC_SIZE, n);
+    TEST_ASSERT_LESS_OR_EQUAL(UPLINK_FRAME_SIZE, n);
+    end = (uint16_t)(n - UPLINK_CRC_SIZE);
+    TEST_ASSERT_EQUAL_HEX16(crc16(frame, end), (uint16_t)(frame[end] | (frame[end + 1] << 8)));
+    TEST_ASSERT_EQUAL_HEX8(UPLINK_MAGIC_0, frame[0]);
+    TEST_ASSERT_EQUAL_HEX8(UPLINK_MAGIC_1, frame[1]);
+    TEST_ASSERT_EQUAL_UINT8(UPLINK_VERSION, frame[2]);
+    count = frame[3];
+    memcpy(&seq, &frame[4], 4);
+    TEST_ASSERT_EQUAL_UINT32(next_seq, seq);
+    next_seq++;
+
+    TEST_ASSERT_GREATER_THAN(0, count);
+    for (uint8_t i = 0; i < count; i++)
+    {
+        uint32_t id = 0;
+        uint8_t len = 0;
+
+        TEST_ASSERT_LESS_THAN(end, pos);
+        len = frame[pos];
+        TEST_ASSERT_LESS_OR_EQUAL(end, pos + 1 + len);
+        memcpy(&id, &frame[pos + 1], 4);
+        TEST_ASSERT_EQUAL_UINT32(next_id, id);
+        TEST_ASSERT_EQUAL_UINT16(record_len(id), len);
+        for (uint16_t j = 4; j < len; j++)
+        {
+            TEST_ASSERT_EQUAL_HEX8((uint8_t)(id + j), frame[pos + 1 + j]);
+        }
+        next_id++;
+        pos = (uint16_t)(pos + 1 + len);
+    }
+    TEST_ASSERT_EQUAL_UINT16(end, pos);
+
+    return count;
+}
+
+/*****************************************************************************
+ * Tests                                                                     *
+ *****************************************************************************/
+
+void setUp (void)
+{
+    while (receive_frame() >= 0)
+    {
+    }
+    TEST_ASSERT_EQUAL_INT(ERR_OK, rbuffer_init(&rb, rb_buf, RB_SIZE, RBUFFER_POLICY_REJECT));
+    TEST_ASSERT_EQUAL_INT(ERR_OK, uplink_init(&rb));
+    next_seq = 0;
+    next_id = 0;
+}
+
+void tearDown (void)
+{
+}
+
+static void test_crc16_check_value (void)
+{
+    const uint8_t check[] = "123456789";
+
+    TEST_ASSERT_EQUAL_HEX16(0x29B1, uplink_crc16(check, 9));
+    TEST_ASSERT_EQUAL_HEX16(0x29B1, crc16(check, 9));
+}
+
+/**
+ * @brief A backlog goes out in full frames, records whole and in order,
+ * none split across frames.
+ */
+static void test_backlog_goes_out_in_full_frames (void)
+{
+    uplink_stats_t stats;
+    uint32_t bytes = 0;
+
+    for (uint32_t id = 0; id < BULK_RECORDS; id++)
+    {
+        record_push(id);
+        bytes += 1 + record_len(id);
+    }
+    TEST_ASSERT_GREATER_THAN(UPLINK_FRAME_SIZE, bytes);
+
+    /* Well past the fill level: sent on the first poll, no waiting. */
+    TEST_ASSERT_EQUAL_INT(ERR_OK, uplink_poll());
+    while (receive_frame() >= 0)
+    {
+    }
+    TEST_ASSERT_GREATER_OR_EQUAL(2, next_seq);
+
+    /* The tail, under the fill level, waits for its deadline. */
+    while (rbuffer_used(&rb) > 0)
+    {
+        TEST_ASSERT_EQUAL_INT(ERR_OK, uplink_poll());
+        delay(100);
+        while (receive_frame() >= 0)
+        {
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT32(BULK_RECORDS, next_id);
+
+    uplink_stats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(next_seq, stats.frames);
+    TEST_ASSERT_EQUAL_UINT32(BULK_RECORDS, stats.records);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.failed);
+}
+
+/**
+ * @brief A few records stay queued until the oldest has waited
+ * UPLINK_MAX_DELAY_US, then go out together in one frame.
+ */
+static void test_few_records_wait_for_the_deadline (void)
+{
+    uint32_t start = micros();
+
+    record_push(0);
+    record_push(1);
+    record_push(2);
+
+    while (rbuffer_used(&rb) > 0)
+    {
+        TEST_ASSERT_EQUAL_INT(ERR_OK, uplink_poll());
+        if (rbuffer_used(&rb) > 0)
+        {
+            TEST_ASSERT_LESS_THAN(0, receive_frame());
+            delay(10);
+        }
+    }
+    TEST_ASSERT_GREATER_OR_EQUAL(UPLINK_MAX_DELAY_US, micros() - start);
+    TEST_ASSERT_EQUAL_INT(3, receive_frame());
+    TEST_ASSERT_LESS_THAN(0, receive_frame());
+}
+
+/*****************************************************************************
+ * Code                                                                      *
+ *****************************************************************************/
+
+int main (void)
+{
+    struct sockaddr_in addr;
+    int failures = 0;
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(UPLINK_PORT);
+    inet_pton(AF_INET, UPLINK_HOST, &addr.sin_addr);
+    rx_sock = socket(AF_INET, SOCK_DGRAM, 0);
+    if ((rx_sock < 0) || (fcntl(rx_sock, F_SETFL, O_NONBLOCK) != 0) ||
+        (bind(rx_sock, (const struct sockaddr *)&addr, sizeof(addr)) != 0))
+    {
+        return 1;
+    }
+
+    UNITY_BEGIN();
+    RUN_TEST(test_crc16_check_value);
+    RUN_TEST(test_backlog_goes_out_in_full_frames);
+    RUN_TEST(test_few_records_wait_for_the_deadline);
+    failures = UNITY_END();
+    close(rx_sock);
+
+    return failures;
+}
+
+/* end of file */
@@ -0,0 +1,262 @@
+#!/usr/bin/env python3
+#
+# \file log_tokens.py
+#
+# \brief String table generator and decoder for tokenized binary logs.
+#
+# Scans the firmware sources for LOG_* call sites, computes the same token
+# as include/log_bin.h and writes a JSON string table. The decoder reads
+# frames (from a file, a serial port or stdin) and rebuilds the text lines.
+#
+#   log_tokens.py gen    [-o log_tokens.json] [src include ...]
+#   log_tokens.py decode [-t log_tokens.json] [-p /dev/ttyACM0 | file]
+#
+# Also usable as a PlatformIO extra script: it then writes log_tokens.json
+# to the build directory before every build.
+#
+# \author blackchacal <ribeiro.tonet@gmail.com>
+# \date Oct 17, 2026
+#
+
+import argparse
+import json
+import os
+import re
+import struct
+import sys
+
+SYNC = 0xA5
+TRUNCATED = 0x80
+LEVELS = ["INFO", "WARN", "DEBUG", "ERROR"]
+
+CALL_RE = re.compile(r'\b(?:LOG_(?:INFO|WARN|DEBUG|ERROR|ERROR_LOCK)|LOG_BIN_WRITE\s*\(\s*\w+\s*,)\s*\(?\s*'
+                     r'((?:"(?:\\.|[^"\\])*"\s*)+),\s*((?:"(?:\\.|[^"\\])*"\s*)+)')
+STR_RE = re.compile(r'"((?:\\.|[^"\\])*)"')
+SPEC_RE = re.compile(r'%([-+ #0]*)(\d+|\*)?(?:\.(\d+|\*))?(hh|h|ll|l|z|j|t)?([diuxXocsfFeEgGpk%])')
+
+
+# --- Token ------------------------------------------------------------------
+
+def fnv1a(data, h=2166136261):
+    for b in data:
+        h = ((h ^ b) * 16777619) & 0xFFFFFFFF
+    return h
+
+
+def token(tag, fmt):
+    h = fnv1a(tag.encode())
+    h = ((h ^ 0x1F) * 16777619) & 0xFFFFFFFF
+    return fnv1a(fmt.encode(), h)
+
+
+def c_literal(text):
+    """Joins adjacent C string literals and resolves escapes."""
+    raw = "".join(STR_RE.findall(text))
+    return raw.encode("latin-1").decode("unicode_escape")
+
+
+# --- Table generation -------------------------------------------------------
+
+def scan(paths):
+    table = {}
+    for root in paths:
+        for dirpath, _, files in os.walk(root):
+            for name in files:
+                if not name.endswith((".c", ".cpp", ".h", ".hpp")):
+                    continue
+                path = os.path.join(dirpath, name)
+                with open(path, encoding="utf-8", errors="replace") as f:
+                    src = f.read()
+                for m in CALL_RE.finditer(src):
+                    tag, fmt = c_literal(m.group(1)), c_literal(m.group(2))
+                    tok = token(tag, fmt)
+                    prev = table.get(tok)
+                    if prev and (prev["tag"], prev["fmt"]) != (tag, fmt):
+                        sys.stderr.write("log_tokens: token collision 0x%08x: %r vs %r\n"
+                                         % (tok, (prev["tag"], prev["fmt"]), (tag, fmt)))
+                    line = src.count("\n", 0, m.start()) + 1
+                    table[tok] = {"tag": tag, "fmt": fmt, "where": "%s:%d" % (path, line)}
+    return table
+
+
+def write_table(table, out):
+    data = {"%08x" % tok: entry for tok, entry in sorted(table.items())}
+    with open(out, "w") as f:
+        json.dump(data, f, indent=1, sort_keys=True)
+
+
+def load_table(path):
+    with open(path) as f:
+        return {int(k, 16): v for k, v in json.load(f).items()}
+
+
+# --- Decoding ---------------------------------------------------------------
+
+def varint(buf, pos):
+    value, shift = 0, 0
+    while True:
+        b = buf[pos]
+        pos += 1
+        value |= (b & 0x7F) << shift
+        shift += 7
+        if not b & 0x80:
+            return value, pos
+
+
+def zigzag(v):
+    return (v >> 1) ^ -(v & 1)
+
+
+def render(fmt, payload, pos):
+    """Formats fmt, pulling arguments from payload as the specifiers ask."""
+    out, last = [], 0
+    for m in SPEC_RE.finditer(fmt):
+        out.append(fmt[last:m.start()])
+        last = m.end()
+        flags, width, prec, length, conv = m.groups()
+        if conv == "%":
+            out.append("%")
+            continue
+        if pos >= len(payload):
+            out.append("<?>")
+            continue
+        if conv == "s":
+            n = payload[pos]
+            arg = payload[pos + 1:pos + 1 + n].decode("latin-1")
+            pos += 1 + n
+        elif conv in "fFeEgG":
+            arg = struct.unpack_from("<f", payload, pos)[0]
+            pos += 4
+        else:
+            raw, pos = varint(payload, pos)
+            arg = zigzag(raw)
+            bits = 64 if length in ("ll", "j") else 32
+            if conv in "dik":
+                arg = ((arg + (1 << (bits - 1))) % (1 << bits)) - (1 << (bits - 1))
+                if conv == "k":
+                    # Fixed point, see include/log_fmt.h.
+                    digits = int(prec or 0)
+                    sign = "-" if arg < 0 else ""
+                    whole, frac = divmod(abs(arg), 10 ** digits)
+                    text = str(whole) + ("." + str(frac).zfill(digits) if digits else "")
+                    if "0" in (flags or "") and "-" not in flags and width:
+                        text = text.zfill(int(width) - len(sign))
+                    out.append(("%" + (flags or "").replace("0", "") + (width or "") + "s") % (sign + text))
+                    continue
+            elif conv == "c":
+                arg = chr(arg & 0xFF)
+            else:
+                arg &= (1 << bits) - 1
+                if conv == "p":
+                    conv, flags = "x", (flags or "") + "#"
+        spec = "%" + (flags or "") + (width or "") + ("." + prec if prec else "") + \
+               ("d" if conv in "iu" else conv)
+        out.append(spec % arg)
+    out.append(fmt[last:])
+    return "".join(out)
+
+
+def frames(stream):
+    """Yields frame payloads, resynchronising on corrupt data."""
+    buf = bytearray()
+    while True:
+        chunk = stream.read(256)
+        if not chunk:
+            return
+        buf += chunk
+        while True:
+            start = buf.find(bytes([SYNC]))
+            if start < 0:
+                buf.clear()
+                break
+            del buf[:start]
+            if len(buf) < 2 or len(buf) < buf[1] + 3:
+                break
+            n = buf[1]
+            payload = bytes(buf[2:2 + n])
+            if n >= 6 and (sum(payload) & 0xFF) == buf[2 + n]:
+                yield payload
+                del buf[:n + 3]
+            else:
+                del buf[:1]
+
+
+def decode(table, stream, out):
+    for payload in frames(stream):
+        level = payload[0] & ~TRUNCATED
+        tok = struct.unpack_from("<I", payload, 1)[0]
+        ts, pos = varint(payload, 5)
+        entry = table.get(tok)
+        name = LEVELS[level] if level < len(LEVELS) else "L%d" % level
+        if entry is None:
+            text = "%s - ? | <unknown token 0x%08x>" % (name, tok)
+        else:
+            try:
+                body = render(entry["fmt"], payload, pos)
+            except (IndexError, struct.error):
+                body = entry["fmt"] + " <bad args>"
+            text = "%s - %s | %s" % (name, entry["tag"], body.rstrip("\n"))
+        if payload[0] & TRUNCATED:
+            text += " <truncated>"
+        out.write("[%10.3f] %s\n" % (ts / 1000.0, text))
+        out.flush()
+
+
+# --- Entry points -----------------------------------------------------------
+
+class SerialStream:
+    """Blocking reader over a serial port; read() only returns on data."""
+
+    def __init__(self, port, baud):
+        import serial
+        self.port = serial.Serial(port, baud, timeout=1)
+
+    def read(self, n):
+        data = b""
+        while not data:
+            data = self.port.read(n)
+        return data
+
+
+def main(argv):
+    ap = argparse.ArgumentParser(description=__doc__)
+    sub = ap.add_subparsers(dest="cmd", required=True)
+    g = sub.add_parser("gen", help="generate the string table")
+    g.add_argument("-o", "--output", default="log_tokens.json")
+    g.add_argument("paths", nargs="*", default=["src", "include", "lib"])
+    d = sub.add_parser("decode", help="decode a binary log stream")
+    d.add_argument("-t", "--table", default="log_tokens.json")
+    d.add_argument("-p", "--port", help="serial port (needs pyserial)")
+    d.add_argument("-b", "--baud", type=int, default=9600)
+    d.add_argument("input", nargs="?", help="capture file, default stdin")
+    args = ap.parse_args(argv)
+
+    if args.cmd == "gen":
+        table = scan(args.paths)
+        write_table(table, args.output)
+        print("log_tokens: %d call sites -> %s" % (len(table), args.output))
+        return 0
+
+    table = load_table(args.table)
+    if args.port:
+        stream = SerialStream(args.port, args.baud)
+    elif args.input:
+        stream = open(args.input, "rb")
+    else:
+        stream = sys.stdin.buffer
+    decode(table, stream, sys.stdout)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv[1:]))
+else:
+    try:
+        Import("env")  # noqa: F821 - provided by PlatformIO/SCons
+        _proj = env.subst("$PROJECT_DIR")  # noqa: F821
+        _build = env.subst("$BUILD_DIR")  # noqa: F821
+        os.makedirs(_build, exist_ok=True)
+        write_table(scan([os.path.join(_proj, p) for p in ("src", "include", "lib")]),
+                    os.path.join(_build, "log_tokens.json"))
+    except NameError:
+        pass
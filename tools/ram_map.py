@@ -0,0 +1,148 @@
+#!/usr/bin/env python3
+#
+# \file ram_map.py
+#
+# \brief Build-time RAM map per module.
+#
+# Reads the linker map and sums the .data and .bss input sections of every
+# object file, so the static RAM each module takes (include/meminfo.h has
+# the run-time side) shows after each build. Objects from an archive (the
+# Arduino core, libraries, libc) are summed per archive.
+#
+#   ram_map.py firmware.map [-n 20]
+#
+# As a PlatformIO post: script it asks the linker for the map and prints
+# the table after linking; it is also written to ram_map.txt in the build
+# directory.
+#
+# \author blackchacal <ribeiro.tonet@gmail.com>
+# \date Oct 17, 2026
+#
+
+import argparse
+import os
+import re
+import sys
+
+RAM_SECTIONS = (".data", ".bss")
+
+# " .bss.log_buf  0x20000abc  0x800 path/logger.cpp.o"; a long section
+# name puts the address, size and object on the next line.
+INPUT_RE = re.compile(r"^ (\S+)(?:\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(.+))?$")
+CONT_RE = re.compile(r"^\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(.+)$")
+OUTPUT_RE = re.compile(r"^(\.\S+)(?:\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+))?")
+MEMORY_RE = re.compile(r"^(\w+)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s*(\w*)$")
+ARCHIVE_RE = re.compile(r"^(.*?\.a)\((.*)\)$")
+
+
+def module(obj):
+    """Short module name of an object path."""
+    m = ARCHIVE_RE.match(obj.strip())
+    if m:
+        return os.path.basename(m.group(1))
+    name = os.path.basename(obj.strip())
+    return name[:-2] if name.endswith(".o") else name
+
+
+def parse(path):
+    """Returns ({module: [data, bss]}, {output section: size}, ram size)."""
+    modules, outputs, ram = {}, {}, 0
+    section, pending = None, None
+    in_memory = False
+
+    with open(path, encoding="utf-8", errors="replace") as f:
+        for line in f:
+            line = line.rstrip("\n")
+            if line.startswith("Memory Configuration"):
+                in_memory = True
+                continue
+            if in_memory:
+                if line.startswith("Linker script and memory map"):
+                    in_memory = False
+                m = MEMORY_RE.match(line)
+                if m and m.group(1).upper() == "RAM":
+                    ram = int(m.group(3), 16)
+                continue
+
+            m = OUTPUT_RE.match(line)
+            if m:
+                section = m.group(1)
+                pending = None
+                if m.group(3):
+                    outputs[section] = int(m.group(3), 16)
+                continue
+            if section not in RAM_SECTIONS:
+                continue
+
+            if pending is not None:
+                m = CONT_RE.match(line)
+                if m:
+                    add(modules, section, pending, int(m.group(2), 16), m.group(3))
+                pending = None
+                continue
+
+            m = INPUT_RE.match(line)
+            if not m or m.group(1).startswith("*"):
+                continue
+            if m.group(2) is None:
+                pending = m.group(1)
+            else:
+                add(modules, section, m.group(1), int(m.group(3), 16), m.group(4))
+
+    return modules, outputs, ram
+
+
+def add(modules, section, name, size, obj):
+    if size == 0 or not name.startswith((".data", ".bss", "COMMON")):
+        return
+    sizes = modules.setdefault(module(obj), [0, 0])
+    sizes[0 if section == ".data" else 1] += size
+
+
+def table(modules, outputs, ram, limit):
+    rows = sorted(modules.items(), key=lambda kv: -(kv[1][0] + kv[1][1]))
+    out = ["%-28s %7s %7s %7s" % ("module", "data", "bss", "total")]
+    for name, (data, bss) in rows[:limit] if limit else rows:
+        out.append("%-28s %7d %7d %7d" % (name, data, bss, data + bss))
+    if limit and len(rows) > limit:
+        rest = rows[limit:]
+        data, bss = sum(r[1][0] for r in rest), sum(r[1][1] for r in rest)
+        out.append("%-28s %7d %7d %7d" % ("(%d more)" % len(rest), data, bss, data + bss))
+
+    # Output sections include the padding the per-object sums miss.
+    statics = sum(outputs.get(s, 0) for s in RAM_SECTIONS)
+    out.append("%-28s %7d %7d %7d" % ("total", outputs.get(".data", 0),
+                                      outputs.get(".bss", 0), statics))
+    if ram:
+        out.append("RAM %d B: %d B static, %d B left for heap and stack"
+                   % (ram, statics, ram - statics))
+    return "\n".join(out)
+
+
+def main(argv):
+    ap = argparse.ArgumentParser(description="RAM map per module from a linker map.")
+    ap.add_argument("map")
+    ap.add_argument("-n", type=int, default=0, help="only the n largest modules")
+    args = ap.parse_args(argv)
+
+    print(table(*parse(args.map), limit=args.n))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv[1:]))
+else:
+    try:
+        Import("env")  # noqa: F821 - provided by PlatformIO/SCons
+        _map = env.subst("$BUILD_DIR/${PROGNAME}.map")  # noqa: F821
+        env.Append(LINKFLAGS=["-Wl,-Map," + _map])  # noqa: F821
+
+        def _report(target, source, env):
+            text = table(*parse(_map), limit=0)
+            with open(os.path.join(env.subst("$BUILD_DIR"), "ram_map.txt"), "w") as f:
+                f.write(text + "\n")
+            print(text)
+
+        env.AddPostAction("$PROGPATH", _report)  # noqa: F821
+    except NameError:
+        pass
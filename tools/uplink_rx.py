@@ -0,0 +1,192 @@
+#!/usr/bin/env python3
+#
+# \file uplink_rx.py
+#
+# \brief Stand-in receiver for the UDP uplink (src/uplink.cpp).
+#
+# Listens for uplink frames, checks their CRC and sequence, decodes the
+# tscodec sample blocks they carry (include/tscodec.h) and prints the
+# samples. Lost frames and lost samples (gaps in the frame and sample
+# sequence numbers) are reported as they are seen.
+#
+#   uplink_rx.py [-b 0.0.0.0] [-p 47000] [-q]
+#
+# \author blackchacal <ribeiro.tonet@gmail.com>
+# \date Oct 17, 2026
+#
+
+import argparse
+import socket
+import struct
+import sys
+
+MAGIC = b"SU"
+VERSION = 2
+HDR = struct.Struct("<2sBBI")
+BLOCK_HDR = struct.Struct("<BBIH")
+BLOCK_TYPE = 0xB1
+
+
+# --- Frames -----------------------------------------------------------------
+
+def crc16(data):
+    """CRC-16/CCITT-FALSE, as uplink_crc16."""
+    crc = 0xFFFF
+    for b in data:
+        crc ^= b << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def parse_frame(data):
+    """Returns (seq, [record bytes]) or raises ValueError."""
+    if len(data) < HDR.size + 2:
+        raise ValueError("short frame (%d bytes)" % len(data))
+    if crc16(data[:-2]) != struct.unpack_from("<H", data, len(data) - 2)[0]:
+        raise ValueError("bad crc")
+    magic, version, count, seq = HDR.unpack_from(data)
+    if magic != MAGIC or version != VERSION:
+        raise ValueError("not an uplink frame")
+
+    records = []
+    pos = HDR.size
+    end = len(data) - 2
+    for _ in range(count):
+        if pos >= end:
+            raise ValueError("truncated record")
+        n = data[pos]
+        if pos + 1 + n > end:
+            raise ValueError("truncated record")
+        records.append(data[pos + 1:pos + 1 + n])
+        pos += 1 + n
+    return seq, records
+
+
+# --- Sample blocks ----------------------------------------------------------
+
+def unzigzag(z):
+    """Zig-zag code to a difference modulo 2^32, as tsc_unzigzag."""
+    return ((z >> 1) ^ -(z & 1)) & 0xFFFFFFFF
+
+
+def s32(v):
+    v &= 0xFFFFFFFF
+    return v - (1 << 32) if v & 0x80000000 else v
+
+
+def parse_block(rec):
+    """Decodes a tscodec block: [(ts_us, seq, src, [values])]."""
+    if len(rec) < BLOCK_HDR.size:
+        raise ValueError("short block")
+    kind, count, base_ts, seq = BLOCK_HDR.unpack_from(rec)
+    if kind != BLOCK_TYPE:
+        raise ValueError("not a sample block")
+
+    pos = BLOCK_HDR.size
+
+    def varint():
+        nonlocal pos
+        value = shift = 0
+        while True:
+            if pos >= len(rec) or shift > 28:
+                raise ValueError("truncated block")
+            b = rec[pos]
+            pos += 1
+            value |= (b & 0x7F) << shift
+            if not b & 0x80:
+                return value & 0xFFFFFFFF
+            shift += 7
+
+    sources = {}
+    samples = []
+    for _ in range(count):
+        if pos >= len(rec):
+            raise ValueError("truncated block")
+        head = rec[pos]
+        pos += 1
+        src, nvals = head & 0x07, ((head >> 3) & 0x03) + 1
+        if head & 0xC0:
+            raise ValueError("bad sample head")
+        if head & 0x20:
+            seq = (seq + varint()) & 0xFFFF
+
+        code = unzigzag(varint())
+        prev = sources.get(src)
+        if prev is None:
+            ts, interval, values = (base_ts + code) & 0xFFFFFFFF, 0, [0] * 4
+        else:
+            interval = (prev[1] + code) & 0xFFFFFFFF
+            ts, values = (prev[0] + interval) & 0xFFFFFFFF, prev[2]
+        values = [s32(values[i] + unzigzag(varint())) if i < nvals else values[i]
+                  for i in range(4)]
+        sources[src] = (ts, interval, values)
+        samples.append((ts, seq, src, values[:nvals]))
+        seq = (seq + 1) & 0xFFFF
+
+    if pos != len(rec):
+        raise ValueError("trailing bytes in block")
+    return samples
+
+
+# --- Receiver ---------------------------------------------------------------
+
+def receive(sock, out, quiet):
+    frame_next = None
+    sample_next = None
+    frames = samples = lost_frames = lost_samples = bad = 0
+
+    try:
+        while True:
+            data, peer = sock.recvfrom(65535)
+            try:
+                seq, records = parse_frame(data)
+            except ValueError as e:
+                bad += 1
+                out.write("%s: %s\n" % (peer[0], e))
+                continue
+
+            if frame_next is not None and seq != frame_next:
+                lost_frames += (seq - frame_next) & 0xFFFFFFFF
+                out.write("frame %u: %u frames lost\n" % (seq, (seq - frame_next) & 0xFFFFFFFF))
+            frame_next = (seq + 1) & 0xFFFFFFFF
+            frames += 1
+
+            for rec in records:
+                try:
+                    block = parse_block(rec)
+                except ValueError as e:
+                    out.write("frame %u: %s: %s\n" % (seq, e, rec.hex()))
+                    continue
+                for ts, sseq, src, values in block:
+                    if sample_next is not None and sseq != sample_next:
+                        lost_samples += (sseq - sample_next) & 0xFFFF
+                    sample_next = (sseq + 1) & 0xFFFF
+                    samples += 1
+                    if not quiet:
+                        out.write("%10.6f src %u seq %5u %s\n"
+                                  % (ts / 1e6, src, sseq, " ".join(str(v) for v in values)))
+            out.flush()
+    except KeyboardInterrupt:
+        pass
+
+    out.write("frames %d samples %d lost frames %d lost samples %d bad %d\n"
+              % (frames, samples, lost_frames, lost_samples, bad))
+
+
+def main(argv):
+    ap = argparse.ArgumentParser(description="Stand-in receiver for the Suricata UDP uplink.")
+    ap.add_argument("-b", "--bind", default="0.0.0.0", help="address to listen on")
+    ap.add_argument("-p", "--port", type=int, default=47000, help="UDP port (UPLINK_PORT)")
+    ap.add_argument("-q", "--quiet", action="store_true", help="only report losses and totals")
+    args = ap.parse_args(argv)
+
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    sock.bind((args.bind, args.port))
+    receive(sock, sys.stdout, args.quiet)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv[1:]))